@@ -4,68 +4,150 @@
 #include "Box.h"
 #include <memory>
 #include <algorithm>
+#include <thread>
+#include "ParallelFor.h"
 #include "ChiliMath.h"
 
-
-App::App()
-	:
-	wnd(800, 600, "The Donkey Fart Box")
+class App::Factory
 {
-	class Factory
+public:
+	Factory(Graphics& gfx, std::pmr::memory_resource* pMem, std::seed_seq& seeds)
+		:
+		gfx(gfx),
+		pMem(pMem),
+		rng(seeds)
 	{
-	public:
-		Factory(Graphics& gfx)
-			:
-			gfx(gfx)
+	}
+	ArenaPtr<Drawable> operator()()
+	{
+		switch (typedist(rng))
 		{
+		case 0:
+			return MakeArena<Pyramid>(
+				pMem, gfx, pMem, rng, adist, ddist,
+				odist, rdist
+			);
+		case 1:
+			return MakeArena<Box>(
+				pMem, gfx, pMem, rng, adist, ddist,
+				odist, rdist, bdist
+			);
+		case 2:
+			return MakeArena<Melon>(
+				pMem, gfx, pMem, rng, adist, ddist,
+				odist, rdist, longdist, latdist
+			);
+		default:
+			assert(false && "bad drawable type in factory");
+			return {};
 		}
-		std::unique_ptr<Drawable> operator()()
+	}
+	std::mt19937& Rng() noexcept
+	{
+		return rng;
+	}
+private:
+	Graphics& gfx;
+	std::pmr::memory_resource* pMem;
+	std::mt19937 rng;
+	std::uniform_real_distribution<float> adist{ 0.0f,PI * 2.0f };
+	std::uniform_real_distribution<float> ddist{ 0.0f,PI * 0.5f };
+	std::uniform_real_distribution<float> odist{ 0.0f,PI * 0.08f };
+	std::uniform_real_distribution<float> rdist{ 6.0f,20.0f };
+	std::uniform_real_distribution<float> bdist{ 0.4f,3.0f };
+	std::uniform_int_distribution<int> latdist{ 5,20 };
+	std::uniform_int_distribution<int> longdist{ 10,40 };
+	std::uniform_int_distribution<int> typedist{ 0,2 };
+};
+
+App::App(size_t drawableBudget, float churnRate)
+	:
+	wnd(800, 600, "The Donkey Fart Box"),
+	drawables(drawableBudget),
+	drawableBudget(drawableBudget),
+	churnRate(churnRate)
+{
+	// build the scene on all cores: every worker has its own rng stream and
+	// fills its own slice of the drawables (device resource creation is free-threaded)
+	auto& gfx = wnd.Gfx();
+	const unsigned int baseSeed = std::random_device{}();
+	const size_t nWorkers = std::clamp<size_t>(std::thread::hardware_concurrency(), 1u, std::max<size_t>(drawableBudget, 1u));
+	std::vector<ArenaPtr<Drawable>> built(drawableBudget);
+	ParallelFor(nWorkers, 1u, [&gfx, this, baseSeed, nWorkers, &built](size_t firstSlice, size_t lastSlice)
+	{
+		for (size_t i = firstSlice; i < lastSlice; i++)
 		{
-			switch (typedist(rng))
-			{
-			case 0:
-				return std::make_unique<Pyramid>(
-					gfx, rng, adist, ddist,
-					odist, rdist
-				);
-			case 1:
-				return std::make_unique<Box>(
-					gfx, rng, adist, ddist,
-					odist, rdist, bdist
-				);
-			case 2:
-				return std::make_unique<Melon>(
-					gfx, rng, adist, ddist,
-					odist, rdist, longdist, latdist
-				);
-			default:
-				assert(false && "bad drawable type in factory");
-				return {};
-			}
+			std::seed_seq seeds{ baseSeed,(unsigned int)i };
+			std::generate(built.begin() + built.size() * i / nWorkers, built.begin() + built.size() * (i + 1) / nWorkers,
+				Factory{ gfx,&drawablePool,seeds });
 		}
-	private:
-		Graphics& gfx;
-		std::mt19937 rng{ std::random_device{}() };
-		std::uniform_real_distribution<float> adist{ 0.0f,PI * 2.0f };
-		std::uniform_real_distribution<float> ddist{ 0.0f,PI * 0.5f };
-		std::uniform_real_distribution<float> odist{ 0.0f,PI * 0.08f };
-		std::uniform_real_distribution<float> rdist{ 6.0f,20.0f };
-		std::uniform_real_distribution<float> bdist{ 0.4f,3.0f };
-		std::uniform_int_distribution<int> latdist{ 5,20 };
-		std::uniform_int_distribution<int> longdist{ 10,40 };
-		std::uniform_int_distribution<int> typedist{ 0,2 };
-	};
+	});
+	for (auto& d : built)
+	{
+		drawables.Insert(std::move(d));
+	}
 
-	Factory f(wnd.Gfx());
-	drawables.reserve(nDrawables);
-	std::generate_n(std::back_inserter(drawables), nDrawables, f);
+	// runtime spawns draw from a stream of their own, disjoint from the workers'
+	std::seed_seq spawnSeeds{ baseSeed,(unsigned int)nWorkers };
+	pSpawner = std::make_unique<Factory>(gfx, &drawablePool, spawnSeeds);
 
 	wnd.Gfx().SetProjection(DirectX::XMMatrixPerspectiveLH(1.0f, 3.0f / 4.0f, 0.5f, 40.0f));
 }
 
+App::DrawableHandle App::Spawn()
+{
+	if (drawables.Size() >= drawableBudget)
+	{
+		return {};
+	}
+	return drawables.Insert((*pSpawner)());
+}
+
+bool App::Despawn(DrawableHandle h)
+{
+	return drawables.Remove(h);
+}
+
+void App::SetDrawableBudget(size_t budget)
+{
+	drawableBudget = budget;
+	drawables.Reserve(budget);
+	while (drawables.Size() > drawableBudget)
+	{
+		drawables.Remove(drawables.HandleAt(drawables.Size() - 1u));
+	}
+}
+
+size_t App::GetDrawableBudget() const noexcept
+{
+	return drawableBudget;
+}
+
+void App::SetChurnRate(float rate) noexcept
+{
+	churnRate = rate;
+}
+
+void App::Churn(float dt)
+{
+	churnDebt += churnRate * dt;
+	if (drawables.Empty())
+	{
+		churnDebt = 0.0f;
+		return;
+	}
+	for (; churnDebt >= 1.0f; churnDebt -= 1.0f)
+	{
+		std::uniform_int_distribution<size_t> victimDist{ 0u,drawables.Size() - 1u };
+		drawables.Remove(drawables.HandleAt(victimDist(pSpawner->Rng())));
+		Spawn();
+	}
+}
+
 void App::DoFrame()
 {
 	const auto dt = timer.Mark();
+	Churn(dt);
 	wnd.Gfx().ClearBuffer(0.07f, 0.0f, 0.12f);
 	for (auto& d : drawables)
 	{
@@ -1,19 +1,44 @@
 #pragma once
 #include "Window.h"
 #include "ChiliTimer.h"
+#include "MemoryArena.h"
+#include "ArenaPtr.h"
+#include "SlotMap.h"
+#include <memory_resource>
 
 class App
 {
+	class Factory;
 public:
-	App();
+	using DrawableHandle = SlotMap<ArenaPtr<class Drawable>>::Handle;
+public:
+	App(size_t drawableBudget = 180u, float churnRate = 0.0f);
 	// master frame / message loop
 	int Go();
 	~App();
+	// runtime scene control
+	// Spawn returns a null handle when the budget is exhausted
+	DrawableHandle Spawn();
+	bool Despawn(DrawableHandle h);
+	// lowering the budget despawns the excess objects
+	void SetDrawableBudget(size_t budget);
+	size_t GetDrawableBudget() const noexcept;
+	// objects replaced per second (despawn + spawn), for stress testing
+	void SetChurnRate(float rate) noexcept;
 private:
 	void DoFrame();
+	void Churn(float dt);
 private:
 	Window wnd;
 	ChiliTimer timer;
-	std::vector<std::unique_ptr<class Drawable>> drawables;
-	static constexpr size_t nDrawables = 180;
+	// large upstream blocks for the scene; drawables and their bindables are pooled
+	// by size on top of it so same-type objects sit next to each other in memory
+	// (pool is synchronized because the scene is constructed on several threads)
+	MemoryArena sceneArena;
+	std::pmr::synchronized_pool_resource drawablePool{ &sceneArena };
+	SlotMap<ArenaPtr<class Drawable>> drawables;
+	std::unique_ptr<Factory> pSpawner;
+	size_t drawableBudget;
+	float churnRate;
+	float churnDebt = 0.0f;
 };
\ No newline at end of file
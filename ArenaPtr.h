@@ -0,0 +1,66 @@
+#pragma once
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+// deleter for objects placement-constructed in a std::pmr::memory_resource
+// remembers the size/alignment of the most-derived type so that an ArenaPtr<Derived>
+// can be converted to ArenaPtr<Base> and still be returned to the right pool
+class ArenaDeleter
+{
+public:
+	ArenaDeleter() = default;
+	ArenaDeleter(std::pmr::memory_resource* pResource, size_t size, size_t alignment) noexcept
+		:
+		pResource(pResource),
+		size(size),
+		alignment(alignment)
+	{
+	}
+	template<class T>
+	void operator()(T* p) const noexcept
+	{
+		void* pBlock;
+		if constexpr (std::is_polymorphic_v<T>)
+		{
+			pBlock = dynamic_cast<void*>(p);
+		}
+		else
+		{
+			pBlock = p;
+		}
+		p->~T();
+		pResource->deallocate(pBlock, size, alignment);
+	}
+	std::pmr::memory_resource* GetResource() const noexcept
+	{
+		return pResource;
+	}
+private:
+	std::pmr::memory_resource* pResource = nullptr;
+	size_t size = 0u;
+	size_t alignment = 0u;
+};
+
+template<class T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+// arena counterpart to std::make_unique
+template<class T, class... Args>
+ArenaPtr<T> MakeArena(std::pmr::memory_resource* pResource, Args&&... args)
+{
+	void* const pBlock = pResource->allocate(sizeof(T), alignof(T));
+	try
+	{
+		return ArenaPtr<T>(
+			new(pBlock) T(std::forward<Args>(args)...),
+			ArenaDeleter(pResource, sizeof(T), alignof(T))
+		);
+	}
+	catch (...)
+	{
+		pResource->deallocate(pBlock, sizeof(T), alignof(T));
+		throw;
+	}
+}
\ No newline at end of file
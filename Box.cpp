@@ -5,6 +5,7 @@
 
 
 Box::Box(Graphics& gfx,
+	std::pmr::memory_resource* pMem,
 	std::mt19937& rng,
 	std::uniform_real_distribution<float>& adist,
 	std::uniform_real_distribution<float>& ddist,
@@ -12,6 +13,7 @@ Box::Box(Graphics& gfx,
 	std::uniform_real_distribution<float>& rdist,
 	std::uniform_real_distribution<float>& bdist)
 	:
+	DrawableBase(pMem),
 	r(rdist(rng)),
 	droll(ddist(rng)),
 	dpitch(ddist(rng)),
@@ -25,7 +27,7 @@ Box::Box(Graphics& gfx,
 {
 	namespace dx = DirectX;
 
-	if (!IsStaticInitialized())
+	InitializeStatic([&gfx]
 	{
 		struct Vertex
 		{
@@ -33,15 +35,15 @@ Box::Box(Graphics& gfx,
 		};
 		const auto model = Cube::Make<Vertex>();
 
-		AddStaticBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
+		AddStaticBind(MakeStaticBind<VertexBuffer>(gfx, model.GetVertices()));
 
-		auto pvs = std::make_unique<VertexShader>(gfx, L"ColorIndexVS.cso");
+		auto pvs = MakeStaticBind<VertexShader>(gfx, L"ColorIndexVS.cso");
 		auto pvsbc = pvs->GetBytecode();
 		AddStaticBind(std::move(pvs));
 
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"ColorIndexPS.cso"));
+		AddStaticBind(MakeStaticBind<PixelShader>(gfx, L"ColorIndexPS.cso"));
 
-		AddStaticIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
+		AddStaticIndexBuffer(MakeStaticBind<IndexBuffer>(gfx, model.indices));
 
 		struct PixelShaderConstants
 		{
@@ -66,22 +68,19 @@ Box::Box(Graphics& gfx,
 				{ 0.0f,0.0f,0.0f },
 			}
 		};
-		AddStaticBind(std::make_unique<PixelConstantBuffer<PixelShaderConstants>>(gfx, cb2));
+		AddStaticBind(MakeStaticBind<PixelConstantBuffer<PixelShaderConstants>>(gfx, cb2));
 
 		const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
 		{
 			{ "Position",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 },
 		};
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
+		AddStaticBind(MakeStaticBind<InputLayout>(gfx, ied, pvsbc));
 
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
-	}
-	else
-	{
-		SetIndexFromStatic();
-	}
+		AddStaticBind(MakeStaticBind<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+	});
+	SetIndexFromStatic();
 
-	AddBind(std::make_unique<TransformCbuf>(gfx, *this));
+	AddBind(MakeBind<TransformCbuf>(gfx, *this));
 
 	// model deformation transform (per instance, not stored as bind)
 	dx::XMStoreFloat3x3(
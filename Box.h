@@ -4,7 +4,8 @@
 class Box : public DrawableBase<Box>
 {
 public:
-	Box(Graphics& gfx, std::mt19937& rng,
+	Box(Graphics& gfx, std::pmr::memory_resource* pMem,
+		std::mt19937& rng,
 		std::uniform_real_distribution<float>& adist,
 		std::uniform_real_distribution<float>& ddist,
 		std::uniform_real_distribution<float>& odist,
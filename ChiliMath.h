@@ -1,5 +1,6 @@
 #pragma once
 #include <math.h>
+#include <type_traits>
 
 constexpr float PI = 3.14159265f;
 constexpr double PI_D = 3.1415926535897932;
@@ -8,6 +9,43 @@ constexpr auto sq(const T& x)
 {
 	return x * x;
 }
+// sin and cos that also work in constant expressions, for geometry baked at compile time;
+// at runtime they are the libm functions
+constexpr double constexpr_sin(double x)
+{
+	if (std::is_constant_evaluated())
+	{
+		// reduce to [-pi,pi] then sum the taylor series until it stops changing
+		const double turns = x / (2.0 * PI_D);
+		x -= 2.0 * PI_D * (double)(long long)(turns >= 0.0 ? turns + 0.5 : turns - 0.5);
+		double term = x;
+		double sum = x;
+		for (int n = 1; n < 32 && sum + term != sum; n++)
+		{
+			term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+			sum += term;
+		}
+		return sum;
+	}
+	return sin(x);
+}
+constexpr double constexpr_cos(double x)
+{
+	if (std::is_constant_evaluated())
+	{
+		const double turns = x / (2.0 * PI_D);
+		x -= 2.0 * PI_D * (double)(long long)(turns >= 0.0 ? turns + 0.5 : turns - 0.5);
+		double term = 1.0;
+		double sum = 1.0;
+		for (int n = 1; n < 32 && sum + term != sum; n++)
+		{
+			term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+			sum += term;
+		}
+		return sum;
+	}
+	return cos(x);
+}
 template<typename T>
 T wrap_angle(T theta)
 {
@@ -1,57 +1,64 @@
 #pragma once
 #include "IndexedTriangleList.h"
+#include "RevolvedSurface.h"
 #include <DirectXMath.h>
 #include "ChiliMath.h"
+#include <span>
+#include <cassert>
 class Cone
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselated(int longDiv)
+	// base ring plus base center and tip
+	static constexpr size_t VertexCount(int longDiv) noexcept
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3);
-		const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const float longitudeAngle = 2.0f * PI / longDiv;
+		return size_t(longDiv) + 2u;
+	}
+	// base fan plus side fan
+	static constexpr size_t IndexCount(int longDiv) noexcept
+	{
+		return size_t(longDiv) * 6u;
+	}
+	// fills positions (V::pos, or V itself for XMFLOAT3) and indices; constexpr so fixed
+	// tessellations can be baked by MakeTable
+	template<class V, class I>
+	static constexpr void Generate(int longDiv, std::span<V> vertices, std::span<I> indices)
+	{
+		assert(vertices.size() == VertexCount(longDiv));
+		assert(indices.size() == IndexCount(longDiv));
+		RevolvedSurface<V, I> surface(longDiv, 0.0, vertices, indices);
 		// base vertices
-		std::vector<V> vertices;
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			vertices.emplace_back();
-			auto v = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationZ(longitudeAngle * iLong)
-			);
-			dx::XMStoreFloat3(&vertices.back().pos, v);
-		}
+		const auto iBase = surface.Ring(1.0, -1.0);
 		// the center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		const auto iCenter = (unsigned short)(vertices.size() - 1);
+		const auto iCenter = surface.AxisPoint(-1.0);
 		// the tip :darkness:
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		const auto iTip = (unsigned short)(vertices.size() - 1);
-
-		// base indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(iCenter);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iLong);
-		}
-		// cone indices
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			indices.push_back(iLong);
-			indices.push_back((iLong + 1) % longDiv);
-			indices.push_back(iTip);
-		}
+		const auto iTip = surface.AxisPoint(1.0);
+		surface.FanDown(iCenter, iBase);
+		surface.FanUp(iTip, iBase);
+		assert(surface.Filled());
+	}
+	template<int longDiv, class I = unsigned int>
+	static constexpr auto MakeTable()
+	{
+		static_assert(VertexCount(longDiv) <= size_t(std::numeric_limits<I>::max()) + 1u,
+			"Cone table has more vertices than its index type can address");
+		TriangleTable<VertexCount(longDiv), IndexCount(longDiv), I> table = {};
+		Generate<DirectX::XMFLOAT3, I>(longDiv, table.positions, table.indices);
+		return table;
+	}
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> MakeTesselated(int longDiv, std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		const size_t nVertices = VertexCount(longDiv);
+		IndexedTriangleList<V, I>::CheckIndexRange(nVertices);
+		std::pmr::vector<V> vertices(nVertices, pMem);
+		std::pmr::vector<I> indices(IndexCount(longDiv), pMem);
+		Generate<V, I>(longDiv, vertices, indices);
 		return { std::move(vertices),std::move(indices) };
 	}
-	template<class V>
-	static IndexedTriangleList<V> Make()
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Make(std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
 	{
-		return MakeTesselated<V>(24);
+		static constexpr auto table = MakeTable<24, I>();
+		return IndexedTriangleList<V, I>::FromTable(table, pMem);
 	}
 };
\ No newline at end of file
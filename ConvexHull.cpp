@@ -0,0 +1,582 @@
+#include "ConvexHull.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <cassert>
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+	constexpr size_t minChunkPoints = 16384u;
+
+	struct Vec3d
+	{
+		double x;
+		double y;
+		double z;
+		Vec3d operator+(const Vec3d& rhs) const noexcept { return { x + rhs.x,y + rhs.y,z + rhs.z }; }
+		Vec3d operator-(const Vec3d& rhs) const noexcept { return { x - rhs.x,y - rhs.y,z - rhs.z }; }
+		Vec3d operator*(double s) const noexcept { return { x * s,y * s,z * s }; }
+	};
+
+	double Dot(const Vec3d& a, const Vec3d& b) noexcept
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	Vec3d Cross(const Vec3d& a, const Vec3d& b) noexcept
+	{
+		return { a.y * b.z - a.z * b.y,a.z * b.x - a.x * b.z,a.x * b.y - a.y * b.x };
+	}
+
+	// index of the point maximizing score, over all points in parallel
+	template<class F>
+	uint32_t ArgMax(size_t count, F&& score)
+	{
+		const size_t nChunks = std::clamp<size_t>(count / minChunkPoints, 1u,
+			std::max<size_t>(std::thread::hardware_concurrency(), 1u));
+		std::vector<std::pair<double, uint32_t>> best(nChunks, { -std::numeric_limits<double>::infinity(),0u });
+		ParallelFor(nChunks, 1u, [&](size_t firstChunk, size_t lastChunk)
+		{
+			for (size_t c = firstChunk; c < lastChunk; c++)
+			{
+				for (size_t i = count * c / nChunks; i < count * (c + 1u) / nChunks; i++)
+				{
+					const double s = score(i);
+					if (s > best[c].first)
+					{
+						best[c] = { s,(uint32_t)i };
+					}
+				}
+			}
+		});
+		return std::max_element(best.begin(), best.end(),
+			[](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; })->second;
+	}
+
+	// neighbour[i] is the face across the edge v[i] -> v[(i + 1) % 3]
+	// outside points form a list through Quickhull::next, each face's is only filled in when
+	// the face is made, so its farthest point stays valid for as long as the face lives
+	struct Face
+	{
+		uint32_t v[3];
+		uint32_t neighbour[3];
+		Vec3d normal;
+		double offset;
+		uint32_t firstOutside;
+		uint32_t farthest;
+		double farthestDistance;
+		uint32_t generation = 0u;
+		uint32_t visited = 0u;
+		bool alive;
+		double Distance(const Vec3d& p) const noexcept
+		{
+			return Dot(normal, p) - offset;
+		}
+	};
+
+	class Quickhull
+	{
+		struct HorizonEdge
+		{
+			uint32_t a;
+			uint32_t b;
+			uint32_t outer;
+		};
+	public:
+		Quickhull(std::vector<Vec3d> points_in, double epsilon)
+			:
+			points(std::move(points_in)),
+			next(points.size(), none),
+			epsilon(epsilon)
+		{
+		}
+		// corners of a tetrahedron with nonzero volume
+		void Build(const uint32_t (&simplex)[4], size_t maxVertices)
+		{
+			const auto centroid = (points[simplex[0]] + points[simplex[1]] + points[simplex[2]] + points[simplex[3]]) * 0.25;
+			const uint32_t corners[4][3] = {
+				{ simplex[0],simplex[1],simplex[2] },{ simplex[0],simplex[1],simplex[3] },
+				{ simplex[0],simplex[2],simplex[3] },{ simplex[1],simplex[2],simplex[3] },
+			};
+			for (const auto& c : corners)
+			{
+				// facing away from the centroid
+				const auto n = Cross(points[c[1]] - points[c[0]], points[c[2]] - points[c[0]]);
+				if (Dot(n, centroid - points[c[0]]) > 0.0)
+				{
+					NewFace(c[0], c[2], c[1]);
+				}
+				else
+				{
+					NewFace(c[0], c[1], c[2]);
+				}
+			}
+			// with only four faces, matching the edges up by brute force is fine
+			for (uint32_t f = 0; f < faces.size(); f++)
+			{
+				if (!faces[f].alive)
+				{
+					continue;
+				}
+				for (size_t i = 0; i < 3u; i++)
+				{
+					faces[f].neighbour[i] = FindFaceWithEdge(faces[f].v[(i + 1u) % 3u], faces[f].v[i]);
+				}
+			}
+
+			// each point goes outside the face it is farthest above, points inside are dropped
+			std::vector<uint32_t> faceOf(points.size(), none);
+			std::vector<uint32_t> initialFaces;
+			for (uint32_t f = 0; f < faces.size(); f++)
+			{
+				if (faces[f].alive)
+				{
+					initialFaces.push_back(f);
+				}
+			}
+			ParallelFor(points.size(), minChunkPoints, [&](size_t first, size_t last)
+			{
+				for (size_t p = first; p < last; p++)
+				{
+					double best = epsilon;
+					for (const auto f : initialFaces)
+					{
+						const double d = faces[f].Distance(points[p]);
+						if (d > best)
+						{
+							best = d;
+							faceOf[p] = f;
+						}
+					}
+				}
+			});
+			for (const auto p : simplex)
+			{
+				faceOf[p] = none;
+			}
+			for (uint32_t p = 0; p < points.size(); p++)
+			{
+				if (faceOf[p] != none)
+				{
+					AddOutside(faceOf[p], p, faces[faceOf[p]].Distance(points[p]));
+				}
+			}
+			// set before the first QueueFace so the initial faces are heap-ordered too
+			farthestFirst = maxVertices != 0u;
+			for (const auto f : initialFaces)
+			{
+				QueueFace(f);
+			}
+
+			size_t nVertices = 4u;
+			while (!queue.empty() && (maxVertices == 0u || nVertices < maxVertices))
+			{
+				if (farthestFirst)
+				{
+					std::pop_heap(queue.begin(), queue.end());
+				}
+				const auto [distance, key] = queue.back();
+				queue.pop_back();
+				const uint32_t f = uint32_t(key);
+				if (!faces[f].alive || faces[f].generation != uint32_t(key >> 32))
+				{
+					continue;
+				}
+				if (AddPoint(f))
+				{
+					nVertices++;
+				}
+			}
+		}
+		HullTopology Extract() const
+		{
+			HullTopology hull;
+			std::vector<uint32_t> remap(points.size(), none);
+			for (const auto& f : faces)
+			{
+				if (!f.alive)
+				{
+					continue;
+				}
+				for (const auto v : f.v)
+				{
+					if (remap[v] == none)
+					{
+						remap[v] = (uint32_t)hull.points.size();
+						hull.points.push_back(v);
+					}
+					hull.indices.push_back(remap[v]);
+				}
+			}
+			return hull;
+		}
+	private:
+		uint32_t NewFace(uint32_t a, uint32_t b, uint32_t c)
+		{
+			uint32_t f;
+			if (freeFaces.empty())
+			{
+				f = (uint32_t)faces.size();
+				faces.emplace_back();
+			}
+			else
+			{
+				f = freeFaces.back();
+				freeFaces.pop_back();
+			}
+			auto& face = faces[f];
+			const uint32_t faceGeneration = face.generation + 1u;
+			face = {};
+			face.v[0] = a;
+			face.v[1] = b;
+			face.v[2] = c;
+			const auto n = Cross(points[b] - points[a], points[c] - points[a]);
+			face.normal = n * (1.0 / std::sqrt(Dot(n, n)));
+			// offset from the centroid rather than one corner, so all three sit equally on the plane
+			face.offset = Dot(face.normal, (points[a] + points[b] + points[c]) * (1.0 / 3.0));
+			face.firstOutside = none;
+			face.farthest = none;
+			face.farthestDistance = 0.0;
+			face.generation = faceGeneration;
+			face.alive = true;
+			return f;
+		}
+		uint32_t FindFaceWithEdge(uint32_t a, uint32_t b) const noexcept
+		{
+			for (uint32_t f = 0; f < faces.size(); f++)
+			{
+				for (size_t i = 0; faces[f].alive && i < 3u; i++)
+				{
+					if (faces[f].v[i] == a && faces[f].v[(i + 1u) % 3u] == b)
+					{
+						return f;
+					}
+				}
+			}
+			assert("initial hull must be closed" && false);
+			return none;
+		}
+		void AddOutside(uint32_t f, uint32_t p, double distance) noexcept
+		{
+			next[p] = faces[f].firstOutside;
+			faces[f].firstOutside = p;
+			if (distance > faces[f].farthestDistance)
+			{
+				faces[f].farthestDistance = distance;
+				faces[f].farthest = p;
+			}
+		}
+		void QueueFace(uint32_t f)
+		{
+			if (faces[f].farthest != none)
+			{
+				queue.emplace_back(faces[f].farthestDistance, (uint64_t(faces[f].generation) << 32) | f);
+				if (farthestFirst)
+				{
+					std::push_heap(queue.begin(), queue.end());
+				}
+			}
+		}
+		// false when the point was dropped instead of added
+		bool AddPoint(uint32_t start)
+		{
+			const uint32_t eye = faces[start].farthest;
+			const auto& eyePoint = points[eye];
+
+			// faces the eye sees, flooded out from the one it is outside of; edges to faces it
+			// doesn't see make the horizon
+			visitStamp++;
+			visible.clear();
+			horizon.clear();
+			faces[start].visited = visitStamp;
+			visible.push_back(start);
+			for (size_t i = 0; i < visible.size(); i++)
+			{
+				const auto& face = faces[visible[i]];
+				for (size_t e = 0; e < 3u; e++)
+				{
+					const uint32_t n = face.neighbour[e];
+					if (faces[n].visited == visitStamp)
+					{
+						continue;
+					}
+					if (faces[n].Distance(eyePoint) > epsilon)
+					{
+						faces[n].visited = visitStamp;
+						visible.push_back(n);
+					}
+					else
+					{
+						horizon.push_back({ face.v[e],face.v[(e + 1u) % 3u],n });
+					}
+				}
+			}
+
+			// chain the horizon into a loop. rounding can make the visible region something
+			// other than a disc (the horizon then repeats a vertex or falls apart into several
+			// loops); the eye is within tolerance of the hull in that case, so it is dropped
+			std::sort(horizon.begin(), horizon.end(), [](const HorizonEdge& lhs, const HorizonEdge& rhs) { return lhs.a < rhs.a; });
+			bool simple = true;
+			for (size_t i = 1; i < horizon.size() && simple; i++)
+			{
+				simple = horizon[i].a != horizon[i - 1u].a;
+			}
+			loop.clear();
+			if (simple)
+			{
+				size_t e = 0u;
+				do
+				{
+					loop.push_back(horizon[e]);
+					const auto it = std::lower_bound(horizon.begin(), horizon.end(), horizon[e].b,
+						[](const HorizonEdge& edge, uint32_t a) { return edge.a < a; });
+					if (it == horizon.end() || it->a != horizon[e].b)
+					{
+						simple = false;
+						break;
+					}
+					e = size_t(it - horizon.begin());
+				}
+				while (e != 0u && loop.size() <= horizon.size());
+				simple = simple && e == 0u && loop.size() == horizon.size();
+			}
+			if (!simple)
+			{
+				DropPoint(start, eye);
+				return false;
+			}
+
+			// fan of new faces from the horizon to the eye, each keeping the winding of the
+			// visible face it replaces along the horizon edge
+			newFaces.clear();
+			for (const auto& edge : loop)
+			{
+				newFaces.push_back(NewFace(edge.a, edge.b, eye));
+			}
+			const size_t nNew = newFaces.size();
+			for (size_t k = 0; k < nNew; k++)
+			{
+				auto& face = faces[newFaces[k]];
+				const auto& edge = loop[k];
+				face.neighbour[0] = edge.outer;
+				face.neighbour[1] = newFaces[(k + 1u) % nNew];
+				face.neighbour[2] = newFaces[(k + nNew - 1u) % nNew];
+				auto& outer = faces[edge.outer];
+				for (size_t i = 0; i < 3u; i++)
+				{
+					if (outer.v[i] == edge.b && outer.v[(i + 1u) % 3u] == edge.a)
+					{
+						outer.neighbour[i] = newFaces[k];
+					}
+				}
+			}
+
+			// points outside the faces going away move to whichever new face they are farthest
+			// above, or are dropped if they are now inside
+			for (const auto f : visible)
+			{
+				for (uint32_t p = faces[f].firstOutside; p != none;)
+				{
+					const uint32_t following = next[p];
+					if (p != eye)
+					{
+						double best = epsilon;
+						uint32_t bestFace = none;
+						for (const auto n : newFaces)
+						{
+							const double d = faces[n].Distance(points[p]);
+							if (d > best)
+							{
+								best = d;
+								bestFace = n;
+							}
+						}
+						if (bestFace != none)
+						{
+							AddOutside(bestFace, p, best);
+						}
+					}
+					p = following;
+				}
+				faces[f].alive = false;
+				freeFaces.push_back(f);
+			}
+			for (const auto n : newFaces)
+			{
+				QueueFace(n);
+			}
+			return true;
+		}
+		void DropPoint(uint32_t f, uint32_t p)
+		{
+			auto& face = faces[f];
+			face.farthest = none;
+			face.farthestDistance = 0.0;
+			uint32_t list = face.firstOutside;
+			face.firstOutside = none;
+			while (list != none)
+			{
+				const uint32_t following = next[list];
+				if (list != p)
+				{
+					AddOutside(f, list, face.Distance(points[list]));
+				}
+				list = following;
+			}
+			// the face keeps its generation, so its stale queue entry has already been popped
+			// and this is now the only one
+			QueueFace(f);
+		}
+	private:
+		std::vector<Vec3d> points;
+		std::vector<uint32_t> next;
+		double epsilon;
+		std::vector<Face> faces;
+		std::vector<uint32_t> freeFaces;
+		uint32_t visitStamp = 0u;
+		// faces with points outside them. a stack when the whole hull is built: the newest faces
+		// and their points are still in cache. a max-heap on distance when the hull is cut
+		// short, so the vertices it gets to are the ones that matter most
+		std::vector<std::pair<double, uint64_t>> queue;
+		bool farthestFirst = false;
+		// scratch reused by every AddPoint
+		std::vector<uint32_t> visible;
+		std::vector<HorizonEdge> horizon;
+		std::vector<HorizonEdge> loop;
+		std::vector<uint32_t> newFaces;
+	};
+
+	// all points within tolerance of the plane through p0 with the given unit normal: 2d hull by
+	// monotone chain in the plane, triangulated as a fan on both sides
+	HullTopology FlatHull(const std::vector<Vec3d>& points, const Vec3d& p0, const Vec3d& uAxis, const Vec3d& normal)
+	{
+		const auto vAxis = Cross(normal, uAxis);
+		struct Planar
+		{
+			double u;
+			double v;
+			uint32_t point;
+		};
+		std::vector<Planar> planar(points.size());
+		for (uint32_t i = 0; i < points.size(); i++)
+		{
+			const auto d = points[i] - p0;
+			planar[i] = { Dot(d, uAxis),Dot(d, vAxis),i };
+		}
+		std::sort(planar.begin(), planar.end(), [](const Planar& lhs, const Planar& rhs)
+		{
+			return lhs.u < rhs.u || (lhs.u == rhs.u && lhs.v < rhs.v);
+		});
+		const auto turn = [](const Planar& o, const Planar& a, const Planar& b)
+		{
+			return (a.u - o.u) * (b.v - o.v) - (a.v - o.v) * (b.u - o.u);
+		};
+		// lower chain left to right, then upper chain right to left, counterclockwise in (u,v)
+		std::vector<Planar> chain(2u * planar.size());
+		size_t k = 0u;
+		for (size_t i = 0; i < planar.size(); i++)
+		{
+			while (k >= 2u && turn(chain[k - 2u], chain[k - 1u], planar[i]) <= 0.0)
+			{
+				k--;
+			}
+			chain[k++] = planar[i];
+		}
+		for (size_t i = planar.size() - 1u, lowerSize = k + 1u; i > 0u; i--)
+		{
+			while (k >= lowerSize && turn(chain[k - 2u], chain[k - 1u], planar[i - 1u]) <= 0.0)
+			{
+				k--;
+			}
+			chain[k++] = planar[i - 1u];
+		}
+		HullTopology hull;
+		// the last point repeats the first
+		for (size_t i = 0; i + 1u < k; i++)
+		{
+			hull.points.push_back(chain[i].point);
+		}
+		for (uint32_t i = 1; i + 1u < hull.points.size(); i++)
+		{
+			hull.indices.insert(hull.indices.end(), { 0u,i,i + 1u,0u,i + 1u,i });
+		}
+		return hull;
+	}
+}
+
+HullTopology ConvexHull::Build(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count, size_t maxVertices)
+{
+	assert("point index must fit 32 bits" && count < size_t(none));
+	if (count < 3u)
+	{
+		return {};
+	}
+	std::vector<Vec3d> points(count);
+	Vec3d extent = { 0.0,0.0,0.0 };
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto& p = *reinterpret_cast<const dx::XMFLOAT3*>(reinterpret_cast<const char*>(pPositions) + i * stride);
+		points[i] = { p.x,p.y,p.z };
+		extent = { std::max(extent.x,std::abs(points[i].x)),std::max(extent.y,std::abs(points[i].y)),std::max(extent.z,std::abs(points[i].z)) };
+	}
+	// round-off of the double precision plane distances. faces aren't merged, so a looser
+	// tolerance (say the float precision of the input) would let fans of nearly coplanar
+	// slivers fold in by far more than the tolerance itself
+	const double epsilon = 3.0 * (extent.x + extent.y + extent.z) * std::numeric_limits<double>::epsilon();
+	// whether the input is flat (or worse) is judged at the precision it came in
+	const double flatTolerance = 3.0 * (extent.x + extent.y + extent.z) * double(std::numeric_limits<float>::epsilon());
+
+	// the most distant pair of axis extremes, the point farthest from the line through them,
+	// then the one farthest from the plane through all three
+	uint32_t extremes[6];
+	for (size_t axis = 0; axis < 3u; axis++)
+	{
+		const auto coordinate = [&](size_t i) { return (&points[i].x)[axis]; };
+		extremes[axis * 2u] = ArgMax(count, [&](size_t i) { return -coordinate(i); });
+		extremes[axis * 2u + 1u] = ArgMax(count, coordinate);
+	}
+	uint32_t simplex[4] = { extremes[0],extremes[1],0u,0u };
+	double widestSq = -1.0;
+	for (size_t axis = 0; axis < 3u; axis++)
+	{
+		const auto d = points[extremes[axis * 2u + 1u]] - points[extremes[axis * 2u]];
+		if (Dot(d, d) > widestSq)
+		{
+			widestSq = Dot(d, d);
+			simplex[0] = extremes[axis * 2u];
+			simplex[1] = extremes[axis * 2u + 1u];
+		}
+	}
+	if (std::sqrt(widestSq) <= flatTolerance)
+	{
+		return {};
+	}
+	const auto p0 = points[simplex[0]];
+	const auto lineDirection = (points[simplex[1]] - p0) * (1.0 / std::sqrt(widestSq));
+	const auto lineDistanceSq = [&](size_t i)
+	{
+		const auto d = Cross(points[i] - p0, lineDirection);
+		return Dot(d, d);
+	};
+	simplex[2] = ArgMax(count, lineDistanceSq);
+	if (std::sqrt(lineDistanceSq(simplex[2])) <= flatTolerance)
+	{
+		return {};
+	}
+	auto normal = Cross(points[simplex[1]] - p0, points[simplex[2]] - p0);
+	normal = normal * (1.0 / std::sqrt(Dot(normal, normal)));
+	const auto planeDistance = [&](size_t i) { return std::abs(Dot(points[i] - p0, normal)); };
+	simplex[3] = ArgMax(count, planeDistance);
+	if (planeDistance(simplex[3]) <= flatTolerance)
+	{
+		return FlatHull(points, p0, lineDirection, normal);
+	}
+
+	Quickhull quickhull(std::move(points), epsilon);
+	quickhull.Build(simplex, maxVertices == 0u ? 0u : std::max<size_t>(maxVertices, 4u));
+	return quickhull.Extract();
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// the hull as triangles over a subset of the input points
+// points[i] is the input point that hull vertex i sits on, indices index into points
+struct HullTopology
+{
+	std::vector<uint32_t> points;
+	std::vector<uint32_t> indices;
+};
+
+// convex hull by quickhull: start from a tetrahedron on extreme points, then repeatedly take
+// the point farthest outside any face, replace every face it can see with a fan from the
+// horizon to it, and hand the points those faces had outside them to the new faces
+// planes and distances are in double precision, points within a tolerance scaled to the
+// coordinates of a face count as on it, so coplanar and duplicate points add nothing
+// triangles are wound like the generators (outward normal is cross(p1-p0,p2-p0))
+// inputs that are all within tolerance of a plane give a flat, double-sided polygon, inputs
+// along a line or on a single point give an empty hull
+class ConvexHull
+{
+public:
+	// maxVertices > 0 stops after that many vertices; since the farthest point goes first the
+	// result is the best hull of that size this way finds, lying inside the exact hull (what an
+	// occluder needs, and close enough for a collision proxy). it doesn't limit flat hulls
+	static HullTopology Build(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count, size_t maxVertices = 0u);
+	// hull vertices only get positions, other attributes are value-initialized
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Make(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count,
+		size_t maxVertices = 0u, std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		const auto hull = Build(pPositions, stride, count, maxVertices);
+		IndexedTriangleList<V, I>::CheckIndexRange(hull.points.size());
+		IndexedTriangleList<V, I> list(pMem);
+		auto& vertices = list.GetVertices();
+		vertices.resize(hull.points.size());
+		for (size_t i = 0; i < hull.points.size(); i++)
+		{
+			vertices[i].pos = *reinterpret_cast<const DirectX::XMFLOAT3*>(
+				reinterpret_cast<const char*>(pPositions) + hull.points[i] * stride);
+		}
+		list.indices.assign(hull.indices.begin(), hull.indices.end());
+		return list;
+	}
+	template<class V, class I>
+	static IndexedTriangleList<V, I> Make(const IndexedTriangleList<V, I>& mesh, size_t maxVertices = 0u)
+	{
+		assert("apply or take the pending transform first" && !mesh.HasPendingTransform());
+		const auto& vertices = mesh.GetVertices();
+		if (vertices.empty())
+		{
+			return IndexedTriangleList<V, I>(mesh.GetResource());
+		}
+		return Make<V, I>(&vertices.front().pos, sizeof(V), vertices.size(), maxVertices, mesh.GetResource());
+	}
+};
\ No newline at end of file
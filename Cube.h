@@ -1,30 +1,27 @@
 #pragma once
 #include "IndexedTriangleList.h"
 #include <DirectXMath.h>
+#include <array>
 class Cube
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> Make()
+	template<class I = unsigned int>
+	static constexpr TriangleTable<8, 36, I> MakeTable()
 	{
 		namespace dx = DirectX;
 		constexpr float side = 1.0f / 2.0f;
-		std::vector<dx::XMFLOAT3> vertices;
-		vertices.emplace_back(-side, -side, -side); // 0
-		vertices.emplace_back(side, -side, -side); // 1
-		vertices.emplace_back(-side, side, -side); // 2
-		vertices.emplace_back(side, side, -side); // 3
-		vertices.emplace_back(-side, -side, side); // 4
-		vertices.emplace_back(side, -side, side); // 5
-		vertices.emplace_back(-side, side, side); // 6
-		vertices.emplace_back(side, side, side); // 7
-		std::vector<V> verts(vertices.size());
-		for (size_t i = 0; i < vertices.size(); i++)
-		{
-			verts[i].pos = vertices[i];
-		}
-		return{
-			std::move(verts),{
+		return {
+			{
+				dx::XMFLOAT3{ -side,-side,-side }, // 0
+				dx::XMFLOAT3{ side,-side,-side }, // 1
+				dx::XMFLOAT3{ -side,side,-side }, // 2
+				dx::XMFLOAT3{ side,side,-side }, // 3
+				dx::XMFLOAT3{ -side,-side,side }, // 4
+				dx::XMFLOAT3{ side,-side,side }, // 5
+				dx::XMFLOAT3{ -side,side,side }, // 6
+				dx::XMFLOAT3{ side,side,side }, // 7
+			},
+			{
 				0,2,1, 2,3,1,
 				1,3,5, 3,7,5,
 				2,6,3, 3,6,7,
@@ -34,4 +31,10 @@ public:
 			}
 		};
 	}
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Make(std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		static constexpr auto table = MakeTable<I>();
+		return IndexedTriangleList<V, I>::FromTable(table, pMem);
+	}
 };
\ No newline at end of file
@@ -4,6 +4,14 @@
 #include <cassert>
 #include <typeinfo>
 
+Drawable::Drawable(std::pmr::memory_resource* pMem)
+	:
+	binds(pMem)
+{
+	// one up-front allocation instead of growing the bind list piecemeal
+	binds.reserve(nReservedBinds);
+}
+
 void Drawable::Draw(Graphics& gfx) const noexcept(!IS_DEBUG)
 {
 	for (auto& b : binds)
@@ -17,13 +25,13 @@ void Drawable::Draw(Graphics& gfx) const noexcept(!IS_DEBUG)
 	gfx.DrawIndexed(pIndexBuffer->GetCount());
 }
 
-void Drawable::AddBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG)
+void Drawable::AddBind(ArenaPtr<Bindable> bind) noexcept(!IS_DEBUG)
 {
 	assert("*Must* use AddIndexBuffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer));
 	binds.push_back(std::move(bind));
 }
 
-void Drawable::AddIndexBuffer(std::unique_ptr<IndexBuffer> ibuf) noexcept(!IS_DEBUG)
+void Drawable::AddIndexBuffer(ArenaPtr<IndexBuffer> ibuf) noexcept(!IS_DEBUG)
 {
 	assert("Attempting to add index buffer a second time" && pIndexBuffer == nullptr);
 	pIndexBuffer = ibuf.get();
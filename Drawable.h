@@ -1,6 +1,8 @@
 #pragma once
 #include "Graphics.h"
+#include "ArenaPtr.h"
 #include <DirectXMath.h>
+#include <memory_resource>
 
 class Bindable;
 
@@ -9,18 +11,25 @@ class Drawable
 	template<class T>
 	friend class DrawableBase;
 public:
-	Drawable() = default;
+	Drawable(std::pmr::memory_resource* pMem);
 	Drawable(const Drawable&) = delete;
 	virtual DirectX::XMMATRIX GetTransformXM() const noexcept = 0;
 	void Draw(Graphics& gfx) const noexcept(!IS_DEBUG);
 	virtual void Update(float dt) noexcept = 0;
 	virtual ~Drawable() = default;
 protected:
-	void AddBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG);
-	void AddIndexBuffer(std::unique_ptr<class IndexBuffer> ibuf) noexcept(!IS_DEBUG);
+	// per-instance bindables live in the same memory resource as their drawable
+	template<class B, class... Args>
+	ArenaPtr<B> MakeBind(Args&&... args)
+	{
+		return MakeArena<B>(binds.get_allocator().resource(), std::forward<Args>(args)...);
+	}
+	void AddBind(ArenaPtr<Bindable> bind) noexcept(!IS_DEBUG);
+	void AddIndexBuffer(ArenaPtr<class IndexBuffer> ibuf) noexcept(!IS_DEBUG);
 private:
-	virtual const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept = 0;
+	virtual const std::pmr::vector<ArenaPtr<Bindable>>& GetStaticBinds() const noexcept = 0;
 private:
+	static constexpr size_t nReservedBinds = 4u;
 	const class IndexBuffer* pIndexBuffer = nullptr;
-	std::vector<std::unique_ptr<Bindable>> binds;
+	std::pmr::vector<ArenaPtr<Bindable>> binds;
 };
\ No newline at end of file
@@ -1,47 +1,63 @@
 #pragma once
 #include "Drawable.h"
 #include "IndexBuffer.h"
+#include "MemoryArena.h"
+#include <mutex>
 
 template<class T>
 class DrawableBase : public Drawable
 {
 protected:
-	static bool IsStaticInitialized() noexcept
+	DrawableBase(std::pmr::memory_resource* pMem)
+		:
+		Drawable(pMem)
 	{
-		return !staticBinds.empty();
 	}
-	static void AddStaticBind(std::unique_ptr<Bindable> bind) noexcept(!IS_DEBUG)
+	// runs the shared bind setup exactly once, even when instances are built concurrently
+	template<class F>
+	static void InitializeStatic(F&& init)
+	{
+		std::call_once(statics.initFlag, std::forward<F>(init));
+	}
+	// shared bindables are load-time data and go in the monotonic static arena
+	template<class B, class... Args>
+	static ArenaPtr<B> MakeStaticBind(Args&&... args)
+	{
+		return MakeArena<B>(&statics.arena, std::forward<Args>(args)...);
+	}
+	static void AddStaticBind(ArenaPtr<Bindable> bind) noexcept(!IS_DEBUG)
 	{
 		assert("*Must* use AddStaticIndexBuffer to bind index buffer" && typeid(*bind) != typeid(IndexBuffer));
-		staticBinds.push_back(std::move(bind));
+		statics.binds.push_back(std::move(bind));
 	}
-	void AddStaticIndexBuffer(std::unique_ptr<IndexBuffer> ibuf) noexcept(!IS_DEBUG)
+	static void AddStaticIndexBuffer(ArenaPtr<IndexBuffer> ibuf) noexcept(!IS_DEBUG)
 	{
-		assert("Attempting to add index buffer a second time" && pIndexBuffer == nullptr);
-		pIndexBuffer = ibuf.get();
-		staticBinds.push_back(std::move(ibuf));
+		assert("Attempting to add static index buffer a second time" && statics.pIndexBuffer == nullptr);
+		statics.pIndexBuffer = ibuf.get();
+		statics.binds.push_back(std::move(ibuf));
 	}
 	void SetIndexFromStatic() noexcept(!IS_DEBUG)
 	{
 		assert("Attempting to add index buffer a second time" && pIndexBuffer == nullptr);
-		for (const auto& b : staticBinds)
-		{
-			if (const auto p = dynamic_cast<IndexBuffer*>(b.get()))
-			{
-				pIndexBuffer = p;
-				return;
-			}
-		}
+		pIndexBuffer = statics.pIndexBuffer;
 		assert("Failed to find index buffer in static binds" && pIndexBuffer != nullptr);
 	}
 private:
-	const std::vector<std::unique_ptr<Bindable>>& GetStaticBinds() const noexcept override
+	const std::pmr::vector<ArenaPtr<Bindable>>& GetStaticBinds() const noexcept override
 	{
-		return staticBinds;
+		return statics.binds;
 	}
 private:
-	static std::vector<std::unique_ptr<Bindable>> staticBinds;
+	struct Statics
+	{
+		// arena is declared first so it outlives the binds allocated from it
+		MemoryArena arena{ 4096u };
+		std::pmr::vector<ArenaPtr<Bindable>> binds{ &arena };
+		const IndexBuffer* pIndexBuffer = nullptr;
+		std::once_flag initFlag;
+	};
+	static Statics statics;
 };
 
 template<class T>
-std::vector<std::unique_ptr<Bindable>> DrawableBase<T>::staticBinds;
\ No newline at end of file
+typename DrawableBase<T>::Statics DrawableBase<T>::statics;
\ No newline at end of file
@@ -2,7 +2,6 @@
 #include "Window.h"
 #include "Graphics.h"
 #include <dxgidebug.h>
-#include <memory>
 #include "GraphicsThrowMacros.h"
 #include "WindowsThrowMacros.h"
 
@@ -31,15 +30,21 @@ DxgiInfoManager::DxgiInfoManager()
 	GFX_THROW_NOINFO(DxgiGetDebugInterface(__uuidof(IDXGIInfoQueue), &pDxgiInfoQueue));
 }
 
+std::unique_lock<std::mutex> DxgiInfoManager::Lock()
+{
+	return std::unique_lock<std::mutex>(mutex);
+}
+
 void DxgiInfoManager::Set() noexcept
 {
 	// set the index (next) so that the next all to GetMessages()
 	// will only get errors generated after this call
 	next = pDxgiInfoQueue->GetNumStoredMessages(DXGI_DEBUG_ALL);
 }
-std::vector<std::string> DxgiInfoManager::GetMessages() const
+FrameVector<std::pmr::string> DxgiInfoManager::GetMessages() const
 {
-	std::vector<std::string> messages;
+	auto* const pMem = FrameAllocator::Get();
+	FrameVector<std::pmr::string> messages{ pMem };
 	const auto end = pDxgiInfoQueue->GetNumStoredMessages(DXGI_DEBUG_ALL);
 	for (auto i = next; i < end; i++)
 	{
@@ -47,9 +52,8 @@ std::vector<std::string> DxgiInfoManager::GetMessages() const
 		SIZE_T messageLength;
 		// get the size of message i in bytes
 		GFX_THROW_NOINFO(pDxgiInfoQueue->GetMessage(DXGI_DEBUG_ALL, i, nullptr, &messageLength));
-		// allocate memory for message
-		auto bytes = std::make_unique<byte[]>(messageLength);
-		auto pMessage = reinterpret_cast<DXGI_INFO_QUEUE_MESSAGE*>(bytes.get());
+		// allocate memory for message (frame scratch is rewound as a whole, so it is not given back)
+		auto pMessage = static_cast<DXGI_INFO_QUEUE_MESSAGE*>(pMem->allocate(messageLength, alignof(DXGI_INFO_QUEUE_MESSAGE)));
 		// get the message and push its description into the vector
 		GFX_THROW_NOINFO(pDxgiInfoQueue->GetMessage(DXGI_DEBUG_ALL, i, pMessage, &messageLength));
 		messages.emplace_back(pMessage->pDescription);
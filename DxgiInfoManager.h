@@ -4,6 +4,8 @@
 #include <vector>
 #include <string>
 #include <dxgidebug.h>
+#include <mutex>
+#include "FrameAllocator.h"
 
 class DxgiInfoManager
 {
@@ -12,9 +14,14 @@ public:
 	~DxgiInfoManager() = default;
 	DxgiInfoManager(const DxgiInfoManager&) = delete;
 	DxgiInfoManager& operator=(const DxgiInfoManager&) = delete;
+	// held from Set() until the messages are read, so that with resources being created on
+	// several threads one call's Set() can't move the cursor under another's GetMessages()
+	std::unique_lock<std::mutex> Lock();
 	void Set() noexcept;
-	std::vector<std::string> GetMessages() const;
+	// messages since Set(), in the calling thread's frame scratch memory
+	FrameVector<std::pmr::string> GetMessages() const;
 private:
+	std::mutex mutex;
 	unsigned long long next = 0u;
 	Microsoft::WRL::ComPtr<IDXGIInfoQueue> pDxgiInfoQueue;
 };
\ No newline at end of file
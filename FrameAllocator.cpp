@@ -0,0 +1,75 @@
+#include "FrameAllocator.h"
+#include "MemoryArena.h"
+#include <atomic>
+
+namespace
+{
+	std::atomic<unsigned long long> frameIndex = 0u;
+#ifndef NDEBUG
+	std::atomic<size_t> highWaterMark = 0u;
+#endif
+
+	void RecordUsage(size_t bytes) noexcept
+	{
+#ifndef NDEBUG
+		size_t prev = highWaterMark.load(std::memory_order_relaxed);
+		while (prev < bytes && !highWaterMark.compare_exchange_weak(prev, bytes, std::memory_order_relaxed));
+#endif
+	}
+
+	struct ThreadFrameArenas
+	{
+		~ThreadFrameArenas()
+		{
+			// worker threads may exit before their usage is ever sampled
+			RecordUsage(arenas[0].GetBytesUsed());
+			RecordUsage(arenas[1].GetBytesUsed());
+		}
+		MemoryArena arenas[2] = { FrameAllocator::blockSize,FrameAllocator::blockSize };
+		// frame each arena was last rewound for
+		unsigned long long frames[2] = { 0u,0u };
+	};
+	thread_local ThreadFrameArenas threadArenas;
+}
+
+std::pmr::memory_resource* FrameAllocator::Get() noexcept
+{
+	const auto frame = frameIndex.load(std::memory_order_relaxed);
+	const auto i = size_t(frame & 1u);
+	auto& arena = threadArenas.arenas[i];
+	if (threadArenas.frames[i] != frame)
+	{
+		// first request on this thread since the buffer was current two frames ago
+		RecordUsage(arena.GetBytesUsed());
+		arena.Reset();
+		threadArenas.frames[i] = frame;
+	}
+	return &arena;
+}
+
+void FrameAllocator::EndFrame() noexcept
+{
+	frameIndex.fetch_add(1u, std::memory_order_relaxed);
+}
+
+unsigned long long FrameAllocator::GetFrameIndex() noexcept
+{
+	return frameIndex.load(std::memory_order_relaxed);
+}
+
+size_t FrameAllocator::GetHighWaterMark() noexcept
+{
+#ifndef NDEBUG
+	// include whatever the calling thread has used so far in the frames still live
+	RecordUsage(threadArenas.arenas[0].GetBytesUsed());
+	RecordUsage(threadArenas.arenas[1].GetBytesUsed());
+	return highWaterMark.load(std::memory_order_relaxed);
+#else
+	return 0u;
+#endif
+}
+
+size_t FrameAllocator::GetBytesReserved() noexcept
+{
+	return threadArenas.arenas[0].GetBytesReserved() + threadArenas.arenas[1].GetBytesReserved();
+}
\ No newline at end of file
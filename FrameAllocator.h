@@ -0,0 +1,39 @@
+#pragma once
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+// thread-local, double-buffered linear scratch memory for per-frame temporaries
+// (visible lists, sort keys, command streams, matrices...)
+// memory obtained during frame N stays valid through frame N+1; the buffer is
+// rewound the first time its thread asks for it again in frame N+2. buffers keep
+// their blocks across resets, so once warmed up the frame loop never touches the heap
+class FrameAllocator
+{
+public:
+	static constexpr size_t blockSize = 256u * 1024u;
+public:
+	// scratch resource of the calling thread for the current frame
+	static std::pmr::memory_resource* Get() noexcept;
+	// advance to the next frame (called from Graphics::EndFrame)
+	static void EndFrame() noexcept;
+	static unsigned long long GetFrameIndex() noexcept;
+	// largest amount of scratch memory any thread has used in a single frame
+	// (only tracked in debug builds, always 0 in release)
+	static size_t GetHighWaterMark() noexcept;
+	// memory the calling thread's two buffers hold on to; stops growing once the
+	// largest frame has gone through both of them
+	static size_t GetBytesReserved() noexcept;
+};
+
+// standard containers backed by the calling thread's frame scratch memory
+template<class T>
+using FrameVector = std::pmr::vector<T>;
+
+template<class T>
+FrameVector<T> MakeFrameVector(size_t reserve = 0u)
+{
+	FrameVector<T> v{ FrameAllocator::Get() };
+	v.reserve(reserve);
+	return v;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "FrameAllocatorTest.h"
+#include "FrameAllocator.h"
+#include <string>
+#include <cstdint>
+
+namespace
+{
+	// a frame's worth of scratch: a list grown one element at a time (every intermediate
+	// capacity stays behind in the buffer, the worst case for a linear allocator) and some
+	// strings, the way the debug info messages come out of DxgiInfoManager
+	void SimulateFrame()
+	{
+		auto list = MakeFrameVector<uint32_t>();
+		for (uint32_t i = 0; i < 100000u; i++)
+		{
+			list.push_back(i);
+		}
+		auto messages = MakeFrameVector<std::pmr::string>(16u);
+		for (int i = 0; i < 16; i++)
+		{
+			messages.emplace_back(200u, 'x');
+		}
+	}
+}
+
+bool FrameAllocatorTest::ScratchOutlivesNextFrame()
+{
+	FrameAllocator::EndFrame();
+	auto previous = MakeFrameVector<uint32_t>(1000u);
+	for (uint32_t i = 0; i < 1000u; i++)
+	{
+		previous.push_back(i);
+	}
+	FrameAllocator::EndFrame();
+	auto current = MakeFrameVector<uint32_t>(1000u);
+	for (uint32_t i = 0; i < 1000u; i++)
+	{
+		current.push_back(~i);
+	}
+	for (uint32_t i = 0; i < 1000u; i++)
+	{
+		if (previous[i] != i || current[i] != ~i)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FrameAllocatorTest::SteadyStateReservesNothing()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		SimulateFrame();
+		FrameAllocator::EndFrame();
+	}
+	const size_t reserved = FrameAllocator::GetBytesReserved();
+	for (int i = 0; i < 16; i++)
+	{
+		SimulateFrame();
+		FrameAllocator::EndFrame();
+		if (FrameAllocator::GetBytesReserved() != reserved)
+		{
+			return false;
+		}
+	}
+	return reserved != 0u;
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+// frame scratch lifetime and steady-state checks, run on the calling thread's buffers by hw3dtest
+class FrameAllocatorTest
+{
+public:
+	// memory from frame N is left alone while frame N + 1 allocates
+	static bool ScratchOutlivesNextFrame();
+	// once both buffers have seen the frame, repeating it reserves nothing more
+	static bool SteadyStateReservesNothing();
+};
\ No newline at end of file
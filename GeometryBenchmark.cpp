@@ -0,0 +1,61 @@
+#include "GeometryBenchmark.h"
+#include "Sphere.h"
+#include "Cone.h"
+#include "Prism.h"
+#include "ChiliTimer.h"
+#include <vector>
+
+namespace dx = DirectX;
+
+namespace
+{
+	// vertex as the drawables use it, so stores land with a realistic stride
+	struct Vertex
+	{
+		dx::XMFLOAT3 pos;
+		dx::XMFLOAT3 n;
+	};
+
+	template<class F>
+	float Measure(size_t nVertices, int nRuns, F&& generate)
+	{
+		// one untimed run to fault the pages in
+		generate();
+		ChiliTimer timer;
+		for (int i = 0; i < nRuns; i++)
+		{
+			generate();
+		}
+		return float(nVertices) * float(nRuns) / timer.Peek();
+	}
+}
+
+float GeometryBenchmark::Sphere(int latDiv, int longDiv, int nRuns)
+{
+	std::vector<Vertex> vertices(::Sphere::VertexCount(latDiv, longDiv));
+	std::vector<unsigned int> indices(::Sphere::IndexCount(latDiv, longDiv));
+	return Measure(vertices.size(), nRuns, [&]()
+	{
+		::Sphere::Generate<Vertex, unsigned int>(latDiv, longDiv, vertices, indices);
+	});
+}
+
+float GeometryBenchmark::Cone(int longDiv, int nRuns)
+{
+	std::vector<Vertex> vertices(::Cone::VertexCount(longDiv));
+	std::vector<unsigned int> indices(::Cone::IndexCount(longDiv));
+	return Measure(vertices.size(), nRuns, [&]()
+	{
+		::Cone::Generate<Vertex, unsigned int>(longDiv, vertices, indices);
+	});
+}
+
+float GeometryBenchmark::Prism(int longDiv, int nRuns)
+{
+	std::vector<Vertex> vertices(::Prism::VertexCount(longDiv));
+	std::vector<unsigned int> indices(::Prism::IndexCount(longDiv));
+	return Measure(vertices.size(), nRuns, [&]()
+	{
+		::Prism::Generate<Vertex, unsigned int>(longDiv, vertices, indices);
+	});
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+// throughput checks for the procedural generators, run by hw3dtest -benchmark; each generates
+// into buffers sized once up front (so only generation is timed) and returns vertices per second
+class GeometryBenchmark
+{
+public:
+	// what every generator has to sustain on one core in an optimized build
+	static constexpr float minVerticesPerSecond = 10.0e6f;
+public:
+	static float Sphere(int latDiv, int longDiv, int nRuns = 16);
+	static float Cone(int longDiv, int nRuns = 16);
+	static float Prism(int longDiv, int nRuns = 16);
+};
\ No newline at end of file
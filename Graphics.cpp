@@ -5,6 +5,7 @@
 #include <cmath>
 #include <DirectXMath.h>
 #include "GraphicsThrowMacros.h"
+#include "FrameAllocator.h"
 
 namespace wrl = Microsoft::WRL;
 namespace dx = DirectX;
@@ -113,6 +114,7 @@ void Graphics::EndFrame()
 {
 	HRESULT hr;
 #ifndef NDEBUG
+	const auto infoLock = infoManager.Lock();
 	infoManager.Set();
 #endif
 	if (FAILED(hr = pSwap->Present(1u, 0u)))
@@ -126,6 +128,8 @@ void Graphics::EndFrame()
 			throw GFX_EXCEPT(hr);
 		}
 	}
+	// per-frame scratch memory from two frames ago can now be recycled
+	FrameAllocator::EndFrame();
 }
 
 void Graphics::ClearBuffer(float red, float green, float blue) noexcept
@@ -152,7 +156,7 @@ DirectX::XMMATRIX Graphics::GetProjection() const noexcept
 
 
 // Graphics exception stuff
-Graphics::HrException::HrException(int line, const char* file, HRESULT hr, std::vector<std::string> infoMsgs) noexcept
+Graphics::HrException::HrException(int line, const char* file, HRESULT hr, std::span<const std::pmr::string> infoMsgs) noexcept
 	:
 	Exception(line, file),
 	hr(hr)
@@ -219,7 +223,7 @@ const char* Graphics::DeviceRemovedException::GetType() const noexcept
 {
 	return "Chili Graphics Exception [Device Removed] (DXGI_ERROR_DEVICE_REMOVED)";
 }
-Graphics::InfoException::InfoException(int line, const char* file, std::vector<std::string> infoMsgs) noexcept
+Graphics::InfoException::InfoException(int line, const char* file, std::span<const std::pmr::string> infoMsgs) noexcept
 	:
 	Exception(line, file)
 {
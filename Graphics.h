@@ -4,6 +4,7 @@
 #include <d3d11.h>
 #include <wrl.h>
 #include <vector>
+#include <span>
 #include "DxgiInfoManager.h"
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
@@ -21,7 +22,7 @@ public:
 	class HrException : public Exception
 	{
 	public:
-		HrException(int line, const char* file, HRESULT hr, std::vector<std::string> infoMsgs = {}) noexcept;
+		HrException(int line, const char* file, HRESULT hr, std::span<const std::pmr::string> infoMsgs = {}) noexcept;
 		const char* what() const noexcept override;
 		const char* GetType() const noexcept override;
 		HRESULT GetErrorCode() const noexcept;
@@ -35,7 +36,7 @@ public:
 	class InfoException : public Exception
 	{
 	public:
-		InfoException(int line, const char* file, std::vector<std::string> infoMsgs) noexcept;
+		InfoException(int line, const char* file, std::span<const std::pmr::string> infoMsgs) noexcept;
 		const char* what() const noexcept override;
 		const char* GetType() const noexcept override;
 		std::string GetErrorInfo() const noexcept;
@@ -74,5 +75,4 @@ private:
 	// Depth testing ensures that pixels closer to the camera overwrite farther ones (hidden surface removal).
 	// Stencil testing allows masking specific parts of the screen during rendering.
 
-};
-
+};
\ No newline at end of file
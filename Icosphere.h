@@ -0,0 +1,130 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <vector>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+// unit sphere from a recursively subdivided icosahedron: every level splits each triangle into
+// four and pushes the new vertices out to the sphere, so triangles stay close to equilateral
+// and evenly spread instead of bunching up at the poles like a uv sphere
+class Icosphere
+{
+public:
+	// level 11 is already 84M triangles
+	static constexpr int maxLevel = 11;
+public:
+	static constexpr size_t VertexCount(int level) noexcept
+	{
+		return 10u * (size_t(1) << (2 * level)) + 2u;
+	}
+	static constexpr size_t IndexCount(int level) noexcept
+	{
+		return 60u * (size_t(1) << (2 * level));
+	}
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> MakeTesselated(int level, std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		namespace dx = DirectX;
+		assert(level >= 0 && level <= maxLevel);
+		const size_t nVertices = VertexCount(level);
+		IndexedTriangleList<V, I>::CheckIndexRange(nVertices);
+
+		// icosahedron with unit circumradius, (0,+-1,+-t) and cyclic permutations normalized
+		constexpr float a = 0.525731112f;
+		constexpr float b = 0.850650808f;
+		constexpr dx::XMFLOAT3 basePositions[12] = {
+			{ -a,b,0.0f },{ a,b,0.0f },{ -a,-b,0.0f },{ a,-b,0.0f },
+			{ 0.0f,-a,b },{ 0.0f,a,b },{ 0.0f,-a,-b },{ 0.0f,a,-b },
+			{ b,0.0f,-a },{ b,0.0f,a },{ -b,0.0f,-a },{ -b,0.0f,a },
+		};
+		constexpr uint32_t baseIndices[60] = {
+			0,11,5, 0,5,1, 0,1,7, 0,7,10, 0,10,11,
+			1,5,9, 5,11,4, 11,10,2, 10,7,6, 7,1,8,
+			3,9,4, 3,4,2, 3,2,6, 3,6,8, 3,8,9,
+			4,9,5, 2,4,11, 6,2,10, 8,6,7, 9,8,1,
+		};
+
+		std::pmr::vector<V> vertices(nVertices, pMem);
+		for (size_t i = 0; i < 12u; i++)
+		{
+			vertices[i].pos = basePositions[i];
+		}
+		size_t nWritten = 12u;
+		// levels ping-pong between two 32-bit buffers, the last one is narrowed into the mesh
+		std::vector<uint32_t> current(std::begin(baseIndices), std::end(baseIndices));
+		std::vector<uint32_t> next;
+		if (level > 0)
+		{
+			current.reserve(IndexCount(level - 1));
+			next.reserve(IndexCount(level));
+		}
+		// edge -> midpoint vertex, open addressing on the packed (min,max) vertex pair
+		// every edge is shared by two triangles, so each lookup either inserts or hits once
+		// sized for the edges of the last level at under half load
+		constexpr uint64_t emptyKey = ~uint64_t(0);
+		const size_t capacity = level > 0 ? std::bit_ceil(IndexCount(level - 1)) : 0u;
+		std::vector<uint64_t> keys;
+		keys.reserve(capacity);
+		std::vector<uint32_t> midpoints(capacity);
+
+		for (int l = 0; l < level; l++)
+		{
+			// this level has IndexCount(l) / 2 edges
+			const size_t levelCapacity = std::bit_ceil(IndexCount(l));
+			const int levelShift = 64 - std::countr_zero(levelCapacity);
+			keys.assign(levelCapacity, emptyKey);
+			const auto midpoint = [&](uint32_t i0, uint32_t i1)
+			{
+				const uint64_t key = i0 < i1 ? (uint64_t(i0) << 32) | i1 : (uint64_t(i1) << 32) | i0;
+				size_t slot = size_t((key * 0x9E3779B97F4A7C15ull) >> levelShift);
+				while (keys[slot] != emptyKey)
+				{
+					if (keys[slot] == key)
+					{
+						return midpoints[slot];
+					}
+					slot = (slot + 1u) & (levelCapacity - 1u);
+				}
+				keys[slot] = key;
+				const auto m = (uint32_t)nWritten++;
+				midpoints[slot] = m;
+				const auto sum = dx::XMVectorAdd(dx::XMLoadFloat3(&vertices[i0].pos), dx::XMLoadFloat3(&vertices[i1].pos));
+				dx::XMStoreFloat3(&vertices[m].pos, dx::XMVector3Normalize(sum));
+				return m;
+			};
+			next.clear();
+			for (size_t i = 0; i < current.size(); i += 3u)
+			{
+				const uint32_t i0 = current[i];
+				const uint32_t i1 = current[i + 1u];
+				const uint32_t i2 = current[i + 2u];
+				const uint32_t m01 = midpoint(i0, i1);
+				const uint32_t m12 = midpoint(i1, i2);
+				const uint32_t m20 = midpoint(i2, i0);
+				// three corner triangles and the middle one, all keeping the parent's winding
+				next.insert(next.end(), {
+					i0,m01,m20,
+					m01,i1,m12,
+					m20,m12,i2,
+					m01,m12,m20
+				});
+			}
+			std::swap(current, next);
+		}
+		assert(nWritten == nVertices);
+
+		std::pmr::vector<I> indices(current.size(), pMem);
+		for (size_t i = 0; i < current.size(); i++)
+		{
+			indices[i] = (I)current[i];
+		}
+		return { std::move(vertices),std::move(indices) };
+	}
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Make(std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		return MakeTesselated<V, I>(2, pMem);
+	}
+};
\ No newline at end of file
@@ -1,9 +1,33 @@
 #include "IndexBuffer.h"
 #include "GraphicsThrowMacros.h"
+#include <algorithm>
 
-IndexBuffer::IndexBuffer(Graphics& gfx, const std::vector<unsigned short>& indices)
+IndexBuffer::IndexBuffer(Graphics& gfx, std::span<const unsigned short> indices)
+	:
+	count((UINT)indices.size()),
+	format(DXGI_FORMAT_R16_UINT)
+{
+	Create(gfx, indices.data(), sizeof(unsigned short));
+}
+
+IndexBuffer::IndexBuffer(Graphics& gfx, std::span<const unsigned int> indices)
 	:
 	count((UINT)indices.size())
+{
+	if (!indices.empty() && *std::max_element(indices.begin(), indices.end()) <= 0xFFFFu)
+	{
+		format = DXGI_FORMAT_R16_UINT;
+		const std::vector<unsigned short> narrow(indices.begin(), indices.end());
+		Create(gfx, narrow.data(), sizeof(unsigned short));
+	}
+	else
+	{
+		format = DXGI_FORMAT_R32_UINT;
+		Create(gfx, indices.data(), sizeof(unsigned int));
+	}
+}
+
+void IndexBuffer::Create(Graphics& gfx, const void* pIndices, UINT stride)
 {
 	INFOMAN(gfx);
 
@@ -12,19 +36,24 @@ IndexBuffer::IndexBuffer(Graphics& gfx, const std::vector<unsigned short>& indic
 	ibd.Usage = D3D11_USAGE_DEFAULT;
 	ibd.CPUAccessFlags = 0u;
 	ibd.MiscFlags = 0u;
-	ibd.ByteWidth = UINT(count * sizeof(unsigned short));
-	ibd.StructureByteStride = sizeof(unsigned short);
+	ibd.ByteWidth = UINT(count * stride);
+	ibd.StructureByteStride = stride;
 	D3D11_SUBRESOURCE_DATA isd = {};
-	isd.pSysMem = indices.data();
+	isd.pSysMem = pIndices;
 	GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&ibd, &isd, &pIndexBuffer));
 }
 
 void IndexBuffer::Bind(Graphics& gfx) noexcept
 {
-	GetContext(gfx)->IASetIndexBuffer(pIndexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0u);
+	GetContext(gfx)->IASetIndexBuffer(pIndexBuffer.Get(), format, 0u);
 }
 
 UINT IndexBuffer::GetCount() const noexcept
 {
 	return count;
+}
+
+DXGI_FORMAT IndexBuffer::GetFormat() const noexcept
+{
+	return format;
 }
\ No newline at end of file
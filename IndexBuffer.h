@@ -1,13 +1,20 @@
 #pragma once
 #include "Bindable.h"
+#include <span>
 
 class IndexBuffer : public Bindable
 {
 public:
-	IndexBuffer(Graphics& gfx, const std::vector<unsigned short>& indices);
+	IndexBuffer(Graphics& gfx, std::span<const unsigned short> indices);
+	// 32-bit index data is narrowed to a 16-bit buffer when every index fits
+	IndexBuffer(Graphics& gfx, std::span<const unsigned int> indices);
 	void Bind(Graphics& gfx) noexcept override;
 	UINT GetCount() const noexcept;
+	DXGI_FORMAT GetFormat() const noexcept;
+private:
+	void Create(Graphics& gfx, const void* pIndices, UINT stride);
 protected:
 	UINT count;
+	DXGI_FORMAT format;
 	Microsoft::WRL::ComPtr<ID3D11Buffer> pIndexBuffer;
 };
\ No newline at end of file
@@ -1,12 +1,57 @@
 #pragma once
+#include "StreamTransform.h"
+#include "MeshBounds.h"
 #include <vector>
+#include <array>
+#include <memory_resource>
 #include <DirectXMath.h>
-template<class T>
+#include <concepts>
+#include <type_traits>
+#include <limits>
+#include <stdexcept>
+#include <cassert>
+#include <mutex>
+// positions and indices of a fixed tessellation, built by a generator's constexpr MakeTable
+// so the data sits in read-only memory instead of being computed at startup
+template<size_t nVertices, size_t nIndices, class I = unsigned int>
+struct TriangleTable
+{
+	std::array<DirectX::XMFLOAT3, nVertices> positions;
+	std::array<I, nIndices> indices;
+};
+
+// generators write through this so one constexpr routine can fill both vertex structs
+// and the bare positions of a TriangleTable
+template<class V>
+constexpr DirectX::XMFLOAT3& PositionOf(V& v) noexcept
+{
+	if constexpr (std::is_same_v<V, DirectX::XMFLOAT3>)
+	{
+		return v;
+	}
+	else
+	{
+		return v.pos;
+	}
+}
+
+// I is the index type: 16-bit meshes halve index memory/bandwidth, 32-bit meshes can
+// address more than 65,536 vertices (IndexBuffer narrows 32-bit data to 16-bit when it fits)
+template<class T, class I = unsigned int>
 class IndexedTriangleList
 {
+	static_assert(std::is_same_v<I, unsigned short> || std::is_same_v<I, unsigned int>,
+		"IndexedTriangleList index type must be unsigned short or unsigned int");
+public:
+	using Index = I;
 public:
-	IndexedTriangleList() = default;
-	IndexedTriangleList(std::vector<T> verts_in, std::vector<unsigned short> indices_in)
+	IndexedTriangleList(std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+		:
+		vertices(pMem),
+		indices(pMem)
+	{
+	}
+	IndexedTriangleList(std::pmr::vector<T> verts_in, std::pmr::vector<I> indices_in)
 		:
 		vertices(std::move(verts_in)),
 		indices(std::move(indices_in))
@@ -14,18 +59,151 @@ public:
 		assert(vertices.size() > 2);
 		assert(indices.size() % 3 == 0);
 	}
+	// size both streams exactly up front so filling them is one allocation apiece
+	void Reserve(size_t nVertices, size_t nIndices)
+	{
+		vertices.reserve(nVertices);
+		indices.reserve(nIndices);
+	}
+	// copies a compile-time table into the vertex / index streams, other vertex attributes are
+	// value-initialized
+	template<size_t nVertices, size_t nIndices>
+	static IndexedTriangleList FromTable(const TriangleTable<nVertices, nIndices, I>& table,
+		std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		IndexedTriangleList list(pMem);
+		list.vertices.resize(nVertices);
+		for (size_t i = 0; i < nVertices; i++)
+		{
+			list.vertices[i].pos = table.positions[i];
+		}
+		list.indices.assign(table.indices.begin(), table.indices.end());
+		return list;
+	}
+	std::pmr::memory_resource* GetResource() const noexcept
+	{
+		return vertices.get_allocator().resource();
+	}
+	size_t GetVertexCount() const noexcept
+	{
+		return vertices.size();
+	}
+	// the vertices with any pending transform applied first, so positions are never read
+	// without the transforms recorded on the mesh. the caller may write through the result, so
+	// cached bounds are dropped; writes made after a later GetBounds need InvalidateBounds
+	std::pmr::vector<T>& GetVertices()
+	{
+		ApplyTransform();
+		boundsCache.valid = false;
+		return vertices;
+	}
+	// a const mesh can't apply the pending transform, so reading it with one pending throws
+	const std::pmr::vector<T>& GetVertices() const
+	{
+		if (hasPendingTransform)
+		{
+			throw std::logic_error("IndexedTriangleList: apply or take the pending transform before reading vertices");
+		}
+		return vertices;
+	}
+	// transforms are recorded rather than applied: consecutive calls compose into one pending
+	// matrix, which either reaches the vertices in a single pass through ApplyTransform (which
+	// GetVertices calls) or is handed to the owner by TakeTransform to be folded into its world
+	// matrix, leaving the vertices untouched
 	void Transform(DirectX::FXMMATRIX matrix)
 	{
-		for (auto& v : vertices)
+		namespace dx = DirectX;
+		dx::XMStoreFloat4x4(&pendingTransform, hasPendingTransform ? dx::XMLoadFloat4x4(&pendingTransform) * matrix : matrix);
+		hasPendingTransform = true;
+	}
+	bool HasPendingTransform() const noexcept
+	{
+		return hasPendingTransform;
+	}
+	// positions by the pending matrix and, when T has a normal n, normals by its inverse transpose
+	void ApplyTransform()
+	{
+		if (!hasPendingTransform)
+		{
+			return;
+		}
+		hasPendingTransform = false;
+		boundsCache.valid = false;
+		if (vertices.empty())
+		{
+			return;
+		}
+		const auto matrix = DirectX::XMLoadFloat4x4(&pendingTransform);
+		StreamTransform::Points(&vertices.front().pos, sizeof(T), vertices.size(), matrix);
+		if constexpr (requires(T v) { { v.n } -> std::same_as<DirectX::XMFLOAT3&>; })
+		{
+			StreamTransform::Normals(&vertices.front().n, sizeof(T), vertices.size(), matrix);
+		}
+	}
+	// the pending matrix (identity when there is none), which the caller now owns
+	DirectX::XMMATRIX TakeTransform() noexcept
+	{
+		if (!hasPendingTransform)
+		{
+			return DirectX::XMMatrixIdentity();
+		}
+		hasPendingTransform = false;
+		return DirectX::XMLoadFloat4x4(&pendingTransform);
+	}
+	// bounds of the vertices, computed on first use and kept until the non-const GetVertices,
+	// ApplyTransform or InvalidateBounds. exactSphere asks for the minimal sphere instead of
+	// Ritter's, orientedBox for an oriented box as well; what is cached is reused as long as it
+	// has everything asked for. the cache is locked, so threads sharing a const mesh can call
+	// this together, and the result is a copy that later calls can't change under the caller
+	BoundingVolumes GetBounds(bool exactSphere = false, bool orientedBox = false) const
+	{
+		const auto& positions = GetVertices();
+		std::lock_guard<std::mutex> lock(boundsCache.mutex);
+		auto& cache = boundsCache;
+		if (!cache.valid || (exactSphere && !cache.bounds.exactSphere) || (orientedBox && !cache.bounds.hasOrientedBox))
 		{
-			const DirectX::XMVECTOR pos = DirectX::XMLoadFloat3(&v.pos);
-			DirectX::XMStoreFloat3(
-				&v.pos,
-				DirectX::XMVector3Transform(pos, matrix)
-			);
+			exactSphere = exactSphere || (cache.valid && cache.bounds.exactSphere);
+			orientedBox = orientedBox || (cache.valid && cache.bounds.hasOrientedBox);
+			cache.bounds = MeshBounds::Compute(positions.empty() ? nullptr : &positions.front().pos, sizeof(T), positions.size(),
+				exactSphere, orientedBox);
+			cache.valid = true;
+		}
+		return cache.bounds;
+	}
+	// for vertex writes through a reference from GetVertices that happen after a GetBounds call
+	void InvalidateBounds() noexcept
+	{
+		boundsCache.valid = false;
+	}
+	// generators call this before filling so too-narrow index types fail loudly instead of wrapping
+	static void CheckIndexRange(size_t nVertices)
+	{
+		if (nVertices > size_t(std::numeric_limits<I>::max()) + 1u)
+		{
+			throw std::length_error("IndexedTriangleList: vertex count exceeds range of index type");
 		}
 	}
 public:
-	std::vector<T> vertices;
-	std::vector<unsigned short> indices;
+	std::pmr::vector<I> indices;
+private:
+	std::pmr::vector<T> vertices;
+	DirectX::XMFLOAT4X4 pendingTransform;
+	bool hasPendingTransform = false;
+	// copies and moves of a mesh start with an empty cache rather than copying the lock
+	struct BoundsCache
+	{
+		BoundsCache() = default;
+		BoundsCache(const BoundsCache&) noexcept
+		{
+		}
+		BoundsCache& operator=(const BoundsCache&) noexcept
+		{
+			valid = false;
+			return *this;
+		}
+		std::mutex mutex;
+		BoundingVolumes bounds;
+		bool valid = false;
+	};
+	mutable BoundsCache boundsCache;
 };
\ No newline at end of file
@@ -2,7 +2,11 @@
 #include "BindableBase.h"
 #include "GraphicsThrowMacros.h"
 #include "Sphere.h"
+#include "MemoryArena.h"
+#include "MeshOptimizer.h"
+#include "VertexQuantizer.h"
 Melon::Melon(Graphics& gfx,
+	std::pmr::memory_resource* pMem,
 	std::mt19937& rng,
 	std::uniform_real_distribution<float>& adist,
 	std::uniform_real_distribution<float>& ddist,
@@ -11,6 +15,7 @@ Melon::Melon(Graphics& gfx,
 	std::uniform_int_distribution<int>& longdist,
 	std::uniform_int_distribution<int>& latdist)
 	:
+	DrawableBase(pMem),
 	r(rdist(rng)),
 	droll(ddist(rng)),
 	dpitch(ddist(rng)),
@@ -23,12 +28,12 @@ Melon::Melon(Graphics& gfx,
 	phi(adist(rng))
 {
 	namespace dx = DirectX;
-	if (!IsStaticInitialized())
+	InitializeStatic([&gfx]
 	{
-		auto pvs = std::make_unique<VertexShader>(gfx, L"ColorIndexVS.cso");
+		auto pvs = MakeStaticBind<VertexShader>(gfx, L"ColorIndexVS.cso");
 		auto pvsbc = pvs->GetBytecode();
 		AddStaticBind(std::move(pvs));
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"ColorIndexPS.cso"));
+		AddStaticBind(MakeStaticBind<PixelShader>(gfx, L"ColorIndexPS.cso"));
 		struct PixelShaderConstants
 		{
 			struct
@@ -52,24 +57,33 @@ Melon::Melon(Graphics& gfx,
 				{ 0.0f,0.0f,0.0f },
 			}
 		};
-		AddStaticBind(std::make_unique<PixelConstantBuffer<PixelShaderConstants>>(gfx, cb2));
-		const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
-		{
-			{ "Position",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 },
-		};
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
-	}
+		AddStaticBind(MakeStaticBind<PixelConstantBuffer<PixelShaderConstants>>(gfx, cb2));
+		AddStaticBind(MakeStaticBind<InputLayout>(gfx, vertexFormat.GetInputLayout(), pvsbc));
+		AddStaticBind(MakeStaticBind<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+	});
 	struct Vertex
 	{
 		dx::XMFLOAT3 pos;
 	};
-	auto model = Sphere::MakeTesselated<Vertex>(latdist(rng), longdist(rng));
-	// deform vertices of model by linear transformation
+	// the cpu-side mesh is only needed until the buffers are created, so generate it
+	// into a scratch arena: one upstream allocation covers both vertex and index storage
+	MemoryArena scratch(64u * 1024u);
+	auto model = Sphere::MakeTesselated<Vertex>(latdist(rng), longdist(rng), &scratch);
+	// deform model by linear transformation. nothing below needs the deformed positions
+	// (stretching along z doesn't change which clusters face outward), so the deformation
+	// is folded into the world transform instead of being applied to every vertex
 	model.Transform(dx::XMMatrixScaling(1.0f, 1.0f, 1.2f));
-	AddBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
-	AddIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
-	AddBind(std::make_unique<TransformCbuf>(gfx, *this));
+	const auto deformation = model.TakeTransform();
+	// triangle order straight out of the generator loops is poor for the vertex cache
+	MeshOptimizer::OptimizeVertexCache(model);
+	MeshOptimizer::OptimizeOverdraw(model);
+	MeshOptimizer::OptimizeVertexFetch(model);
+	// 16-bit positions relative to the melon's bounds, expanded again by the transform
+	const auto quantized = VertexQuantizer::Quantize(vertexFormat, model);
+	dx::XMStoreFloat4x4(&dequantization, quantized.dequantization.GetMatrix() * deformation);
+	AddBind(MakeBind<VertexBuffer>(gfx, quantized));
+	AddIndexBuffer(MakeBind<IndexBuffer>(gfx, model.indices));
+	AddBind(MakeBind<TransformCbuf>(gfx, *this));
 }
 void Melon::Update(float dt) noexcept
 {
@@ -83,7 +97,8 @@ void Melon::Update(float dt) noexcept
 DirectX::XMMATRIX Melon::GetTransformXM() const noexcept
 {
 	namespace dx = DirectX;
-	return dx::XMMatrixRotationRollPitchYaw(pitch, yaw, roll) *
+	return dx::XMLoadFloat4x4(&dequantization) *
+		dx::XMMatrixRotationRollPitchYaw(pitch, yaw, roll) *
 		dx::XMMatrixTranslation(r, 0.0f, 0.0f) *
 		dx::XMMatrixRotationRollPitchYaw(theta, phi, chi) *
 		dx::XMMatrixTranslation(0.0f, 0.0f, 20.0f);
@@ -1,10 +1,12 @@
 #pragma once
 #include "DrawableBase.h"
+#include "VertexQuantizer.h"
 
 class Melon : public DrawableBase<Melon>
 {
 public:
-	Melon(Graphics& gfx, std::mt19937& rng,
+	Melon(Graphics& gfx, std::pmr::memory_resource* pMem,
+		std::mt19937& rng,
 		std::uniform_real_distribution<float>& adist,
 		std::uniform_real_distribution<float>& ddist,
 		std::uniform_real_distribution<float>& odist,
@@ -14,6 +16,9 @@ public:
 	void Update(float dt) noexcept override;
 	DirectX::XMMATRIX GetTransformXM() const noexcept override;
 private:
+	static constexpr VertexFormat vertexFormat = { PositionFormat::Snorm16 };
+	// maps the quantized positions back onto the model's bounds
+	DirectX::XMFLOAT4X4 dequantization;
 	// positional
 	float r;
 	float roll = 0.0f;
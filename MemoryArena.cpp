@@ -0,0 +1,90 @@
+#include "MemoryArena.h"
+#include <algorithm>
+#include <cstdint>
+
+MemoryArena::MemoryArena(size_t blockSize, std::pmr::memory_resource* pUpstream) noexcept
+	:
+	pUpstream(pUpstream),
+	blockSize(blockSize)
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+	Release();
+}
+
+void MemoryArena::Reset() noexcept
+{
+	iCurBlock = 0u;
+	offset = 0u;
+	bytesUsed = 0u;
+}
+
+void MemoryArena::Release() noexcept
+{
+	for (const auto& b : blocks)
+	{
+		pUpstream->deallocate(b.pData, b.size, alignof(std::max_align_t));
+	}
+	blocks.clear();
+	bytesReserved = 0u;
+	Reset();
+}
+
+size_t MemoryArena::GetBytesUsed() const noexcept
+{
+	return bytesUsed;
+}
+
+size_t MemoryArena::GetBytesReserved() const noexcept
+{
+	return bytesReserved;
+}
+
+size_t MemoryArena::GetBlockCount() const noexcept
+{
+	return blocks.size();
+}
+
+void* MemoryArena::do_allocate(size_t bytes, size_t alignment)
+{
+	const auto alignUp = [alignment](uintptr_t p)
+	{
+		return (p + alignment - 1u) & ~(uintptr_t(alignment) - 1u);
+	};
+	// try to fit in the current block, then in any blocks retained from before a Reset()
+	for (; iCurBlock < blocks.size(); iCurBlock++, offset = 0u)
+	{
+		const auto& b = blocks[iCurBlock];
+		const auto base = reinterpret_cast<uintptr_t>(b.pData);
+		const size_t aligned = alignUp(base + offset) - base;
+		if (aligned + bytes <= b.size)
+		{
+			offset = aligned + bytes;
+			bytesUsed += bytes;
+			return b.pData + aligned;
+		}
+	}
+	// need a fresh block (oversized requests get a block of their own)
+	const size_t size = std::max(blockSize, bytes + alignment);
+	const auto pData = static_cast<std::byte*>(pUpstream->allocate(size, alignof(std::max_align_t)));
+	blocks.push_back({ pData,size });
+	bytesReserved += size;
+	iCurBlock = blocks.size() - 1u;
+	const auto base = reinterpret_cast<uintptr_t>(pData);
+	const size_t aligned = alignUp(base) - base;
+	offset = aligned + bytes;
+	bytesUsed += bytes;
+	return pData + aligned;
+}
+
+void MemoryArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+	// monotonic: memory is reclaimed in bulk by Reset() / Release()
+}
+
+bool MemoryArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+// monotonic (bump) memory resource that carves allocations out of large blocks
+// obtained from an upstream resource. individual deallocations are no-ops; memory
+// is reclaimed all at once by Reset() (blocks are kept for reuse) or Release()
+class MemoryArena : public std::pmr::memory_resource
+{
+public:
+	static constexpr size_t defaultBlockSize = 1024u * 1024u;
+public:
+	MemoryArena(size_t blockSize = defaultBlockSize,
+		std::pmr::memory_resource* pUpstream = std::pmr::new_delete_resource()) noexcept;
+	MemoryArena(const MemoryArena&) = delete;
+	MemoryArena& operator=(const MemoryArena&) = delete;
+	~MemoryArena();
+	// rewind to the start of the first block, keeping all blocks for reuse
+	void Reset() noexcept;
+	// return all blocks to the upstream resource
+	void Release() noexcept;
+	size_t GetBytesUsed() const noexcept;
+	size_t GetBytesReserved() const noexcept;
+	size_t GetBlockCount() const noexcept;
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+private:
+	struct Block
+	{
+		std::byte* pData;
+		size_t size;
+	};
+	std::pmr::memory_resource* pUpstream;
+	size_t blockSize;
+	std::vector<Block> blocks;
+	size_t iCurBlock = 0u;
+	size_t offset = 0u;
+	size_t bytesUsed = 0u;
+	size_t bytesReserved = 0u;
+};
\ No newline at end of file
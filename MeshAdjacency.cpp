@@ -0,0 +1,119 @@
+#include "MeshAdjacency.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <cassert>
+
+namespace
+{
+	constexpr size_t minChunkCorners = 16384u;
+	constexpr size_t minChunkVertices = 16384u;
+}
+
+template<class I>
+MeshAdjacency::MeshAdjacency(std::span<const I> indices, size_t nVertices)
+	:
+	cornerVertices(indices.begin(), indices.end()),
+	twins(indices.size()),
+	vertexCorners(nVertices, none)
+{
+	assert("index count must be a multiple of 3" && indices.size() % 3u == 0u);
+	assert("corners must be addressable by uint32" && indices.size() < size_t(nonManifold));
+	const size_t nCorners = indices.size();
+
+	// counting sort of the half-edges by their lower vertex, the bucket offsets end up in
+	// cursors once the scatter has moved every cursor to the start of the next bucket
+	std::vector<std::atomic<uint32_t>> cursors(nVertices);
+	ParallelFor(nCorners, minChunkCorners, [&](size_t first, size_t last)
+	{
+		for (size_t c = first; c < last; c++)
+		{
+			const uint32_t a = cornerVertices[c];
+			const uint32_t b = cornerVertices[Next((uint32_t)c)];
+			assert("index out of range" && a < nVertices);
+			cursors[std::min(a, b)].fetch_add(1u, std::memory_order_relaxed);
+		}
+	});
+	uint32_t offset = 0u;
+	for (auto& cursor : cursors)
+	{
+		offset += cursor.exchange(offset, std::memory_order_relaxed);
+	}
+	// higher vertex in the upper half, corner in the lower, so sorting a bucket sorts by edge
+	// and keeps the half-edges of an edge in corner order whatever order the scatter ran in
+	std::vector<uint64_t> halfEdges(nCorners);
+	ParallelFor(nCorners, minChunkCorners, [&](size_t first, size_t last)
+	{
+		for (size_t c = first; c < last; c++)
+		{
+			const uint32_t a = cornerVertices[c];
+			const uint32_t b = cornerVertices[Next((uint32_t)c)];
+			const uint32_t slot = cursors[std::min(a, b)].fetch_add(1u, std::memory_order_relaxed);
+			halfEdges[slot] = (uint64_t(std::max(a, b)) << 32) | c;
+		}
+	});
+
+	// bucket v now spans [cursors[v - 1], cursors[v]); each worker owns whole buckets, and
+	// every corner lives in exactly one, so the twins writes never collide
+	std::atomic<size_t> nBoundary = 0u;
+	std::atomic<size_t> nNonManifold = 0u;
+	ParallelFor(nVertices, minChunkVertices, [&](size_t first, size_t last)
+	{
+		size_t boundaryEdges = 0u;
+		size_t nonManifoldHalfEdges = 0u;
+		for (size_t v = first; v < last; v++)
+		{
+			const auto begin = halfEdges.begin() + (v == 0u ? 0u : cursors[v - 1u].load(std::memory_order_relaxed));
+			const auto end = halfEdges.begin() + cursors[v].load(std::memory_order_relaxed);
+			std::sort(begin, end);
+			for (auto run = begin; run != end;)
+			{
+				const uint32_t other = uint32_t(*run >> 32);
+				auto runEnd = run + 1;
+				while (runEnd != end && uint32_t(*runEnd >> 32) == other)
+				{
+					++runEnd;
+				}
+				const uint32_t c0 = uint32_t(*run);
+				if (runEnd - run == 1 && other != v)
+				{
+					twins[c0] = boundary;
+					boundaryEdges++;
+				}
+				else if (runEnd - run == 2 && other != v && (cornerVertices[c0] == v) != (cornerVertices[uint32_t(run[1])] == v))
+				{
+					const uint32_t c1 = uint32_t(run[1]);
+					twins[c0] = c1;
+					twins[c1] = c0;
+				}
+				else
+				{
+					for (auto i = run; i != runEnd; ++i)
+					{
+						twins[uint32_t(*i)] = nonManifold;
+					}
+					nonManifoldHalfEdges += size_t(runEnd - run);
+				}
+				run = runEnd;
+			}
+		}
+		nBoundary.fetch_add(boundaryEdges, std::memory_order_relaxed);
+		nNonManifold.fetch_add(nonManifoldHalfEdges, std::memory_order_relaxed);
+	});
+	nBoundaryEdges = nBoundary;
+	nNonManifoldHalfEdges = nNonManifold;
+
+	// lowest outgoing corner per vertex, or the lowest one without a twin if there is one
+	for (uint32_t c = 0; c < nCorners; c++)
+	{
+		uint32_t& corner = vertexCorners[cornerVertices[c]];
+		if (corner == none || (twins[corner] < nonManifold && twins[c] >= nonManifold))
+		{
+			corner = c;
+		}
+	}
+}
+
+template MeshAdjacency::MeshAdjacency(std::span<const unsigned short>, size_t);
+template MeshAdjacency::MeshAdjacency(std::span<const unsigned int>, size_t);
\ No newline at end of file
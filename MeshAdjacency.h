@@ -0,0 +1,155 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <span>
+#include <vector>
+#include <cstdint>
+
+// corner table over an indexed triangle list: corner c is index c of the index buffer, and
+// the half-edge of corner c runs from its vertex to the vertex of Next(c) in the same triangle,
+// so next / prev / triangle are arithmetic and only the vertex and twin of each corner are
+// stored (two uint32 per corner), plus one outgoing corner per vertex
+// built from the index buffer by bucketing every half-edge under its lower vertex in
+// parallel, then sorting each bucket; half-edges on one edge end up next to each other and
+// pair up as twins when there are exactly two running opposite ways. any other edge shared by
+// several half-edges (more than two faces, faces disagreeing on winding, or a degenerate edge
+// from a repeated index) is marked non-manifold and treated like a boundary by the walks
+// index-level work is instantiated for 16-bit and 32-bit indices in MeshAdjacency.cpp
+class MeshAdjacency
+{
+public:
+	static constexpr uint32_t none = 0xFFFFFFFFu;
+public:
+	template<class I>
+	MeshAdjacency(std::span<const I> indices, size_t nVertices);
+	template<class V, class I>
+	explicit MeshAdjacency(const IndexedTriangleList<V, I>& mesh)
+		:
+		MeshAdjacency(std::span<const I>(mesh.indices), mesh.GetVertexCount())
+	{
+	}
+	size_t GetTriangleCount() const noexcept
+	{
+		return cornerVertices.size() / 3u;
+	}
+	size_t GetVertexCount() const noexcept
+	{
+		return vertexCorners.size();
+	}
+	size_t GetBoundaryEdgeCount() const noexcept
+	{
+		return nBoundaryEdges;
+	}
+	// counts half-edges, not edges, since each of them is on its own
+	size_t GetNonManifoldHalfEdgeCount() const noexcept
+	{
+		return nNonManifoldHalfEdges;
+	}
+
+	static uint32_t Next(uint32_t corner) noexcept
+	{
+		return corner % 3u == 2u ? corner - 2u : corner + 1u;
+	}
+	static uint32_t Prev(uint32_t corner) noexcept
+	{
+		return corner % 3u == 0u ? corner + 2u : corner - 1u;
+	}
+	static uint32_t Triangle(uint32_t corner) noexcept
+	{
+		return corner / 3u;
+	}
+	// half-edge corner runs Origin -> Target
+	uint32_t Origin(uint32_t corner) const noexcept
+	{
+		return cornerVertices[corner];
+	}
+	uint32_t Target(uint32_t corner) const noexcept
+	{
+		return cornerVertices[Next(corner)];
+	}
+	// the half-edge running the other way along the same edge, none on boundary and non-manifold edges
+	uint32_t Twin(uint32_t corner) const noexcept
+	{
+		return twins[corner] < nonManifold ? twins[corner] : none;
+	}
+	bool IsBoundary(uint32_t corner) const noexcept
+	{
+		return twins[corner] == boundary;
+	}
+	bool IsNonManifold(uint32_t corner) const noexcept
+	{
+		return twins[corner] == nonManifold;
+	}
+	// triangle across edge k (from corner k to corner k + 1) of triangle t, none if there is no single one
+	uint32_t Neighbour(uint32_t t, uint32_t k) const noexcept
+	{
+		const uint32_t twin = Twin(t * 3u + k);
+		return twin != none ? Triangle(twin) : none;
+	}
+	// a half-edge leaving v, one without a twin if v has any, so walks around v start at the
+	// end of its fan. none for vertices no triangle uses
+	uint32_t OutgoingCorner(uint32_t v) const noexcept
+	{
+		return vertexCorners[v];
+	}
+	bool IsBoundaryVertex(uint32_t v) const noexcept
+	{
+		const uint32_t corner = vertexCorners[v];
+		return corner != none && Twin(corner) == none;
+	}
+	// the boundary (or non-manifold) half-edge that carries on from the one at corner, around
+	// the hole it borders
+	uint32_t NextBoundary(uint32_t corner) const noexcept
+	{
+		assert("NextBoundary needs a half-edge without a twin" && Twin(corner) == none);
+		uint32_t next = Next(corner);
+		for (uint32_t twin = Twin(next); twin != none; twin = Twin(next))
+		{
+			next = Next(twin);
+		}
+		return next;
+	}
+	// f(corner) for each half-edge leaving v, rotating from OutgoingCorner(v) until the fan
+	// ends at a boundary or closes. only the fan holding OutgoingCorner(v) is visited when v
+	// is non-manifold
+	template<class F>
+	void ForEachOutgoing(uint32_t v, F&& f) const
+	{
+		const uint32_t first = vertexCorners[v];
+		if (first == none)
+		{
+			return;
+		}
+		uint32_t corner = first;
+		do
+		{
+			f(corner);
+			corner = Twin(Prev(corner));
+		}
+		while (corner != none && corner != first);
+	}
+	// f(vertex) for each vertex sharing an edge with v
+	template<class F>
+	void ForEachOneRing(uint32_t v, F&& f) const
+	{
+		uint32_t last = none;
+		ForEachOutgoing(v, [&](uint32_t corner)
+		{
+			f(Target(corner));
+			last = corner;
+		});
+		// an open fan has one more edge, on the far side of the last triangle
+		if (last != none && Twin(Prev(last)) == none)
+		{
+			f(Origin(Prev(last)));
+		}
+	}
+private:
+	// twins entries that aren't corners
+	static constexpr uint32_t nonManifold = 0xFFFFFFFEu;
+	static constexpr uint32_t boundary = 0xFFFFFFFFu;
+	std::vector<uint32_t> cornerVertices;
+	std::vector<uint32_t> twins;
+	std::vector<uint32_t> vertexCorners;
+	size_t nBoundaryEdges = 0u;
+	size_t nNonManifoldHalfEdges = 0u;
+};
\ No newline at end of file
@@ -0,0 +1,521 @@
+#include "MeshBounds.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <limits>
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr size_t minChunkVertices = 16384u;
+
+	const dx::XMFLOAT3& Element(const dx::XMFLOAT3* p, size_t stride, size_t i) noexcept
+	{
+		return *reinterpret_cast<const dx::XMFLOAT3*>(reinterpret_cast<const char*>(p) + i * stride);
+	}
+
+	// f(first,last) over one contiguous chunk per worker, results in chunk order for the caller to merge
+	template<class T, class F>
+	std::vector<T> MapChunks(size_t count, F&& f)
+	{
+		const size_t nThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1u);
+		const size_t nChunks = std::clamp<size_t>(count / minChunkVertices, 1u, nThreads);
+		std::vector<T> results(nChunks);
+		ParallelFor(nChunks, 1u, [&](size_t firstChunk, size_t lastChunk)
+		{
+			for (size_t c = firstChunk; c < lastChunk; c++)
+			{
+				results[c] = f(count * c / nChunks, count * (c + 1u) / nChunks);
+			}
+		});
+		return results;
+	}
+
+	struct MinMax
+	{
+		dx::XMFLOAT3 lo;
+		dx::XMFLOAT3 hi;
+	};
+
+	// min / max of load(i) over [0,count)
+	template<class L>
+	MinMax ChunkedMinMax(size_t count, L load)
+	{
+		const auto chunks = MapChunks<MinMax>(count, [=](size_t first, size_t last)
+		{
+			// four accumulator pairs so consecutive points don't wait on each other
+			dx::XMVECTOR lo[4];
+			dx::XMVECTOR hi[4];
+			std::fill(std::begin(lo), std::end(lo), load(first));
+			std::fill(std::begin(hi), std::end(hi), lo[0]);
+			size_t i = first;
+			for (; i + 4u <= last; i += 4u)
+			{
+				for (size_t k = 0; k < 4u; k++)
+				{
+					const auto p = load(i + k);
+					lo[k] = dx::XMVectorMin(lo[k], p);
+					hi[k] = dx::XMVectorMax(hi[k], p);
+				}
+			}
+			for (; i < last; i++)
+			{
+				const auto p = load(i);
+				lo[0] = dx::XMVectorMin(lo[0], p);
+				hi[0] = dx::XMVectorMax(hi[0], p);
+			}
+			MinMax result;
+			dx::XMStoreFloat3(&result.lo, dx::XMVectorMin(dx::XMVectorMin(lo[0], lo[1]), dx::XMVectorMin(lo[2], lo[3])));
+			dx::XMStoreFloat3(&result.hi, dx::XMVectorMax(dx::XMVectorMax(hi[0], hi[1]), dx::XMVectorMax(hi[2], hi[3])));
+			return result;
+		});
+		auto lo = dx::XMLoadFloat3(&chunks.front().lo);
+		auto hi = dx::XMLoadFloat3(&chunks.front().hi);
+		for (const auto& c : chunks)
+		{
+			lo = dx::XMVectorMin(lo, dx::XMLoadFloat3(&c.lo));
+			hi = dx::XMVectorMax(hi, dx::XMLoadFloat3(&c.hi));
+		}
+		MinMax result;
+		dx::XMStoreFloat3(&result.lo, lo);
+		dx::XMStoreFloat3(&result.hi, hi);
+		return result;
+	}
+
+	MinMax PlainMinMax(const dx::XMFLOAT3* pPositions, size_t stride, size_t count)
+	{
+		return ChunkedMinMax(count, [=](size_t i)
+		{
+			return dx::XMLoadFloat3(&Element(pPositions, stride, i));
+		});
+	}
+
+	// min / max of the points transformed by m (rows are what each component is dotted with)
+	MinMax ProjectedMinMax(const dx::XMFLOAT3* pPositions, size_t stride, size_t count, dx::FXMMATRIX m)
+	{
+		return ChunkedMinMax(count, [=](size_t i)
+		{
+			return dx::XMVector3TransformNormal(dx::XMLoadFloat3(&Element(pPositions, stride, i)), m);
+		});
+	}
+
+	struct Vec3d
+	{
+		double x;
+		double y;
+		double z;
+		Vec3d operator+(const Vec3d& rhs) const noexcept { return { x + rhs.x,y + rhs.y,z + rhs.z }; }
+		Vec3d operator-(const Vec3d& rhs) const noexcept { return { x - rhs.x,y - rhs.y,z - rhs.z }; }
+		Vec3d operator*(double s) const noexcept { return { x * s,y * s,z * s }; }
+	};
+
+	double Dot(const Vec3d& a, const Vec3d& b) noexcept
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	Vec3d Cross(const Vec3d& a, const Vec3d& b) noexcept
+	{
+		return { a.y * b.z - a.z * b.y,a.z * b.x - a.x * b.z,a.x * b.y - a.y * b.x };
+	}
+
+	struct Ball
+	{
+		Vec3d center;
+		double radiusSq;
+		bool Contains(const Vec3d& p) const noexcept
+		{
+			const auto d = p - center;
+			// relative slack so points that define the boundary don't test as outside it
+			return Dot(d, d) <= radiusSq * (1.0 + 1e-10) + 1e-30;
+		}
+	};
+
+	Ball BallThrough(const Vec3d& a, const Vec3d& b) noexcept
+	{
+		const auto d = b - a;
+		return { (a + b) * 0.5,Dot(d, d) * 0.25 };
+	}
+
+	// smallest ball with all three on its boundary: the circumcircle's
+	Ball BallThrough(const Vec3d& a, const Vec3d& b, const Vec3d& c) noexcept
+	{
+		const auto u = b - a;
+		const auto v = c - a;
+		const auto w = Cross(u, v);
+		const double wSq = Dot(w, w);
+		const double uSq = Dot(u, u);
+		const double vSq = Dot(v, v);
+		if (wSq <= 1e-24 * uSq * vSq)
+		{
+			// collinear, the ball over the two points farthest apart covers the third
+			const auto bc = c - b;
+			const double bcSq = Dot(bc, bc);
+			if (uSq >= vSq && uSq >= bcSq)
+			{
+				return BallThrough(a, b);
+			}
+			return vSq >= bcSq ? BallThrough(a, c) : BallThrough(b, c);
+		}
+		const auto offset = (Cross(v, w) * uSq + Cross(w, u) * vSq) * (0.5 / wSq);
+		return { a + offset,Dot(offset, offset) };
+	}
+
+	Ball BallThrough(const Vec3d& a, const Vec3d& b, const Vec3d& c, const Vec3d& d) noexcept
+	{
+		const auto u = b - a;
+		const auto v = c - a;
+		const auto t = d - a;
+		const double det = Dot(u, Cross(v, t));
+		const double uSq = Dot(u, u);
+		const double vSq = Dot(v, v);
+		const double tSq = Dot(t, t);
+		if (std::abs(det) <= 1e-12 * std::sqrt(uSq * vSq * tSq))
+		{
+			// coplanar: the smallest of the balls over three of them that holds the fourth
+			const Ball candidates[4] = {
+				BallThrough(a, b, c),BallThrough(a, b, d),BallThrough(a, c, d),BallThrough(b, c, d)
+			};
+			const Vec3d others[4] = { d,c,b,a };
+			const Ball* pBest = nullptr;
+			for (size_t i = 0; i < 4u; i++)
+			{
+				if (candidates[i].Contains(others[i]) && (!pBest || candidates[i].radiusSq < pBest->radiusSq))
+				{
+					pBest = &candidates[i];
+				}
+			}
+			return pBest ? *pBest : *std::max_element(std::begin(candidates), std::end(candidates),
+				[](const Ball& lhs, const Ball& rhs) { return lhs.radiusSq < rhs.radiusSq; });
+		}
+		const auto offset = (Cross(v, t) * uSq + Cross(t, u) * vSq + Cross(u, v) * tSq) * (0.5 / det);
+		return { a + offset,Dot(offset, offset) };
+	}
+
+	// eigenvectors of the symmetric matrix a by cyclic Jacobi rotations, as the columns of v
+	void SymmetricEigenvectors(double a[3][3], double v[3][3]) noexcept
+	{
+		for (size_t r = 0; r < 3u; r++)
+		{
+			for (size_t c = 0; c < 3u; c++)
+			{
+				v[r][c] = r == c ? 1.0 : 0.0;
+			}
+		}
+		for (int sweep = 0; sweep < 32; sweep++)
+		{
+			const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+			const double diagonal = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+			if (off <= 1e-24 * diagonal)
+			{
+				return;
+			}
+			for (size_t p = 0; p < 2u; p++)
+			{
+				for (size_t q = p + 1u; q < 3u; q++)
+				{
+					if (a[p][q] == 0.0)
+					{
+						continue;
+					}
+					// rotation in the (p,q) plane that zeroes a[p][q]
+					const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+					const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+					const double c = 1.0 / std::sqrt(t * t + 1.0);
+					const double s = t * c;
+					for (size_t k = 0; k < 3u; k++)
+					{
+						const double akp = a[k][p];
+						const double akq = a[k][q];
+						a[k][p] = c * akp - s * akq;
+						a[k][q] = s * akp + c * akq;
+					}
+					for (size_t k = 0; k < 3u; k++)
+					{
+						const double apk = a[p][k];
+						const double aqk = a[q][k];
+						a[p][k] = c * apk - s * aqk;
+						a[q][k] = s * apk + c * aqk;
+					}
+					for (size_t k = 0; k < 3u; k++)
+					{
+						const double vkp = v[k][p];
+						const double vkq = v[k][q];
+						v[k][p] = c * vkp - s * vkq;
+						v[k][q] = s * vkp + c * vkq;
+					}
+				}
+			}
+		}
+	}
+}
+
+AxisAlignedBox MeshBounds::ComputeBox(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count)
+{
+	if (count == 0u)
+	{
+		return {};
+	}
+	const auto minMax = PlainMinMax(pPositions, stride, count);
+	return { minMax.lo,minMax.hi };
+}
+
+BoundingSphere MeshBounds::ComputeSphere(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count)
+{
+	if (count == 0u)
+	{
+		return {};
+	}
+	const auto load = [=](size_t i)
+	{
+		return dx::XMLoadFloat3(&Element(pPositions, stride, i));
+	};
+	size_t lo[3] = { 0u,0u,0u };
+	size_t hi[3] = { 0u,0u,0u };
+	const auto& first = Element(pPositions, stride, 0u);
+	float loValue[3] = { first.x,first.y,first.z };
+	float hiValue[3] = { first.x,first.y,first.z };
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto& p = Element(pPositions, stride, i);
+		const float x[3] = { p.x,p.y,p.z };
+		for (size_t axis = 0; axis < 3u; axis++)
+		{
+			if (x[axis] < loValue[axis])
+			{
+				loValue[axis] = x[axis];
+				lo[axis] = i;
+			}
+			if (x[axis] > hiValue[axis])
+			{
+				hiValue[axis] = x[axis];
+				hi[axis] = i;
+			}
+		}
+	}
+	size_t widest = 0u;
+	float widestSq = -1.0f;
+	for (size_t axis = 0; axis < 3u; axis++)
+	{
+		const float d = dx::XMVectorGetX(dx::XMVector3LengthSq(dx::XMVectorSubtract(load(hi[axis]), load(lo[axis]))));
+		if (d > widestSq)
+		{
+			widestSq = d;
+			widest = axis;
+		}
+	}
+	auto c = dx::XMVectorScale(dx::XMVectorAdd(load(lo[widest]), load(hi[widest])), 0.5f);
+	float r = std::sqrt(widestSq) * 0.5f;
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto p = load(i);
+		const float dSq = dx::XMVectorGetX(dx::XMVector3LengthSq(dx::XMVectorSubtract(p, c)));
+		if (dSq > r * r)
+		{
+			const float d = std::sqrt(dSq);
+			// move the center toward p just far enough to cover it and the old sphere
+			const float grown = (r + d) * 0.5f;
+			c = dx::XMVectorAdd(c, dx::XMVectorScale(dx::XMVectorSubtract(p, c), (grown - r) / d));
+			r = grown;
+		}
+	}
+	BoundingSphere sphere;
+	dx::XMStoreFloat3(&sphere.center, c);
+	sphere.radius = r;
+	return sphere;
+}
+
+BoundingSphere MeshBounds::ComputeExactSphere(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count)
+{
+	if (count == 0u)
+	{
+		return {};
+	}
+	std::vector<Vec3d> points(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		const auto& p = Element(pPositions, stride, i);
+		points[i] = { p.x,p.y,p.z };
+	}
+	// the expected linear time relies on the order being random, a fixed seed keeps results repeatable
+	std::shuffle(points.begin(), points.end(), std::mt19937(0x5EEDu));
+
+	// each loop level fixes one more point on the boundary of the ball over the points before it
+	Ball ball = { points[0],0.0 };
+	for (size_t i = 1; i < count; i++)
+	{
+		if (ball.Contains(points[i]))
+		{
+			continue;
+		}
+		ball = { points[i],0.0 };
+		for (size_t j = 0; j < i; j++)
+		{
+			if (ball.Contains(points[j]))
+			{
+				continue;
+			}
+			ball = BallThrough(points[i], points[j]);
+			for (size_t k = 0; k < j; k++)
+			{
+				if (ball.Contains(points[k]))
+				{
+					continue;
+				}
+				ball = BallThrough(points[i], points[j], points[k]);
+				for (size_t l = 0; l < k; l++)
+				{
+					if (!ball.Contains(points[l]))
+					{
+						ball = BallThrough(points[i], points[j], points[k], points[l]);
+					}
+				}
+			}
+		}
+	}
+
+	// round the center to float first, then measure from it so the radius really covers everything
+	BoundingSphere sphere;
+	sphere.center = { (float)ball.center.x,(float)ball.center.y,(float)ball.center.z };
+	const Vec3d center = { sphere.center.x,sphere.center.y,sphere.center.z };
+	double radiusSq = 0.0;
+	for (const auto& p : points)
+	{
+		const auto d = p - center;
+		radiusSq = std::max(radiusSq, Dot(d, d));
+	}
+	sphere.radius = std::nextafter((float)std::sqrt(radiusSq), std::numeric_limits<float>::infinity());
+	return sphere;
+}
+
+OrientedBox MeshBounds::ComputeOrientedBox(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count)
+{
+	OrientedBox box = {};
+	box.axes[0] = { 1.0f,0.0f,0.0f };
+	box.axes[1] = { 0.0f,1.0f,0.0f };
+	box.axes[2] = { 0.0f,0.0f,1.0f };
+	if (count == 0u)
+	{
+		return box;
+	}
+
+	// covariance from sums taken relative to the first point, which keeps the cancellation
+	// in E[xx] - E[x]E[x] small for meshes far from the origin
+	struct Moments
+	{
+		double sum[3];
+		double sumProducts[6];
+	};
+	const auto& origin = Element(pPositions, stride, 0u);
+	const auto chunks = MapChunks<Moments>(count, [=](size_t first, size_t last)
+	{
+		Moments m = {};
+		for (size_t i = first; i < last; i++)
+		{
+			const auto& p = Element(pPositions, stride, i);
+			const double x = double(p.x) - origin.x;
+			const double y = double(p.y) - origin.y;
+			const double z = double(p.z) - origin.z;
+			m.sum[0] += x;
+			m.sum[1] += y;
+			m.sum[2] += z;
+			m.sumProducts[0] += x * x;
+			m.sumProducts[1] += x * y;
+			m.sumProducts[2] += x * z;
+			m.sumProducts[3] += y * y;
+			m.sumProducts[4] += y * z;
+			m.sumProducts[5] += z * z;
+		}
+		return m;
+	});
+	Moments total = {};
+	for (const auto& c : chunks)
+	{
+		for (size_t i = 0; i < 3u; i++)
+		{
+			total.sum[i] += c.sum[i];
+		}
+		for (size_t i = 0; i < 6u; i++)
+		{
+			total.sumProducts[i] += c.sumProducts[i];
+		}
+	}
+	const double n = double(count);
+	const double mean[3] = { total.sum[0] / n,total.sum[1] / n,total.sum[2] / n };
+	double covariance[3][3];
+	const size_t product[3][3] = { { 0u,1u,2u },{ 1u,3u,4u },{ 2u,4u,5u } };
+	for (size_t r = 0; r < 3u; r++)
+	{
+		for (size_t c = 0; c < 3u; c++)
+		{
+			covariance[r][c] = total.sumProducts[product[r][c]] / n - mean[r] * mean[c];
+		}
+	}
+	double eigenvectors[3][3];
+	SymmetricEigenvectors(covariance, eigenvectors);
+	Vec3d axes[3];
+	for (size_t a = 0; a < 3u; a++)
+	{
+		axes[a] = { eigenvectors[0][a],eigenvectors[1][a],eigenvectors[2][a] };
+	}
+	// rebuild the last axis so the frame is orthonormal and right-handed whatever rounding did
+	axes[0] = axes[0] * (1.0 / std::sqrt(Dot(axes[0], axes[0])));
+	axes[2] = Cross(axes[0], axes[1]);
+	axes[2] = axes[2] * (1.0 / std::sqrt(Dot(axes[2], axes[2])));
+	axes[1] = Cross(axes[2], axes[0]);
+
+	// columns are the axes, so transforming a point gives its coordinate along each
+	const auto project = dx::XMMatrixSet(
+		(float)axes[0].x, (float)axes[1].x, (float)axes[2].x, 0.0f,
+		(float)axes[0].y, (float)axes[1].y, (float)axes[2].y, 0.0f,
+		(float)axes[0].z, (float)axes[1].z, (float)axes[2].z, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	);
+	const auto projected = ProjectedMinMax(pPositions, stride, count, project);
+	const auto aabb = ComputeBox(pPositions, stride, count);
+	const auto lo = dx::XMLoadFloat3(&projected.lo);
+	const auto hi = dx::XMLoadFloat3(&projected.hi);
+	const auto aabbLo = dx::XMLoadFloat3(&aabb.min);
+	const auto aabbHi = dx::XMLoadFloat3(&aabb.max);
+	const auto volume = [](dx::FXMVECTOR size)
+	{
+		return dx::XMVectorGetX(size) * dx::XMVectorGetY(size) * dx::XMVectorGetZ(size);
+	};
+	if (volume(dx::XMVectorSubtract(aabbHi, aabbLo)) <= volume(dx::XMVectorSubtract(hi, lo)))
+	{
+		dx::XMStoreFloat3(&box.center, dx::XMVectorScale(dx::XMVectorAdd(aabbLo, aabbHi), 0.5f));
+		dx::XMStoreFloat3(&box.extents, dx::XMVectorScale(dx::XMVectorSubtract(aabbHi, aabbLo), 0.5f));
+		return box;
+	}
+	for (size_t a = 0; a < 3u; a++)
+	{
+		box.axes[a] = { (float)axes[a].x,(float)axes[a].y,(float)axes[a].z };
+	}
+	// going back to model space rounds, pad by a few ulps of the largest coordinate along each axis
+	const auto slack = dx::XMVectorScale(dx::XMVectorMax(dx::XMVectorAbs(lo), dx::XMVectorAbs(hi)),
+		4.0f * std::numeric_limits<float>::epsilon());
+	dx::XMStoreFloat3(&box.extents, dx::XMVectorAdd(dx::XMVectorScale(dx::XMVectorSubtract(hi, lo), 0.5f), slack));
+	// center from projected coordinates back to model space
+	dx::XMStoreFloat3(&box.center, dx::XMVector3TransformNormal(
+		dx::XMVectorScale(dx::XMVectorAdd(lo, hi), 0.5f), dx::XMMatrixTranspose(project)
+	));
+	return box;
+}
+
+BoundingVolumes MeshBounds::Compute(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count,
+	bool exactSphere, bool orientedBox)
+{
+	BoundingVolumes bounds;
+	bounds.box = ComputeBox(pPositions, stride, count);
+	bounds.sphere = exactSphere ? ComputeExactSphere(pPositions, stride, count) : ComputeSphere(pPositions, stride, count);
+	bounds.exactSphere = exactSphere;
+	if (orientedBox)
+	{
+		bounds.orientedBox = ComputeOrientedBox(pPositions, stride, count);
+		bounds.hasOrientedBox = true;
+	}
+	return bounds;
+}
\ No newline at end of file
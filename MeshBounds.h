@@ -0,0 +1,53 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+
+struct AxisAlignedBox
+{
+	DirectX::XMFLOAT3 min;
+	DirectX::XMFLOAT3 max;
+};
+
+struct BoundingSphere
+{
+	DirectX::XMFLOAT3 center;
+	float radius;
+};
+
+// spans center +- extents[a] * axes[a], axes are orthonormal and right-handed
+struct OrientedBox
+{
+	DirectX::XMFLOAT3 center;
+	DirectX::XMFLOAT3 extents;
+	DirectX::XMFLOAT3 axes[3];
+};
+
+// what IndexedTriangleList::GetBounds keeps, orientedBox is only set when hasOrientedBox
+struct BoundingVolumes
+{
+	AxisAlignedBox box;
+	BoundingSphere sphere;
+	OrientedBox orientedBox;
+	bool exactSphere = false;
+	bool hasOrientedBox = false;
+};
+
+// bounding volumes of strided XMFLOAT3 streams, an empty stream gives volumes of size 0 at the origin
+// box: min / max over four independent accumulators per chunk, chunks spread across workers
+// sphere: Ritter's, the widest pair of axis extremes grown to fit, typically 5-20% above minimal
+// exact sphere: Welzl's minimal enclosing sphere, as the iterative loop over a shuffled copy of
+//   the points (expected linear time) in double precision; the radius is finally taken as the
+//   distance to the farthest point, so every point is inside even where rounding bit
+// oriented box: axes are the principal components of the points; falls back to the aabb when
+//   that has less volume, which happens for boxy meshes already lined up with the axes
+class MeshBounds
+{
+public:
+	static AxisAlignedBox ComputeBox(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count);
+	static BoundingSphere ComputeSphere(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count);
+	static BoundingSphere ComputeExactSphere(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count);
+	static OrientedBox ComputeOrientedBox(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count);
+	// box and sphere (exact or Ritter's), and the oriented box when asked for
+	static BoundingVolumes Compute(const DirectX::XMFLOAT3* pPositions, size_t stride, size_t count,
+		bool exactSphere = false, bool orientedBox = false);
+};
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "MeshCleaner.h"
+#include "ChiliMath.h"
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <bit>
+#include <cassert>
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr uint32_t emptySlot = std::numeric_limits<uint32_t>::max();
+
+	uint64_t HashBytes(const std::byte* p, size_t size) noexcept
+	{
+		uint64_t h = 0xCBF29CE484222325ull;
+		size_t i = 0;
+		for (; i + 8u <= size; i += 8u)
+		{
+			uint64_t word;
+			std::memcpy(&word, p + i, 8u);
+			h = (std::rotl(h, 23) ^ word) * 0x9E3779B97F4A7C15ull;
+		}
+		for (; i < size; i++)
+		{
+			h = (h ^ uint64_t(p[i])) * 0x100000001B3ull;
+		}
+		return h ^ (h >> 29);
+	}
+
+	// open addressing table sized for at most nEntries at under half load
+	size_t TableCapacity(size_t nEntries) noexcept
+	{
+		return std::bit_ceil(std::max<size_t>(nEntries * 2u, 16u));
+	}
+
+	struct Cell
+	{
+		int32_t x;
+		int32_t y;
+		int32_t z;
+		bool operator==(const Cell&) const = default;
+	};
+
+	uint64_t HashCell(const Cell& c) noexcept
+	{
+		const uint64_t h = (uint64_t(uint32_t(c.x)) * 73856093u) ^ (uint64_t(uint32_t(c.y)) * 19349663u) ^ (uint64_t(uint32_t(c.z)) * 83492791u);
+		return (h * 0x9E3779B97F4A7C15ull) >> 17;
+	}
+
+	// side is -1 or 1 for the neighbouring cell closer to x
+	int32_t CellCoordinate(float x, double inverseCellSize, int32_t& side) noexcept
+	{
+		constexpr double limit = double(std::numeric_limits<int32_t>::max() - 1);
+		const double scaled = std::clamp(double(x) * inverseCellSize, -limit, limit);
+		const double cell = std::floor(scaled);
+		side = scaled - cell < 0.5 ? -1 : 1;
+		return (int32_t)cell;
+	}
+}
+
+VertexRemap MeshCleaner::MakeWeldRemap(const std::byte* pVertices, size_t stride, size_t nVertices)
+{
+	VertexRemap result;
+	result.remap.resize(nVertices);
+	const size_t mask = TableCapacity(nVertices) - 1u;
+	// slot -> first vertex seen with those bytes
+	std::vector<uint32_t> table(mask + 1u, emptySlot);
+	for (size_t v = 0; v < nVertices; v++)
+	{
+		const std::byte* pVertex = pVertices + v * stride;
+		size_t slot = HashBytes(pVertex, stride) & mask;
+		for (;;)
+		{
+			const uint32_t other = table[slot];
+			if (other == emptySlot)
+			{
+				table[slot] = (uint32_t)v;
+				result.remap[v] = (uint32_t)result.nVertices++;
+				break;
+			}
+			if (std::memcmp(pVertex, pVertices + other * stride, stride) == 0)
+			{
+				result.remap[v] = result.remap[other];
+				break;
+			}
+			slot = (slot + 1u) & mask;
+		}
+	}
+	return result;
+}
+
+VertexRemap MeshCleaner::MakeWeldRemap(const std::byte* pVertices, size_t stride, size_t nVertices,
+	size_t positionOffset, float epsilon)
+{
+	assert("position must lie inside the vertex" && positionOffset + sizeof(dx::XMFLOAT3) <= stride);
+	assert("weld epsilon must be positive" && epsilon > 0.0f);
+	VertexRemap result;
+	result.remap.resize(nVertices);
+	const auto position = [=](size_t v)
+	{
+		dx::XMFLOAT3 p;
+		std::memcpy(&p, pVertices + v * stride + positionOffset, sizeof(p));
+		return p;
+	};
+	// everything but the position has to match exactly
+	const size_t tailOffset = positionOffset + sizeof(dx::XMFLOAT3);
+	const auto sameAttributes = [=](size_t a, size_t b)
+	{
+		const std::byte* pA = pVertices + a * stride;
+		const std::byte* pB = pVertices + b * stride;
+		return std::memcmp(pA, pB, positionOffset) == 0 &&
+			std::memcmp(pA + tailOffset, pB + tailOffset, stride - tailOffset) == 0;
+	};
+
+	// grid of cells two epsilon wide, each a chain of the representatives that fall in it;
+	// anything within epsilon of a vertex lies in its cell or the neighbour on the nearer side
+	// along each axis, 8 cells in all
+	const double inverseCellSize = 0.5 / double(epsilon);
+	const float epsilonSq = epsilon * epsilon;
+	const size_t mask = TableCapacity(nVertices) - 1u;
+	std::vector<Cell> cells(mask + 1u);
+	std::vector<uint32_t> heads(mask + 1u, emptySlot);
+	std::vector<uint32_t> next(nVertices, emptySlot);
+	const auto findSlot = [&](const Cell& cell)
+	{
+		size_t slot = HashCell(cell) & mask;
+		while (heads[slot] != emptySlot && !(cells[slot] == cell))
+		{
+			slot = (slot + 1u) & mask;
+		}
+		return slot;
+	};
+
+	for (size_t v = 0; v < nVertices; v++)
+	{
+		const auto p = position(v);
+		if (!std::isfinite(p.x) || !std::isfinite(p.y) || !std::isfinite(p.z))
+		{
+			// nothing is within epsilon of a nan or infinity, keep it as it is
+			result.remap[v] = (uint32_t)result.nVertices++;
+			continue;
+		}
+		int32_t side[3];
+		const Cell cell = {
+			CellCoordinate(p.x, inverseCellSize, side[0]),
+			CellCoordinate(p.y, inverseCellSize, side[1]),
+			CellCoordinate(p.z, inverseCellSize, side[2])
+		};
+		uint32_t match = emptySlot;
+		for (int neighbour = 0; neighbour < 8 && match == emptySlot; neighbour++)
+		{
+			const Cell searched = {
+				cell.x + (neighbour & 1 ? side[0] : 0),
+				cell.y + (neighbour & 2 ? side[1] : 0),
+				cell.z + (neighbour & 4 ? side[2] : 0)
+			};
+			for (uint32_t other = heads[findSlot(searched)]; other != emptySlot; other = next[other])
+			{
+				const auto q = position(other);
+				const float distanceSq = sq(p.x - q.x) + sq(p.y - q.y) + sq(p.z - q.z);
+				if (distanceSq <= epsilonSq && sameAttributes(v, other))
+				{
+					match = other;
+					break;
+				}
+			}
+		}
+		if (match != emptySlot)
+		{
+			result.remap[v] = result.remap[match];
+			continue;
+		}
+		const size_t slot = findSlot(cell);
+		cells[slot] = cell;
+		next[v] = heads[slot];
+		heads[slot] = (uint32_t)v;
+		result.remap[v] = (uint32_t)result.nVertices++;
+	}
+	return result;
+}
+
+template<class I>
+VertexRemap MeshCleaner::MakeCompactRemap(std::span<const I> indices, size_t nVertices)
+{
+	VertexRemap result;
+	result.remap.assign(nVertices, VertexRemap::unused);
+	for (const auto i : indices)
+	{
+		result.remap[i] = 0u;
+	}
+	for (auto& r : result.remap)
+	{
+		if (r != VertexRemap::unused)
+		{
+			r = (uint32_t)result.nVertices++;
+		}
+	}
+	return result;
+}
+
+template<class I>
+size_t MeshCleaner::RemoveDegenerate(std::span<I> indices,
+	const DirectX::XMFLOAT3* pPositions, size_t stride, float minArea)
+{
+	assert("index count must be a multiple of 3" && indices.size() % 3u == 0u);
+	const auto load = [=](I i)
+	{
+		return dx::XMLoadFloat3(reinterpret_cast<const dx::XMFLOAT3*>(reinterpret_cast<const char*>(pPositions) + i * stride));
+	};
+	// cross product length is twice the area
+	const float minCross = minArea * 2.0f;
+	size_t nKept = 0u;
+	for (size_t i = 0; i < indices.size(); i += 3u)
+	{
+		const I i0 = indices[i];
+		const I i1 = indices[i + 1u];
+		const I i2 = indices[i + 2u];
+		if (i0 == i1 || i1 == i2 || i2 == i0)
+		{
+			continue;
+		}
+		const auto p0 = load(i0);
+		const auto cross = dx::XMVector3Cross(dx::XMVectorSubtract(load(i1), p0), dx::XMVectorSubtract(load(i2), p0));
+		if (!(dx::XMVectorGetX(dx::XMVector3Length(cross)) > minCross))
+		{
+			continue;
+		}
+		indices[nKept++] = i0;
+		indices[nKept++] = i1;
+		indices[nKept++] = i2;
+	}
+	return nKept;
+}
+
+template VertexRemap MeshCleaner::MakeCompactRemap<unsigned short>(std::span<const unsigned short>, size_t);
+template VertexRemap MeshCleaner::MakeCompactRemap<unsigned int>(std::span<const unsigned int>, size_t);
+template size_t MeshCleaner::RemoveDegenerate<unsigned short>(std::span<unsigned short>, const DirectX::XMFLOAT3*, size_t, float);
+template size_t MeshCleaner::RemoveDegenerate<unsigned int>(std::span<unsigned int>, const DirectX::XMFLOAT3*, size_t, float);
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// where every old vertex goes after a weld or compaction pass
+// remap[oldIndex] = newIndex, or unused for vertices that are dropped
+struct VertexRemap
+{
+	static constexpr uint32_t unused = std::numeric_limits<uint32_t>::max();
+	std::vector<uint32_t> remap;
+	size_t nVertices = 0u;
+};
+
+// linear-time passes that strip redundant data from a mesh before it is uploaded
+// welding: vertices that are equal byte for byte (or whose positions lie within epsilon of each
+//   other with every other byte equal) are merged through a hash table into the first of them
+// compaction: vertices no triangle references are dropped
+// degenerates: triangles that repeat an index or enclose no more than minArea are removed
+// vertex order is kept (first occurrence wins), so earlier fetch optimization survives
+// index-level work is instantiated for 16-bit and 32-bit indices in MeshCleaner.cpp
+class MeshCleaner
+{
+public:
+	// vertices are compared as raw bytes, so V should have no padding
+	static VertexRemap MakeWeldRemap(const std::byte* pVertices, size_t stride, size_t nVertices);
+	// positions (at positionOffset in each vertex) within epsilon and the remaining bytes equal
+	static VertexRemap MakeWeldRemap(const std::byte* pVertices, size_t stride, size_t nVertices,
+		size_t positionOffset, float epsilon);
+	template<class I>
+	static VertexRemap MakeCompactRemap(std::span<const I> indices, size_t nVertices);
+	// removes degenerate triangles in place, returns the new index count
+	template<class I>
+	static size_t RemoveDegenerate(std::span<I> indices,
+		const DirectX::XMFLOAT3* pPositions, size_t stride, float minArea = 0.0f);
+
+	// rewrites vertices and indices through remap, returns how many vertices were removed
+	template<class V, class I>
+	static size_t ApplyRemap(IndexedTriangleList<V, I>& mesh, const VertexRemap& remap)
+	{
+		auto& vertices = mesh.GetVertices();
+		std::pmr::vector<V> remapped(remap.nVertices, mesh.GetResource());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			if (remap.remap[i] != VertexRemap::unused)
+			{
+				remapped[remap.remap[i]] = vertices[i];
+			}
+		}
+		for (auto& i : mesh.indices)
+		{
+			i = (I)remap.remap[i];
+		}
+		const size_t nRemoved = vertices.size() - remap.nVertices;
+		vertices = std::move(remapped);
+		return nRemoved;
+	}
+	template<class V, class I>
+	static size_t Weld(IndexedTriangleList<V, I>& mesh)
+	{
+		static_assert(std::is_trivially_copyable_v<V>, "MeshCleaner compares vertices as bytes");
+		const auto& vertices = mesh.GetVertices();
+		return ApplyRemap(mesh, MakeWeldRemap(reinterpret_cast<const std::byte*>(vertices.data()),
+			sizeof(V), vertices.size()));
+	}
+	template<class V, class I>
+	static size_t Weld(IndexedTriangleList<V, I>& mesh, float epsilon)
+	{
+		static_assert(std::is_trivially_copyable_v<V>, "MeshCleaner compares vertices as bytes");
+		const auto& vertices = mesh.GetVertices();
+		if (vertices.empty())
+		{
+			return 0u;
+		}
+		const auto* pBase = reinterpret_cast<const std::byte*>(vertices.data());
+		const size_t positionOffset = reinterpret_cast<const std::byte*>(&vertices.front().pos) - pBase;
+		return ApplyRemap(mesh, MakeWeldRemap(pBase, sizeof(V), vertices.size(), positionOffset, epsilon));
+	}
+	template<class V, class I>
+	static size_t RemoveUnused(IndexedTriangleList<V, I>& mesh)
+	{
+		return ApplyRemap(mesh, MakeCompactRemap<I>(mesh.indices, mesh.GetVertexCount()));
+	}
+	// returns how many triangles were removed
+	template<class V, class I>
+	static size_t RemoveDegenerate(IndexedTriangleList<V, I>& mesh, float minArea = 0.0f)
+	{
+		const auto& vertices = mesh.GetVertices();
+		const size_t nIndices = RemoveDegenerate<I>(mesh.indices,
+			vertices.empty() ? nullptr : &vertices.front().pos, sizeof(V), minArea);
+		const size_t nRemoved = (mesh.indices.size() - nIndices) / 3u;
+		mesh.indices.resize(nIndices);
+		return nRemoved;
+	}
+	// weld (bitwise, or within epsilon when it is positive), then drop the triangles welding
+	// collapsed and the vertices nothing uses any more
+	template<class V, class I>
+	static void Clean(IndexedTriangleList<V, I>& mesh, float epsilon = 0.0f)
+	{
+		if (epsilon > 0.0f)
+		{
+			Weld(mesh, epsilon);
+		}
+		else
+		{
+			Weld(mesh);
+		}
+		RemoveDegenerate(mesh);
+		RemoveUnused(mesh);
+	}
+};
\ No newline at end of file
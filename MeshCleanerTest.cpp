@@ -0,0 +1,124 @@
+#include "MeshCleanerTest.h"
+#include "MeshCleaner.h"
+#include "Icosphere.h"
+#include <DirectXMath.h>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace dx = DirectX;
+
+namespace
+{
+	struct Vertex
+	{
+		dx::XMFLOAT3 pos;
+	};
+
+	// position plus an attribute the epsilon weld has to match exactly
+	struct TaggedVertex
+	{
+		dx::XMFLOAT3 pos;
+		uint32_t tag;
+	};
+
+	// every corner of the split mesh has to see the position it had before welding
+	bool SameCorners(const IndexedTriangleList<Vertex, unsigned int>& welded, const std::vector<dx::XMFLOAT3>& corners)
+	{
+		const auto& vertices = welded.GetVertices();
+		for (size_t i = 0; i < corners.size(); i++)
+		{
+			const auto& p = vertices[welded.indices[i]].pos;
+			if (p.x != corners[i].x || p.y != corners[i].y || p.z != corners[i].z)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool MeshCleanerTest::WeldSplitIcosphere()
+{
+	constexpr int level = 6;
+	const auto sphere = Icosphere::MakeTesselated<Vertex, unsigned int>(level);
+	IndexedTriangleList<Vertex, unsigned int> split;
+	std::vector<dx::XMFLOAT3> corners;
+	for (const auto i : sphere.indices)
+	{
+		split.indices.push_back((unsigned int)split.GetVertexCount());
+		split.GetVertices().push_back(sphere.GetVertices()[i]);
+		corners.push_back(sphere.GetVertices()[i].pos);
+	}
+	auto bitwise = split;
+	MeshCleaner::Weld(bitwise);
+	auto epsilon = split;
+	MeshCleaner::Weld(epsilon, 1e-6f);
+	return bitwise.GetVertexCount() == Icosphere::VertexCount(level) && SameCorners(bitwise, corners) &&
+		epsilon.GetVertexCount() == Icosphere::VertexCount(level) && SameCorners(epsilon, corners);
+}
+
+bool MeshCleanerTest::EpsilonWeldMatchesBruteForce()
+{
+	// cluster centers 10 epsilon apart on a jittered grid, copies within epsilon / 2 of their
+	// center, so every vertex has exactly one cluster it can go to whatever the probe order
+	constexpr float epsilon = 1e-3f;
+	std::mt19937 rng(7u);
+	std::uniform_real_distribution<float> jitter(-epsilon * 0.25f, epsilon * 0.25f);
+	std::uniform_int_distribution<int> copies(1, 4);
+	std::uniform_int_distribution<uint32_t> tags(0u, 1u);
+	std::vector<TaggedVertex> vertices;
+	for (int x = 0; x < 16; x++)
+	{
+		for (int y = 0; y < 16; y++)
+		{
+			for (int z = 0; z < 8; z++)
+			{
+				const dx::XMFLOAT3 center = {
+					float(x) * epsilon * 10.0f + jitter(rng),
+					float(y) * epsilon * 10.0f + jitter(rng),
+					float(z) * epsilon * 10.0f + jitter(rng)
+				};
+				for (int n = copies(rng); n > 0; n--)
+				{
+					vertices.push_back({ { center.x + jitter(rng),center.y + jitter(rng),center.z + jitter(rng) },tags(rng) });
+				}
+			}
+		}
+	}
+	std::shuffle(vertices.begin(), vertices.end(), rng);
+
+	const auto remap = MeshCleaner::MakeWeldRemap(reinterpret_cast<const std::byte*>(vertices.data()),
+		sizeof(TaggedVertex), vertices.size(), offsetof(TaggedVertex, pos), epsilon);
+
+	// every vertex against every representative kept so far, in order
+	std::vector<uint32_t> representatives;
+	for (size_t v = 0; v < vertices.size(); v++)
+	{
+		const auto& p = vertices[v];
+		uint32_t expected = uint32_t(representatives.size());
+		for (uint32_t r = 0; r < representatives.size(); r++)
+		{
+			const auto& q = vertices[representatives[r]];
+			const float deltaX = p.pos.x - q.pos.x;
+			const float deltaY = p.pos.y - q.pos.y;
+			const float deltaZ = p.pos.z - q.pos.z;
+			if (deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ <= epsilon * epsilon && p.tag == q.tag)
+			{
+				expected = r;
+				break;
+			}
+		}
+		if (expected == representatives.size())
+		{
+			representatives.push_back(uint32_t(v));
+		}
+		if (remap.remap[v] != expected)
+		{
+			return false;
+		}
+	}
+	return remap.nVertices == representatives.size();
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+// weld checks against what the mesh was before it was split, and against a brute-force
+// reference of the epsilon weld; each returns whether the pass matched; run by hw3dtest
+class MeshCleanerTest
+{
+public:
+	// an icosphere split into one vertex per corner comes back to its own vertex count
+	// (and corner positions) through the bitwise and the epsilon weld
+	static bool WeldSplitIcosphere();
+	// jittered clusters of points, some copies with a different attribute: the epsilon weld
+	// gives the same remap as comparing every vertex with every representative
+	static bool EpsilonWeldMatchesBruteForce();
+};
\ No newline at end of file
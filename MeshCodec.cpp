@@ -0,0 +1,522 @@
+#include "MeshCodec.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+#if defined(_XM_SSE_INTRINSICS_)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr uint8_t indexCodecVersion = 0xE1u;
+	constexpr uint8_t vertexCodecVersion = 0xA1u;
+
+	// ------------------------------------------------------------------------------- indices
+
+	// edge fifo slots 0..14 fit the high nibble of a triangle code, 15 marks "no shared edge"
+	constexpr unsigned int edgeFifoSize = 16u;
+	constexpr unsigned int edgeSlots = 15u;
+	constexpr unsigned int noEdge = 15u;
+	// a vertex nibble is 0 for "next new vertex", 1..14 for a vertex fifo slot, 15 for explicit
+	constexpr unsigned int vertexFifoSize = 16u;
+	constexpr unsigned int vertexSlots = 14u;
+	constexpr unsigned int vertexNext = 0u;
+	constexpr unsigned int vertexExplicit = 15u;
+
+	uint32_t ZigZag(int32_t v) noexcept
+	{
+		return (uint32_t(v) << 1u) ^ uint32_t(v >> 31);
+	}
+
+	int32_t UnZigZag(uint32_t v) noexcept
+	{
+		return int32_t(v >> 1u) ^ -int32_t(v & 1u);
+	}
+
+	void WriteVarint(std::vector<std::byte>& out, uint32_t v)
+	{
+		while (v >= 0x80u)
+		{
+			out.push_back(std::byte(v | 0x80u));
+			v >>= 7u;
+		}
+		out.push_back(std::byte(v));
+	}
+
+	bool ReadVarint(const std::byte*& p, const std::byte* end, uint32_t& v) noexcept
+	{
+		v = 0u;
+		for (unsigned int shift = 0u; shift < 35u; shift += 7u)
+		{
+			if (p == end)
+			{
+				return false;
+			}
+			const uint32_t b = uint32_t(*p++);
+			v |= (b & 0x7Fu) << shift;
+			if (b < 0x80u)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// state shared by the encoder and the decoder; both have to update it in lockstep
+	struct IndexCoderState
+	{
+		uint32_t edges[edgeFifoSize][2];
+		uint32_t vertices[vertexFifoSize];
+		unsigned int edgeOffset = 0u;
+		unsigned int edgeCount = 0u;
+		unsigned int vertexOffset = 0u;
+		unsigned int vertexCount = 0u;
+		// next never seen vertex, and the last explicitly coded one
+		uint32_t next = 0u;
+		uint32_t last = 0u;
+
+		void PushEdge(uint32_t a, uint32_t b) noexcept
+		{
+			edges[edgeOffset][0] = a;
+			edges[edgeOffset][1] = b;
+			edgeOffset = (edgeOffset + 1u) % edgeFifoSize;
+			edgeCount = std::min(edgeCount + 1u, edgeFifoSize);
+		}
+		const uint32_t* GetEdge(unsigned int slot) const noexcept
+		{
+			return edges[(edgeOffset + edgeFifoSize - 1u - slot) % edgeFifoSize];
+		}
+		void PushVertex(uint32_t v) noexcept
+		{
+			vertices[vertexOffset] = v;
+			vertexOffset = (vertexOffset + 1u) % vertexFifoSize;
+			vertexCount = std::min(vertexCount + 1u, vertexFifoSize);
+		}
+		uint32_t GetVertex(unsigned int slot) const noexcept
+		{
+			return vertices[(vertexOffset + vertexFifoSize - 1u - slot) % vertexFifoSize];
+		}
+		// a neighbour shares an edge in the opposite direction, so edges go in reversed
+		void PushTriangleEdges(uint32_t a, uint32_t b, uint32_t c, bool includeFirst) noexcept
+		{
+			if (includeFirst)
+			{
+				PushEdge(b, a);
+			}
+			PushEdge(c, b);
+			PushEdge(a, c);
+		}
+	};
+
+	unsigned int EncodeVertex(IndexCoderState& s, uint32_t v, std::vector<std::byte>& explicitData)
+	{
+		if (v == s.next)
+		{
+			s.next++;
+			s.PushVertex(v);
+			return vertexNext;
+		}
+		for (unsigned int i = 0; i < std::min(s.vertexCount, vertexSlots); i++)
+		{
+			if (s.GetVertex(i) == v)
+			{
+				return 1u + i;
+			}
+		}
+		WriteVarint(explicitData, ZigZag(int32_t(v - s.last)));
+		s.last = v;
+		s.PushVertex(v);
+		return vertexExplicit;
+	}
+
+	bool DecodeVertex(IndexCoderState& s, unsigned int code, const std::byte*& p, const std::byte* end, uint32_t& v) noexcept
+	{
+		if (code == vertexNext)
+		{
+			v = s.next++;
+			s.PushVertex(v);
+			return true;
+		}
+		if (code != vertexExplicit)
+		{
+			if (code - 1u >= s.vertexCount)
+			{
+				return false;
+			}
+			v = s.GetVertex(code - 1u);
+			return true;
+		}
+		uint32_t delta;
+		if (!ReadVarint(p, end, delta))
+		{
+			return false;
+		}
+		v = s.last + uint32_t(UnZigZag(delta));
+		s.last = v;
+		s.PushVertex(v);
+		return true;
+	}
+
+	// ------------------------------------------------------------------------------ vertices
+
+	// blocks are sized so that the transposed columns of a block stay in l1
+	constexpr size_t vertexBlockBytes = 8192u;
+	constexpr size_t maxBlockVertices = 256u;
+	constexpr size_t groupSize = 16u;
+
+	size_t GetBlockSize(size_t stride) noexcept
+	{
+		return std::clamp<size_t>((vertexBlockBytes / stride) & ~(groupSize - 1u), groupSize, maxBlockVertices);
+	}
+
+	// 2-bit group header codes -> bits per value
+	constexpr unsigned int groupBits[4] = { 0u,2u,4u,8u };
+
+	uint8_t ZigZag8(uint8_t delta) noexcept
+	{
+		return uint8_t((delta << 1u) ^ uint8_t(int8_t(delta) >> 7));
+	}
+
+	// bit-pack one column of zigzagged deltas (padded to whole groups with zeros)
+	void EncodeColumn(const uint8_t* values, size_t nGroups, std::vector<std::byte>& out)
+	{
+		const size_t headerPos = out.size();
+		out.resize(out.size() + (nGroups + 3u) / 4u, std::byte(0));
+		for (size_t g = 0; g < nGroups; g++)
+		{
+			const uint8_t* group = values + g * groupSize;
+			const uint8_t max = *std::max_element(group, group + groupSize);
+			const unsigned int code = max == 0u ? 0u : max < 4u ? 1u : max < 16u ? 2u : 3u;
+			out[headerPos + g / 4u] |= std::byte(code << ((g % 4u) * 2u));
+			const unsigned int bits = groupBits[code];
+			if (bits == 0u)
+			{
+				continue;
+			}
+			const size_t perByte = 8u / bits;
+			const size_t start = out.size();
+			out.resize(start + groupSize / perByte, std::byte(0));
+			for (size_t j = 0; j < groupSize; j++)
+			{
+				out[start + j / perByte] |= std::byte(group[j] << ((j % perByte) * bits));
+			}
+		}
+	}
+
+#if defined(_XM_SSE_INTRINSICS_)
+	// unpack 16 zigzagged deltas, undo the zigzag and prefix sum them onto the column's last value
+	// (kept splatted across the register so the carry never leaves the simd unit)
+	__m128i DecodeGroup(const std::byte* p, unsigned int code, __m128i& last) noexcept
+	{
+		const __m128i lowBits2 = _mm_set1_epi8(0x03);
+		const __m128i lowBits4 = _mm_set1_epi8(0x0F);
+		__m128i z;
+		switch (code)
+		{
+		case 0u:
+			z = _mm_setzero_si128();
+			break;
+		case 1u:
+		{
+			int32_t packed;
+			std::memcpy(&packed, p, sizeof(packed));
+			const __m128i x = _mm_cvtsi32_si128(packed);
+			const __m128i b0 = _mm_and_si128(x, lowBits2);
+			const __m128i b1 = _mm_and_si128(_mm_srli_epi16(x, 2), lowBits2);
+			const __m128i b2 = _mm_and_si128(_mm_srli_epi16(x, 4), lowBits2);
+			const __m128i b3 = _mm_and_si128(_mm_srli_epi16(x, 6), lowBits2);
+			z = _mm_unpacklo_epi16(_mm_unpacklo_epi8(b0, b1), _mm_unpacklo_epi8(b2, b3));
+			break;
+		}
+		case 2u:
+		{
+			const __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+			z = _mm_unpacklo_epi8(_mm_and_si128(x, lowBits4), _mm_and_si128(_mm_srli_epi16(x, 4), lowBits4));
+			break;
+		}
+		default:
+			z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			break;
+		}
+		const __m128i magnitude = _mm_and_si128(_mm_srli_epi16(z, 1), _mm_set1_epi8(0x7F));
+		const __m128i sign = _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(z, _mm_set1_epi8(0x01)));
+		__m128i v = _mm_xor_si128(magnitude, sign);
+		v = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+		v = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+		v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+		v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+		v = _mm_add_epi8(v, last);
+		last = _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_unpackhi_epi8(v, v), 0xFF), 0xFF);
+		return v;
+	}
+#endif
+
+	// decode one column of a block into values[0 .. nGroups * 16)
+	bool DecodeColumn(const std::byte*& p, const std::byte* end, size_t nGroups, uint8_t& last, uint8_t* values) noexcept
+	{
+		const size_t headerSize = (nGroups + 3u) / 4u;
+		if (size_t(end - p) < headerSize)
+		{
+			return false;
+		}
+		const std::byte* header = p;
+		p += headerSize;
+#if defined(_XM_SSE_INTRINSICS_)
+		__m128i lastSplat = _mm_set1_epi8(char(last));
+#endif
+		for (size_t g = 0; g < nGroups; g++)
+		{
+			const unsigned int code = ((unsigned int)header[g / 4u] >> ((g % 4u) * 2u)) & 3u;
+			const unsigned int bits = groupBits[code];
+			const size_t bytes = bits * groupSize / 8u;
+			if (size_t(end - p) < bytes)
+			{
+				return false;
+			}
+			uint8_t* out = values + g * groupSize;
+#if defined(_XM_SSE_INTRINSICS_)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), DecodeGroup(p, code, lastSplat));
+#else
+			for (size_t j = 0; j < groupSize; j++)
+			{
+				uint8_t z = 0u;
+				if (bits != 0u)
+				{
+					const size_t perByte = 8u / bits;
+					z = uint8_t(((unsigned int)p[j / perByte] >> ((j % perByte) * bits)) & ((1u << bits) - 1u));
+				}
+				last = uint8_t(last + uint8_t((z >> 1u) ^ -(z & 1u)));
+				out[j] = last;
+			}
+#endif
+			p += bytes;
+		}
+#if defined(_XM_SSE_INTRINSICS_)
+		last = uint8_t(_mm_cvtsi128_si32(lastSplat));
+#endif
+		return true;
+	}
+
+	// scatter byte columns (column k of vertex i at columns[k * pitch + i]) back into vertices
+	// sixteen vertices at a time so each tile of output is written in one go
+	void InterleaveColumns(const uint8_t* columns, size_t pitch, size_t stride, size_t nVertices, std::byte* out) noexcept
+	{
+		for (size_t i = 0; i < nVertices; i += groupSize)
+		{
+			const size_t n = std::min(groupSize, nVertices - i);
+			std::byte* tile = out + i * stride;
+			size_t k = 0;
+#if defined(_XM_SSE_INTRINSICS_)
+			// four columns x sixteen vertices -> the same 4-byte piece of sixteen vertices
+			for (; k + 4u <= stride; k += 4u)
+			{
+				const uint8_t* c = columns + k * pitch + i;
+				const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c));
+				const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + pitch));
+				const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + pitch * 2u));
+				const __m128i c3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(c + pitch * 3u));
+				const __m128i t0 = _mm_unpacklo_epi8(c0, c1);
+				const __m128i t1 = _mm_unpackhi_epi8(c0, c1);
+				const __m128i t2 = _mm_unpacklo_epi8(c2, c3);
+				const __m128i t3 = _mm_unpackhi_epi8(c2, c3);
+				alignas(16) uint32_t pieces[groupSize];
+				_mm_store_si128(reinterpret_cast<__m128i*>(pieces + 0), _mm_unpacklo_epi16(t0, t2));
+				_mm_store_si128(reinterpret_cast<__m128i*>(pieces + 4), _mm_unpackhi_epi16(t0, t2));
+				_mm_store_si128(reinterpret_cast<__m128i*>(pieces + 8), _mm_unpacklo_epi16(t1, t3));
+				_mm_store_si128(reinterpret_cast<__m128i*>(pieces + 12), _mm_unpackhi_epi16(t1, t3));
+				for (size_t j = 0; j < n; j++)
+				{
+					std::memcpy(tile + j * stride + k, &pieces[j], sizeof(uint32_t));
+				}
+			}
+#endif
+			for (; k < stride; k++)
+			{
+				for (size_t j = 0; j < n; j++)
+				{
+					tile[j * stride + k] = std::byte(columns[k * pitch + i + j]);
+				}
+			}
+		}
+	}
+}
+
+template<class I>
+std::vector<std::byte> MeshCodec::EncodeIndices(std::span<const I> indices)
+{
+	assert("index count must be a multiple of 3" && indices.size() % 3u == 0u);
+	const size_t nTriangles = indices.size() / 3u;
+	// one code byte per triangle up front, then the variable length data the codes refer to
+	std::vector<std::byte> out;
+	out.reserve(1u + nTriangles * 2u);
+	out.push_back(std::byte(indexCodecVersion));
+	out.resize(1u + nTriangles);
+	std::vector<std::byte> data;
+	IndexCoderState s;
+	for (size_t t = 0; t < nTriangles; t++)
+	{
+		uint32_t tri[3] = { uint32_t(indices[t * 3u]),uint32_t(indices[t * 3u + 1u]),uint32_t(indices[t * 3u + 2u]) };
+		// look for a recent edge this triangle shares, rotating it so that edge comes first
+		unsigned int slot = noEdge;
+		for (unsigned int i = 0; i < std::min(s.edgeCount, edgeSlots) && slot == noEdge; i++)
+		{
+			const uint32_t* e = s.GetEdge(i);
+			for (unsigned int r = 0; r < 3u; r++)
+			{
+				if (tri[r] == e[0] && tri[(r + 1u) % 3u] == e[1])
+				{
+					std::rotate(tri, tri + r, tri + 3);
+					slot = i;
+					break;
+				}
+			}
+		}
+		const auto [a, b, c] = tri;
+		if (slot != noEdge)
+		{
+			const unsigned int vc = EncodeVertex(s, c, data);
+			out[1u + t] = std::byte((slot << 4u) | vc);
+			s.PushTriangleEdges(a, b, c, false);
+		}
+		else
+		{
+			// the nibble byte for a and b goes ahead of any explicitly coded indices
+			const size_t nibblePos = data.size();
+			data.push_back(std::byte(0));
+			const unsigned int va = EncodeVertex(s, a, data);
+			const unsigned int vb = EncodeVertex(s, b, data);
+			const unsigned int vc = EncodeVertex(s, c, data);
+			data[nibblePos] = std::byte((va << 4u) | vb);
+			out[1u + t] = std::byte((noEdge << 4u) | vc);
+			s.PushTriangleEdges(a, b, c, true);
+		}
+	}
+	out.insert(out.end(), data.begin(), data.end());
+	return out;
+}
+
+template<class I>
+bool MeshCodec::DecodeIndices(std::span<I> indices, std::span<const std::byte> data) noexcept
+{
+	if (indices.size() % 3u != 0u)
+	{
+		return false;
+	}
+	const size_t nTriangles = indices.size() / 3u;
+	if (data.size() < 1u + nTriangles || uint8_t(data[0]) != indexCodecVersion)
+	{
+		return false;
+	}
+	const std::byte* codes = data.data() + 1u;
+	const std::byte* p = codes + nTriangles;
+	const std::byte* const end = data.data() + data.size();
+	IndexCoderState s;
+	for (size_t t = 0; t < nTriangles; t++)
+	{
+		const unsigned int code = (unsigned int)codes[t];
+		const unsigned int slot = code >> 4u;
+		uint32_t a, b, c;
+		if (slot != noEdge)
+		{
+			if (slot >= s.edgeCount)
+			{
+				return false;
+			}
+			a = s.GetEdge(slot)[0];
+			b = s.GetEdge(slot)[1];
+			if (!DecodeVertex(s, code & 15u, p, end, c))
+			{
+				return false;
+			}
+			s.PushTriangleEdges(a, b, c, false);
+		}
+		else
+		{
+			if (p == end)
+			{
+				return false;
+			}
+			const unsigned int nibbles = (unsigned int)*p++;
+			if (!DecodeVertex(s, nibbles >> 4u, p, end, a) ||
+				!DecodeVertex(s, nibbles & 15u, p, end, b) ||
+				!DecodeVertex(s, code & 15u, p, end, c))
+			{
+				return false;
+			}
+			s.PushTriangleEdges(a, b, c, true);
+		}
+		indices[t * 3u] = I(a);
+		indices[t * 3u + 1u] = I(b);
+		indices[t * 3u + 2u] = I(c);
+	}
+	return p == end;
+}
+
+std::vector<std::byte> MeshCodec::EncodeVertices(std::span<const std::byte> vertices, size_t stride)
+{
+	assert("vertex stride out of range" && stride > 0u && stride <= maxVertexStride);
+	assert(vertices.size() % stride == 0u);
+	const size_t nVertices = vertices.size() / stride;
+	const size_t blockSize = GetBlockSize(stride);
+	std::vector<std::byte> out;
+	out.reserve(1u + vertices.size() / 2u);
+	out.push_back(std::byte(vertexCodecVersion));
+	std::vector<uint8_t> last(stride, 0u);
+	std::vector<uint8_t> column(blockSize);
+	for (size_t first = 0; first < nVertices; first += blockSize)
+	{
+		const size_t n = std::min(blockSize, nVertices - first);
+		const size_t nGroups = (n + groupSize - 1u) / groupSize;
+		for (size_t k = 0; k < stride; k++)
+		{
+			std::fill(column.begin(), column.end(), uint8_t(0u));
+			for (size_t i = 0; i < n; i++)
+			{
+				const uint8_t v = uint8_t(vertices[(first + i) * stride + k]);
+				column[i] = ZigZag8(uint8_t(v - last[k]));
+				last[k] = v;
+			}
+			EncodeColumn(column.data(), nGroups, out);
+		}
+	}
+	return out;
+}
+
+bool MeshCodec::DecodeVertices(std::span<std::byte> vertices, size_t stride, std::span<const std::byte> data) noexcept
+{
+	if (stride == 0u || stride > maxVertexStride || vertices.size() % stride != 0u ||
+		data.empty() || uint8_t(data[0]) != vertexCodecVersion)
+	{
+		return false;
+	}
+	const size_t nVertices = vertices.size() / stride;
+	const size_t blockSize = GetBlockSize(stride);
+	const std::byte* p = data.data() + 1u;
+	const std::byte* const end = data.data() + data.size();
+	// columns of one block plus the running last value of every column; stride * blockSize
+	// is bounded by vertexBlockBytes (or 256 * 16 for very wide vertices)
+	alignas(16) uint8_t columns[std::max(vertexBlockBytes, maxVertexStride * groupSize)];
+	uint8_t last[maxVertexStride] = {};
+	for (size_t first = 0; first < nVertices; first += blockSize)
+	{
+		const size_t n = std::min(blockSize, nVertices - first);
+		const size_t nGroups = (n + groupSize - 1u) / groupSize;
+		const size_t pitch = nGroups * groupSize;
+		for (size_t k = 0; k < stride; k++)
+		{
+			if (!DecodeColumn(p, end, nGroups, last[k], columns + k * pitch))
+			{
+				return false;
+			}
+		}
+		InterleaveColumns(columns, pitch, stride, n, vertices.data() + first * stride);
+	}
+	return p == end;
+}
+
+template std::vector<std::byte> MeshCodec::EncodeIndices<unsigned short>(std::span<const unsigned short>);
+template std::vector<std::byte> MeshCodec::EncodeIndices<unsigned int>(std::span<const unsigned int>);
+template bool MeshCodec::DecodeIndices<unsigned short>(std::span<unsigned short>, std::span<const std::byte>) noexcept;
+template bool MeshCodec::DecodeIndices<unsigned int>(std::span<unsigned int>, std::span<const std::byte>) noexcept;
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <span>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+
+// compressed vertex and index streams of one mesh
+struct EncodedMesh
+{
+	std::vector<std::byte> vertexData;
+	std::vector<std::byte> indexData;
+	size_t vertexStride = 0u;
+	size_t nVertices = 0u;
+	size_t nIndices = 0u;
+};
+
+// lossless geometry codec for shipping and caching meshes, small enough on disk that reading
+// it and decoding beats reading the raw buffers
+// indices: every triangle is coded against a fifo of recently seen edges and a fifo of recently
+//   seen vertices, so a vertex cache + fetch optimized stream costs little more than a byte per
+//   triangle. triangles can come back rotated (winding is preserved)
+// vertices: each block of vertices is transposed into byte columns, delta coded against the
+//   previous vertex, zigzagged and bit-packed 16 values at a time; quantized attributes in
+//   fetch order compress best. decoding runs on sse2 where DirectXMath does
+// index-level work is instantiated for 16-bit and 32-bit indices in MeshCodec.cpp
+class MeshCodec
+{
+public:
+	static constexpr size_t maxVertexStride = 256u;
+public:
+	template<class I>
+	static std::vector<std::byte> EncodeIndices(std::span<const I> indices);
+	// false if data is malformed or doesn't hold exactly indices.size() indices
+	template<class I>
+	static bool DecodeIndices(std::span<I> indices, std::span<const std::byte> data) noexcept;
+	static std::vector<std::byte> EncodeVertices(std::span<const std::byte> vertices, size_t stride);
+	// false if data is malformed or doesn't hold exactly vertices.size() / stride vertices
+	static bool DecodeVertices(std::span<std::byte> vertices, size_t stride, std::span<const std::byte> data) noexcept;
+
+	template<class V, class I>
+	static EncodedMesh Encode(const IndexedTriangleList<V, I>& mesh)
+	{
+		static_assert(std::is_trivially_copyable_v<V>, "MeshCodec needs trivially copyable vertices");
+		assert("apply or take the pending transform first" && !mesh.HasPendingTransform());
+		EncodedMesh encoded;
+		encoded.vertexData = EncodeVertices(std::as_bytes(std::span(mesh.GetVertices())), sizeof(V));
+		encoded.indexData = EncodeIndices<I>(mesh.indices);
+		encoded.vertexStride = sizeof(V);
+		encoded.nVertices = mesh.GetVertexCount();
+		encoded.nIndices = mesh.indices.size();
+		return encoded;
+	}
+	template<class V, class I>
+	static IndexedTriangleList<V, I> Decode(const EncodedMesh& encoded,
+		std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		static_assert(std::is_trivially_copyable_v<V>, "MeshCodec needs trivially copyable vertices");
+		if (encoded.vertexStride != sizeof(V))
+		{
+			throw std::invalid_argument("MeshCodec: vertex stride does not match vertex type");
+		}
+		IndexedTriangleList<V, I>::CheckIndexRange(encoded.nVertices);
+		IndexedTriangleList<V, I> mesh(pMem);
+		auto& vertices = mesh.GetVertices();
+		vertices.resize(encoded.nVertices);
+		mesh.indices.resize(encoded.nIndices);
+		if (!DecodeVertices(std::as_writable_bytes(std::span(vertices)), sizeof(V), encoded.vertexData) ||
+			!DecodeIndices<I>(mesh.indices, encoded.indexData))
+		{
+			throw std::runtime_error("MeshCodec: malformed mesh data");
+		}
+		return mesh;
+	}
+};
\ No newline at end of file
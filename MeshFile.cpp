@@ -0,0 +1,374 @@
+#include "MeshFile.h"
+#include "Window.h"
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+#define MESHFILE_EXCEPT( note ) MeshFile::Exception( __LINE__,__FILE__,path,(note) )
+#define MESHFILE_LAST_EXCEPT( note ) MeshFile::Exception( __LINE__,__FILE__,path,(note),GetLastError() )
+
+// the on-disk structs must not change size behind the version number's back
+static_assert(sizeof(MeshFileHeader) == 144u);
+static_assert(offsetof(MeshFileHeader, flags) == MeshFileHeader::version1Size);
+static_assert(sizeof(MeshFileElement) == 32u);
+static_assert(sizeof(MeshFileLod) == 8u);
+
+namespace
+{
+	constexpr uint64_t sectionAlignment = 16u;
+
+	uint64_t AlignSection(uint64_t offset) noexcept
+	{
+		return (offset + sectionAlignment - 1u) & ~(sectionAlignment - 1u);
+	}
+}
+
+MeshFile::Exception::Exception(int line, const char* file, std::wstring path, std::string note, DWORD errorCode) noexcept
+	:
+	ChiliException(line, file),
+	path(std::move(path)),
+	note(std::move(note)),
+	errorCode(errorCode)
+{
+}
+
+const char* MeshFile::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Mesh] " << std::filesystem::path(path).string() << std::endl
+		<< "[Note] " << note << std::endl;
+	if (errorCode != ERROR_SUCCESS)
+	{
+		oss << "[Error Code] " << errorCode << std::endl
+			<< "[Description] " << Window::Exception::TranslateErrorCode(HRESULT_FROM_WIN32(errorCode)) << std::endl;
+	}
+	oss << GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* MeshFile::Exception::GetType() const noexcept
+{
+	return "Chili Mesh File Exception";
+}
+
+const std::string& MeshFile::Exception::GetNote() const noexcept
+{
+	return note;
+}
+
+MeshFile::MeshFile(const std::wstring& path)
+{
+	// the only pass over the data is the driver copying it into gpu buffers, front to back
+	hFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		throw MESHFILE_LAST_EXCEPT("Failed to open mesh file");
+	}
+	try
+	{
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(hFile, &size))
+		{
+			throw MESHFILE_LAST_EXCEPT("Failed to query mesh file size");
+		}
+		if (uint64_t(size.QuadPart) < MeshFileHeader::version1Size)
+		{
+			throw MESHFILE_EXCEPT("File is too small to be a mesh file");
+		}
+		hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0u, 0u, nullptr);
+		if (hMapping == nullptr)
+		{
+			throw MESHFILE_LAST_EXCEPT("Failed to create file mapping");
+		}
+		pBase = static_cast<const std::byte*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0u, 0u, 0u));
+		if (pBase == nullptr)
+		{
+			throw MESHFILE_LAST_EXCEPT("Failed to map view of mesh file");
+		}
+
+		// only the header and the small tables are inspected, uncompressed bulk data is never touched here
+		auto& h = header;
+		const uint64_t fileSize = uint64_t(size.QuadPart);
+		std::memcpy(&h, pBase, MeshFileHeader::version1Size);
+		if (h.magic != MeshFileHeader::fourCC)
+		{
+			throw MESHFILE_EXCEPT("Not a mesh file (bad magic)");
+		}
+		if (h.version == 0u || h.version > MeshFileHeader::currentVersion)
+		{
+			throw MESHFILE_EXCEPT("Unsupported mesh file version " + std::to_string(h.version));
+		}
+		size_t headerSize = MeshFileHeader::version1Size;
+		if (h.version >= 2u)
+		{
+			headerSize = sizeof(MeshFileHeader);
+			if (fileSize < headerSize)
+			{
+				throw MESHFILE_EXCEPT("File is too small to be a mesh file");
+			}
+			std::memcpy(&h, pBase, headerSize);
+		}
+		else
+		{
+			h.vertexBytes = uint64_t(h.nVertices) * h.vertexStride;
+			h.indexBytes = uint64_t(h.nIndices) * h.indexSize;
+		}
+		const bool vertsCompressed = (h.flags & MeshFileHeader::compressedVertices) != 0u;
+		const bool indicesCompressed = (h.flags & MeshFileHeader::compressedIndices) != 0u;
+		if (h.fileSize != fileSize)
+		{
+			throw MESHFILE_EXCEPT("Mesh file size does not match header (truncated?)");
+		}
+		if (h.indexSize != 2u && h.indexSize != 4u)
+		{
+			throw MESHFILE_EXCEPT("Bad index size");
+		}
+		const auto checkSection = [&](uint64_t offset, uint64_t bytes, const char* name)
+		{
+			if (offset % sectionAlignment != 0u || offset < headerSize ||
+				offset > fileSize || bytes > fileSize - offset)
+			{
+				throw MESHFILE_EXCEPT(std::string("Bad ") + name + " section");
+			}
+		};
+		checkSection(h.elementOffset, uint64_t(h.nElements) * sizeof(MeshFileElement), "layout");
+		checkSection(h.lodOffset, uint64_t(h.nLods) * sizeof(MeshFileLod), "lod");
+		if ((!vertsCompressed && h.vertexBytes != uint64_t(h.nVertices) * h.vertexStride) ||
+			(!indicesCompressed && h.indexBytes != uint64_t(h.nIndices) * h.indexSize))
+		{
+			throw MESHFILE_EXCEPT("Section size does not match its contents");
+		}
+		checkSection(h.vertexOffset, h.vertexBytes, "vertex");
+		checkSection(h.indexOffset, h.indexBytes, "index");
+		const auto pElements = reinterpret_cast<const MeshFileElement*>(pBase + h.elementOffset);
+		for (uint32_t i = 0; i < h.nElements; i++)
+		{
+			const auto& e = pElements[i];
+			if (std::memchr(e.semanticName, '\0', sizeof(e.semanticName)) == nullptr || e.alignedByteOffset >= h.vertexStride)
+			{
+				throw MESHFILE_EXCEPT("Bad vertex layout element");
+			}
+		}
+		if (h.nLods == 0u)
+		{
+			throw MESHFILE_EXCEPT("Mesh file has no index ranges");
+		}
+		for (uint32_t i = 0; i < h.nLods; i++)
+		{
+			const auto& lod = GetLods()[i];
+			if (uint64_t(lod.firstIndex) + lod.nIndices > h.nIndices || lod.nIndices % 3u != 0u)
+			{
+				throw MESHFILE_EXCEPT("Bad lod index range");
+			}
+		}
+
+		pVertices = pBase + h.vertexOffset;
+		pIndices = pBase + h.indexOffset;
+		if (vertsCompressed)
+		{
+			vertexStorage.resize(size_t(h.nVertices) * h.vertexStride);
+			if (!MeshCodec::DecodeVertices(vertexStorage, h.vertexStride, { pVertices,size_t(h.vertexBytes) }))
+			{
+				throw MESHFILE_EXCEPT("Corrupt compressed vertex section");
+			}
+			pVertices = vertexStorage.data();
+		}
+		if (indicesCompressed)
+		{
+			// the codec only checks that the stream is well formed, the indices need a range check too
+			const auto decode = [&](auto* pOut)
+			{
+				using I = std::remove_pointer_t<decltype(pOut)>;
+				const std::span<I> indices(pOut, h.nIndices);
+				return MeshCodec::DecodeIndices<I>(indices, { pIndices,size_t(h.indexBytes) }) &&
+					std::all_of(indices.begin(), indices.end(), [&h](I i) { return i < h.nVertices; });
+			};
+			indexStorage.resize(size_t(h.nIndices) * h.indexSize);
+			const bool decoded = h.indexSize == sizeof(uint16_t) ?
+				decode(reinterpret_cast<uint16_t*>(indexStorage.data())) :
+				decode(reinterpret_cast<uint32_t*>(indexStorage.data()));
+			if (!decoded)
+			{
+				throw MESHFILE_EXCEPT("Corrupt compressed index section");
+			}
+			pIndices = indexStorage.data();
+		}
+	}
+	catch (...)
+	{
+		Close();
+		throw;
+	}
+}
+
+MeshFile::~MeshFile()
+{
+	Close();
+}
+
+void MeshFile::Close() noexcept
+{
+	if (pBase != nullptr)
+	{
+		UnmapViewOfFile(pBase);
+		pBase = nullptr;
+	}
+	if (hMapping != nullptr)
+	{
+		CloseHandle(hMapping);
+		hMapping = nullptr;
+	}
+	if (hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+	}
+}
+
+UINT MeshFile::GetVertexStride() const noexcept
+{
+	return header.vertexStride;
+}
+
+size_t MeshFile::GetVertexCount() const noexcept
+{
+	return header.nVertices;
+}
+
+std::span<const std::byte> MeshFile::GetVertexData() const noexcept
+{
+	return { pVertices,size_t(header.nVertices) * header.vertexStride };
+}
+
+UINT MeshFile::GetIndexSize() const noexcept
+{
+	return header.indexSize;
+}
+
+size_t MeshFile::GetLodCount() const noexcept
+{
+	return header.nLods;
+}
+
+std::vector<D3D11_INPUT_ELEMENT_DESC> MeshFile::GetInputLayout() const
+{
+	const auto pElements = reinterpret_cast<const MeshFileElement*>(pBase + header.elementOffset);
+	std::vector<D3D11_INPUT_ELEMENT_DESC> ied;
+	ied.reserve(header.nElements);
+	for (uint32_t i = 0; i < header.nElements; i++)
+	{
+		const auto& e = pElements[i];
+		ied.push_back({ e.semanticName,e.semanticIndex,DXGI_FORMAT(e.format),0,e.alignedByteOffset,D3D11_INPUT_PER_VERTEX_DATA,0 });
+	}
+	return ied;
+}
+
+DirectX::XMFLOAT3 MeshFile::GetBoundsMin() const noexcept
+{
+	return header.boundsMin;
+}
+
+DirectX::XMFLOAT3 MeshFile::GetBoundsMax() const noexcept
+{
+	return header.boundsMax;
+}
+
+PositionDequantization MeshFile::GetDequantization() const noexcept
+{
+	return { header.dequantizationScale,header.dequantizationOffset };
+}
+
+const MeshFileLod* MeshFile::GetLods() const noexcept
+{
+	return reinterpret_cast<const MeshFileLod*>(pBase + header.lodOffset);
+}
+
+void MeshFile::Write(const std::wstring& path, const Contents& contents)
+{
+	assert(contents.vertexStride > 0u && contents.vertexData.size() % contents.vertexStride == 0u);
+	assert(contents.indexSize == 2u || contents.indexSize == 4u);
+	MeshFileHeader h = {};
+	h.magic = MeshFileHeader::fourCC;
+	h.version = MeshFileHeader::currentVersion;
+	h.vertexStride = contents.vertexStride;
+	h.nVertices = uint32_t(contents.vertexData.size() / contents.vertexStride);
+	h.indexSize = contents.indexSize;
+	h.nIndices = uint32_t(contents.indexData.size() / contents.indexSize);
+	h.nElements = uint32_t(contents.layout.size());
+	h.nLods = uint32_t(contents.lods.size());
+	h.boundsMin = contents.boundsMin;
+	h.boundsMax = contents.boundsMax;
+	h.dequantizationScale = contents.dequantization.scale;
+	h.dequantizationOffset = contents.dequantization.offset;
+
+	std::span<const std::byte> vertexSection = contents.vertexData;
+	std::span<const std::byte> indexSection = contents.indexData;
+	std::vector<std::byte> encodedVertices;
+	std::vector<std::byte> encodedIndices;
+	if (contents.compress)
+	{
+		if (contents.vertexStride <= MeshCodec::maxVertexStride)
+		{
+			encodedVertices = MeshCodec::EncodeVertices(contents.vertexData, contents.vertexStride);
+			vertexSection = encodedVertices;
+			h.flags |= MeshFileHeader::compressedVertices;
+		}
+		// all lods are whole triangles, so the concatenated index section codes as one stream
+		encodedIndices = contents.indexSize == sizeof(uint16_t) ?
+			MeshCodec::EncodeIndices<uint16_t>({ reinterpret_cast<const uint16_t*>(contents.indexData.data()),h.nIndices }) :
+			MeshCodec::EncodeIndices<uint32_t>({ reinterpret_cast<const uint32_t*>(contents.indexData.data()),h.nIndices });
+		indexSection = encodedIndices;
+		h.flags |= MeshFileHeader::compressedIndices;
+	}
+	h.vertexBytes = vertexSection.size();
+	h.indexBytes = indexSection.size();
+	h.elementOffset = AlignSection(sizeof(MeshFileHeader));
+	h.lodOffset = AlignSection(h.elementOffset + h.nElements * sizeof(MeshFileElement));
+	h.vertexOffset = AlignSection(h.lodOffset + h.nLods * sizeof(MeshFileLod));
+	h.indexOffset = AlignSection(h.vertexOffset + h.vertexBytes);
+	h.fileSize = h.indexOffset + h.indexBytes;
+
+	std::vector<MeshFileElement> elements(contents.layout.size());
+	for (size_t i = 0; i < elements.size(); i++)
+	{
+		const auto& desc = contents.layout[i];
+		auto& e = elements[i];
+		e = {};
+		const size_t nameLength = std::strlen(desc.SemanticName);
+		if (nameLength >= sizeof(e.semanticName))
+		{
+			throw MESHFILE_EXCEPT(std::string("Semantic name too long: ") + desc.SemanticName);
+		}
+		std::memcpy(e.semanticName, desc.SemanticName, nameLength + 1u);
+		e.semanticIndex = desc.SemanticIndex;
+		e.format = uint32_t(desc.Format);
+		e.alignedByteOffset = desc.AlignedByteOffset;
+	}
+
+	std::ofstream file(std::filesystem::path(path), std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		throw MESHFILE_EXCEPT("Failed to create mesh file");
+	}
+	const auto put = [&file](uint64_t offset, const void* pData, size_t bytes)
+	{
+		static constexpr char zeros[sectionAlignment] = {};
+		file.write(zeros, std::streamsize(offset - uint64_t(file.tellp())));
+		file.write(static_cast<const char*>(pData), std::streamsize(bytes));
+	};
+	file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	put(h.elementOffset, elements.data(), elements.size() * sizeof(MeshFileElement));
+	put(h.lodOffset, contents.lods.data(), contents.lods.size_bytes());
+	put(h.vertexOffset, vertexSection.data(), vertexSection.size());
+	put(h.indexOffset, indexSection.data(), indexSection.size());
+	if (!file)
+	{
+		throw MESHFILE_EXCEPT("Failed to write mesh file");
+	}
+}
\ No newline at end of file
@@ -0,0 +1,225 @@
+#pragma once
+#include "ChiliWin.h"
+#include "ChiliException.h"
+#include "IndexedTriangleList.h"
+#include "VertexQuantizer.h"
+#include "MeshCodec.h"
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <span>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+
+// binary mesh container, little endian, every section 16-byte aligned:
+// [MeshFileHeader][MeshFileElement * nElements][MeshFileLod * nLods][vertices][indices]
+// the vertex and index sections are exactly what goes into the gpu buffers, so a loaded
+// file hands out spans over its mapped pages and there is nothing to parse
+// (version 2) either section can instead hold a MeshCodec stream, decoded once at load
+struct MeshFileHeader
+{
+	static constexpr uint32_t fourCC = 'H' | ('W' << 8) | ('M' << 16) | ('F' << 24);
+	// bump when the layout changes; readers reject versions newer than they know
+	static constexpr uint32_t currentVersion = 2u;
+	// version 1 headers end at indexOffset
+	static constexpr size_t version1Size = 120u;
+	static constexpr uint32_t compressedVertices = 1u << 0u;
+	static constexpr uint32_t compressedIndices = 1u << 1u;
+	uint32_t magic;
+	uint32_t version;
+	uint64_t fileSize;
+	uint32_t vertexStride;
+	uint32_t nVertices;
+	// 2 or 4 bytes, all lods share one index section
+	uint32_t indexSize;
+	uint32_t nIndices;
+	uint32_t nElements;
+	uint32_t nLods;
+	DirectX::XMFLOAT3 boundsMin;
+	DirectX::XMFLOAT3 boundsMax;
+	DirectX::XMFLOAT3 dequantizationScale;
+	DirectX::XMFLOAT3 dequantizationOffset;
+	uint64_t elementOffset;
+	uint64_t lodOffset;
+	uint64_t vertexOffset;
+	uint64_t indexOffset;
+	// version 2
+	uint32_t flags;
+	uint32_t reserved;
+	// bytes of the vertex / index sections as stored
+	uint64_t vertexBytes;
+	uint64_t indexBytes;
+};
+
+// one D3D11_INPUT_ELEMENT_DESC with the semantic name stored inline
+struct MeshFileElement
+{
+	char semanticName[20];
+	uint32_t semanticIndex;
+	uint32_t format;
+	uint32_t alignedByteOffset;
+};
+
+// index range of one level of detail, level 0 is the full mesh
+struct MeshFileLod
+{
+	uint32_t firstIndex;
+	uint32_t nIndices;
+};
+
+class MeshFile
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::wstring path, std::string note, DWORD errorCode = ERROR_SUCCESS) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::wstring path;
+		std::string note;
+		DWORD errorCode;
+	};
+	// everything the writer needs, as raw bytes
+	struct Contents
+	{
+		std::span<const std::byte> vertexData;
+		UINT vertexStride = 0u;
+		std::span<const D3D11_INPUT_ELEMENT_DESC> layout;
+		std::span<const std::byte> indexData;
+		UINT indexSize = 0u;
+		std::span<const MeshFileLod> lods;
+		DirectX::XMFLOAT3 boundsMin = { 0.0f,0.0f,0.0f };
+		DirectX::XMFLOAT3 boundsMax = { 0.0f,0.0f,0.0f };
+		PositionDequantization dequantization;
+		// store both sections MeshCodec compressed
+		bool compress = false;
+	};
+public:
+	// maps the file read-only and validates the header; spans stay valid for the lifetime
+	// of the MeshFile. compressed sections are decoded here, uncompressed ones are never touched
+	MeshFile(const std::wstring& path);
+	MeshFile(const MeshFile&) = delete;
+	MeshFile& operator=(const MeshFile&) = delete;
+	~MeshFile();
+	UINT GetVertexStride() const noexcept;
+	size_t GetVertexCount() const noexcept;
+	std::span<const std::byte> GetVertexData() const noexcept;
+	UINT GetIndexSize() const noexcept;
+	size_t GetLodCount() const noexcept;
+	template<class I>
+	std::span<const I> GetIndices(size_t lod = 0u) const noexcept
+	{
+		assert("MeshFile index type mismatch" && sizeof(I) == header.indexSize);
+		assert(lod < header.nLods);
+		const auto& range = GetLods()[lod];
+		return { reinterpret_cast<const I*>(pIndices) + range.firstIndex,range.nIndices };
+	}
+	// semantic names point into the mapping
+	std::vector<D3D11_INPUT_ELEMENT_DESC> GetInputLayout() const;
+	DirectX::XMFLOAT3 GetBoundsMin() const noexcept;
+	DirectX::XMFLOAT3 GetBoundsMax() const noexcept;
+	PositionDequantization GetDequantization() const noexcept;
+
+	static void Write(const std::wstring& path, const Contents& contents);
+	// lods are index streams over the mesh's vertices (e.g. from MeshSimplifier::MakeLodChain),
+	// mesh.indices is written as the only level when none are given
+	template<class V, class I>
+	static void Write(const std::wstring& path, const IndexedTriangleList<V, I>& mesh,
+		std::span<const D3D11_INPUT_ELEMENT_DESC> layout, std::type_identity_t<std::span<const std::pmr::vector<I>>> lods = {},
+		bool compress = false)
+	{
+		assert("apply or take the pending transform first" && !mesh.HasPendingTransform());
+		Contents contents;
+		contents.compress = compress;
+		contents.vertexData = std::as_bytes(std::span(mesh.GetVertices()));
+		contents.vertexStride = UINT(sizeof(V));
+		contents.layout = layout;
+		const auto box = mesh.GetBounds().box;
+		contents.boundsMin = box.min;
+		contents.boundsMax = box.max;
+		WriteWithIndices<I>(path, contents, mesh.GetVertexCount(), mesh.indices, lods);
+	}
+	template<class I>
+	static void Write(const std::wstring& path, const QuantizedVertices& vertices,
+		const std::pmr::vector<I>& indices, std::type_identity_t<std::span<const std::pmr::vector<I>>> lods = {},
+		bool compress = false)
+	{
+		Contents contents;
+		contents.compress = compress;
+		contents.vertexData = vertices.data;
+		contents.vertexStride = vertices.format.GetStride();
+		const auto layout = vertices.format.GetInputLayout();
+		contents.layout = layout;
+		contents.boundsMin = vertices.bounds.min;
+		contents.boundsMax = vertices.bounds.max;
+		contents.dequantization = vertices.dequantization;
+		WriteWithIndices<I>(path, contents, vertices.nVertices, indices, lods);
+	}
+private:
+	// concatenate the lods into one index section, narrowed to 16 bits when the vertex count allows
+	template<class I>
+	static void WriteWithIndices(const std::wstring& path, Contents& contents, size_t nVertices,
+		std::span<const I> indices, std::span<const std::pmr::vector<I>> lods)
+	{
+		std::vector<MeshFileLod> ranges;
+		size_t nIndices = 0u;
+		if (lods.empty())
+		{
+			ranges.push_back({ 0u,uint32_t(indices.size()) });
+			nIndices = indices.size();
+		}
+		for (const auto& lod : lods)
+		{
+			ranges.push_back({ uint32_t(nIndices),uint32_t(lod.size()) });
+			nIndices += lod.size();
+		}
+		const auto gather = [&](auto* pOut)
+		{
+			using Out = std::remove_pointer_t<decltype(pOut)>;
+			if (lods.empty())
+			{
+				pOut = std::transform(indices.begin(), indices.end(), pOut, [](I i) { return Out(i); });
+			}
+			for (const auto& lod : lods)
+			{
+				pOut = std::transform(lod.begin(), lod.end(), pOut, [](I i) { return Out(i); });
+			}
+		};
+		std::vector<std::byte> indexData;
+		if (nVertices <= 0x10000u)
+		{
+			indexData.resize(nIndices * sizeof(uint16_t));
+			gather(reinterpret_cast<uint16_t*>(indexData.data()));
+			contents.indexSize = sizeof(uint16_t);
+		}
+		else
+		{
+			indexData.resize(nIndices * sizeof(uint32_t));
+			gather(reinterpret_cast<uint32_t*>(indexData.data()));
+			contents.indexSize = sizeof(uint32_t);
+		}
+		contents.indexData = indexData;
+		contents.lods = ranges;
+		Write(path, contents);
+	}
+	const MeshFileLod* GetLods() const noexcept;
+	void Close() noexcept;
+private:
+	HANDLE hFile = INVALID_HANDLE_VALUE;
+	HANDLE hMapping = nullptr;
+	const std::byte* pBase = nullptr;
+	// copied out so version 1 headers read with the version 2 fields zeroed
+	MeshFileHeader header = {};
+	// into the mapping, or into the decoded storage for compressed sections
+	const std::byte* pVertices = nullptr;
+	const std::byte* pIndices = nullptr;
+	std::vector<std::byte> vertexStorage;
+	std::vector<std::byte> indexStorage;
+};
\ No newline at end of file
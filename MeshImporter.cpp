@@ -0,0 +1,1169 @@
+#include "MeshImporter.h"
+#include "ParallelFor.h"
+#include "StreamTransform.h"
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <charconv>
+#include <string_view>
+#include <stdexcept>
+#include <algorithm>
+#include <thread>
+#include <limits>
+#include <type_traits>
+#include <iterator>
+#include <cstring>
+#include <cwctype>
+#include <cassert>
+
+#define IMPORT_EXCEPT( note ) MeshImporter::Exception( __LINE__,__FILE__,path,(note) )
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr size_t chunkSize = 16u * 1024u * 1024u;
+	// a chunk is only split into as many pieces as keeps each piece at least this big
+	constexpr size_t minPieceSize = 256u * 1024u;
+	constexpr size_t minParallelRecords = 16u * 1024u;
+	constexpr int32_t missingIndex = std::numeric_limits<int32_t>::min();
+
+	// thrown from parser threads, turned into MeshImporter::Exception (which knows the path) on the caller
+	class ParseError : public std::runtime_error
+	{
+		using std::runtime_error::runtime_error;
+	};
+
+	// sliding window over a file that is read in large blocks
+	class ChunkReader
+	{
+	public:
+		ChunkReader(const std::wstring& path)
+			:
+			file(std::filesystem::path(path), std::ios::binary),
+			buffer(chunkSize)
+		{
+		}
+		bool IsOpen() const noexcept
+		{
+			return file.is_open();
+		}
+		// drop the first `consumed` bytes of the window and top it up from the file; a window that
+		// is full without anything consumed (a line longer than a chunk) grows instead
+		std::string_view Advance(size_t consumed)
+		{
+			assert(consumed <= size);
+			std::memmove(buffer.data(), buffer.data() + consumed, size - consumed);
+			size -= consumed;
+			if (size == buffer.size())
+			{
+				buffer.resize(buffer.size() * 2u);
+			}
+			if (!eof)
+			{
+				file.read(buffer.data() + size, std::streamsize(buffer.size() - size));
+				size += size_t(file.gcount());
+				eof = file.eof();
+			}
+			return { buffer.data(),size };
+		}
+		bool AtEnd() const noexcept
+		{
+			return eof;
+		}
+	private:
+		std::ifstream file;
+		std::vector<char> buffer;
+		size_t size = 0u;
+		bool eof = false;
+	};
+
+	// hand complete lines to process() one window at a time
+	template<class F>
+	void ForEachLineBlock(ChunkReader& reader, size_t consumed, F&& process)
+	{
+		for (;;)
+		{
+			const auto window = reader.Advance(consumed);
+			size_t end = window.size();
+			if (!reader.AtEnd())
+			{
+				const auto nl = window.rfind('\n');
+				if (nl == std::string_view::npos)
+				{
+					consumed = 0u;
+					continue;
+				}
+				end = nl + 1u;
+			}
+			if (end > 0u)
+			{
+				process(window.substr(0u, end));
+			}
+			if (reader.AtEnd())
+			{
+				return;
+			}
+			consumed = end;
+		}
+	}
+
+	// split text into pieces that end on line boundaries, one per hardware thread at most
+	void SplitLines(std::string_view text, std::vector<std::string_view>& pieces)
+	{
+		const size_t nPieces = std::clamp<size_t>(text.size() / minPieceSize, 1u,
+			std::max(std::thread::hardware_concurrency(), 1u));
+		pieces.clear();
+		size_t begin = 0u;
+		for (size_t i = 1; i <= nPieces && begin < text.size(); i++)
+		{
+			size_t end = text.size();
+			if (i < nPieces)
+			{
+				end = text.find('\n', std::max(text.size() * i / nPieces, begin));
+				end = end == std::string_view::npos ? text.size() : end + 1u;
+			}
+			pieces.push_back(text.substr(begin, end - begin));
+			begin = end;
+		}
+	}
+
+	// cursor over a single line of text, numbers go through std::from_chars (no locale, no allocation)
+	class LineCursor
+	{
+	public:
+		LineCursor(const char* p, const char* end) noexcept
+			:
+			p(p),
+			end(end)
+		{
+		}
+		void SkipSpace() noexcept
+		{
+			while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+			{
+				p++;
+			}
+		}
+		bool AtEnd() noexcept
+		{
+			SkipSpace();
+			return p == end;
+		}
+		// at a token boundary, e.g. after a keyword
+		bool AtSeparator() const noexcept
+		{
+			return p == end || *p == ' ' || *p == '\t' || *p == '\r';
+		}
+		bool Consume(char c) noexcept
+		{
+			if (p < end && *p == c)
+			{
+				p++;
+				return true;
+			}
+			return false;
+		}
+		template<class T>
+		bool Number(T& value) noexcept
+		{
+			SkipSpace();
+			Consume('+');
+			if constexpr (std::is_integral_v<T>)
+			{
+				// indices dominate face lines, a plain digit loop beats the general from_chars
+				const bool negative = std::is_signed_v<T> && Consume('-');
+				const char* const first = p;
+				T magnitude = T(0);
+				while (p < end && unsigned(*p - '0') < 10u)
+				{
+					magnitude = magnitude * T(10) + T(*p++ - '0');
+				}
+				value = negative ? T(0) - magnitude : magnitude;
+				return p != first;
+			}
+			const auto [next, ec] = std::from_chars(p, end, value);
+			if (next == p)
+			{
+				return false;
+			}
+			// denormals and the like come back out of range, flush them rather than failing
+			if (ec == std::errc::result_out_of_range)
+			{
+				value = T(0);
+			}
+			p = next;
+			return true;
+		}
+		template<class T>
+		T Expect()
+		{
+			T value;
+			if (!Number(value))
+			{
+				throw ParseError("Expected a number");
+			}
+			return value;
+		}
+		void SkipToken() noexcept
+		{
+			SkipSpace();
+			while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+			{
+				p++;
+			}
+		}
+	private:
+		const char* p;
+		const char* end;
+	};
+
+	template<class F>
+	void ForEachLine(std::string_view text, F&& f)
+	{
+		const char* p = text.data();
+		const char* const end = text.data() + text.size();
+		while (p < end)
+		{
+			const char* nl = static_cast<const char*>(std::memchr(p, '\n', size_t(end - p)));
+			const char* lineEnd = nl ? nl : end;
+			f(p, lineEnd);
+			p = lineEnd + 1;
+		}
+	}
+
+	// right-handed (obj / ply convention) to the left-handed space the renderer uses:
+	// mirror z, flip the winding and put the texture origin at the top left
+	void ConvertToLeftHanded(ImportedMesh& mesh)
+	{
+		const auto mirror = dx::XMMatrixScaling(1.0f, 1.0f, -1.0f);
+		StreamTransform::Points(mesh.positions.data(), sizeof(dx::XMFLOAT3), mesh.positions.size(), mirror);
+		StreamTransform::Normals(mesh.normals.data(), sizeof(dx::XMFLOAT3), mesh.normals.size(), mirror);
+		ParallelFor(mesh.texcoords.size(), minParallelRecords, [&mesh](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				mesh.texcoords[i].y = 1.0f - mesh.texcoords[i].y;
+			}
+		});
+		for (size_t i = 0; i + 2u < mesh.indices.size(); i += 3u)
+		{
+			std::swap(mesh.indices[i + 1u], mesh.indices[i + 2u]);
+		}
+	}
+
+	// ---------------------------------------------------------------------------------- obj
+
+	struct ObjCorner
+	{
+		int32_t p;
+		int32_t t;
+		int32_t n;
+		// bit per index: negative obj index, stored relative to the piece's first element
+		uint8_t relative;
+	};
+
+	struct ObjPiece
+	{
+		std::vector<dx::XMFLOAT3> positions;
+		std::vector<dx::XMFLOAT4> colors;
+		std::vector<dx::XMFLOAT3> normals;
+		std::vector<dx::XMFLOAT2> texcoords;
+		std::vector<ObjCorner> corners;
+		bool hasColors = false;
+		void Clear() noexcept
+		{
+			positions.clear();
+			colors.clear();
+			normals.clear();
+			texcoords.clear();
+			corners.clear();
+			hasColors = false;
+		}
+	};
+
+	void ParseObjPiece(std::string_view text, ObjPiece& out)
+	{
+		ForEachLine(text, [&out](const char* begin, const char* end)
+		{
+			LineCursor line(begin, end);
+			line.SkipSpace();
+			if (line.Consume('v'))
+			{
+				if (line.Consume('n'))
+				{
+					const float x = line.Expect<float>();
+					const float y = line.Expect<float>();
+					out.normals.push_back({ x,y,line.Expect<float>() });
+				}
+				else if (line.Consume('t'))
+				{
+					const float u = line.Expect<float>();
+					float v = 0.0f;
+					line.Number(v);
+					out.texcoords.push_back({ u,v });
+				}
+				else if (line.AtSeparator())
+				{
+					const float x = line.Expect<float>();
+					const float y = line.Expect<float>();
+					out.positions.push_back({ x,y,line.Expect<float>() });
+					// what follows is told apart by count: w, r g b (common extension) or w r g b
+					float extra[5];
+					size_t nExtra = 0u;
+					while (nExtra < std::size(extra) && line.Number(extra[nExtra]))
+					{
+						nExtra++;
+					}
+					dx::XMFLOAT4 color = { 1.0f,1.0f,1.0f,1.0f };
+					switch (nExtra)
+					{
+					case 0u:
+					case 1u:
+						break;
+					case 3u:
+					case 4u:
+						color.x = extra[nExtra - 3u];
+						color.y = extra[nExtra - 2u];
+						color.z = extra[nExtra - 1u];
+						out.hasColors = true;
+						break;
+					default:
+						throw ParseError("Vertex takes 3, 4, 6 or 7 numbers");
+					}
+					out.colors.push_back(color);
+				}
+			}
+			else if (line.Consume('f') && line.AtSeparator())
+			{
+				const auto resolve = [](int64_t raw, size_t count, uint8_t bit, uint8_t& relative)
+				{
+					if (raw > 0)
+					{
+						return int32_t(raw - 1);
+					}
+					if (raw < 0)
+					{
+						relative |= bit;
+						return int32_t(int64_t(count) + raw);
+					}
+					throw ParseError("Face index 0 is not valid in obj");
+				};
+				ObjCorner first = {};
+				ObjCorner previous = {};
+				size_t nCorners = 0u;
+				while (!line.AtEnd())
+				{
+					ObjCorner c = { missingIndex,missingIndex,missingIndex,0u };
+					c.p = resolve(line.Expect<int64_t>(), out.positions.size(), 1u, c.relative);
+					if (line.Consume('/'))
+					{
+						int64_t raw;
+						if (line.Number(raw))
+						{
+							c.t = resolve(raw, out.texcoords.size(), 2u, c.relative);
+						}
+						if (line.Consume('/'))
+						{
+							c.n = resolve(line.Expect<int64_t>(), out.normals.size(), 4u, c.relative);
+						}
+					}
+					if (nCorners == 0u)
+					{
+						first = c;
+					}
+					else if (nCorners >= 2u)
+					{
+						out.corners.push_back(first);
+						out.corners.push_back(previous);
+						out.corners.push_back(c);
+					}
+					previous = c;
+					nCorners++;
+				}
+			}
+		});
+	}
+
+	// key for welding: indices of the attributes that are in use, missing ones as missingIndex
+	struct CornerKey
+	{
+		int32_t p;
+		int32_t t;
+		int32_t n;
+		bool operator==(const CornerKey& rhs) const noexcept
+		{
+			return p == rhs.p && t == rhs.t && n == rhs.n;
+		}
+	};
+
+	// ---------------------------------------------------------------------------------- ply
+
+	enum class PlyType : unsigned char
+	{
+		Int8,
+		UInt8,
+		Int16,
+		UInt16,
+		Int32,
+		UInt32,
+		Float32,
+		Float64,
+	};
+
+	size_t PlySize(PlyType t) noexcept
+	{
+		constexpr size_t sizes[] = { 1u,1u,2u,2u,4u,4u,4u,8u };
+		return sizes[size_t(t)];
+	}
+
+	PlyType ParsePlyType(std::string_view name)
+	{
+		struct Entry
+		{
+			std::string_view name;
+			PlyType type;
+		};
+		static constexpr Entry table[] = {
+			{ "char",PlyType::Int8 },{ "int8",PlyType::Int8 },
+			{ "uchar",PlyType::UInt8 },{ "uint8",PlyType::UInt8 },
+			{ "short",PlyType::Int16 },{ "int16",PlyType::Int16 },
+			{ "ushort",PlyType::UInt16 },{ "uint16",PlyType::UInt16 },
+			{ "int",PlyType::Int32 },{ "int32",PlyType::Int32 },
+			{ "uint",PlyType::UInt32 },{ "uint32",PlyType::UInt32 },
+			{ "float",PlyType::Float32 },{ "float32",PlyType::Float32 },
+			{ "double",PlyType::Float64 },{ "float64",PlyType::Float64 },
+		};
+		for (const auto& e : table)
+		{
+			if (e.name == name)
+			{
+				return e.type;
+			}
+		}
+		throw ParseError("Unknown ply property type " + std::string(name));
+	}
+
+	// vertex attribute a ply property feeds
+	enum class PlySlot : unsigned char
+	{
+		None,
+		X, Y, Z,
+		NX, NY, NZ,
+		U, V,
+		R, G, B, A,
+	};
+
+	PlySlot ParsePlySlot(std::string_view name) noexcept
+	{
+		struct Entry
+		{
+			std::string_view name;
+			PlySlot slot;
+		};
+		static constexpr Entry table[] = {
+			{ "x",PlySlot::X },{ "y",PlySlot::Y },{ "z",PlySlot::Z },
+			{ "nx",PlySlot::NX },{ "ny",PlySlot::NY },{ "nz",PlySlot::NZ },
+			{ "u",PlySlot::U },{ "v",PlySlot::V },{ "s",PlySlot::U },{ "t",PlySlot::V },
+			{ "texture_u",PlySlot::U },{ "texture_v",PlySlot::V },
+			{ "texture_s",PlySlot::U },{ "texture_t",PlySlot::V },
+			{ "red",PlySlot::R },{ "green",PlySlot::G },{ "blue",PlySlot::B },{ "alpha",PlySlot::A },
+			{ "diffuse_red",PlySlot::R },{ "diffuse_green",PlySlot::G },{ "diffuse_blue",PlySlot::B },
+		};
+		for (const auto& e : table)
+		{
+			if (e.name == name)
+			{
+				return e.slot;
+			}
+		}
+		return PlySlot::None;
+	}
+
+	struct PlyProperty
+	{
+		PlyType type;
+		PlyType countType;
+		bool isList;
+		PlySlot slot;
+		bool isFaceIndices;
+	};
+
+	struct PlyElement
+	{
+		std::string name;
+		size_t count;
+		std::vector<PlyProperty> properties;
+		bool IsFixedSize() const noexcept
+		{
+			return std::none_of(properties.begin(), properties.end(), [](const PlyProperty& p) { return p.isList; });
+		}
+		size_t GetFixedSize() const noexcept
+		{
+			size_t size = 0u;
+			for (const auto& p : properties)
+			{
+				size += PlySize(p.type);
+			}
+			return size;
+		}
+	};
+
+	enum class PlyFormat
+	{
+		Ascii,
+		BinaryLittleEndian,
+		BinaryBigEndian,
+	};
+
+	struct PlyHeader
+	{
+		PlyFormat format = PlyFormat::Ascii;
+		std::vector<PlyElement> elements;
+		size_t size = 0u;
+	};
+
+	PlyHeader ParsePlyHeader(std::string_view text)
+	{
+		PlyHeader header;
+		size_t pos = 0u;
+		bool first = true;
+		for (;;)
+		{
+			const size_t nl = text.find('\n', pos);
+			if (nl == std::string_view::npos)
+			{
+				throw ParseError("Ply header is not terminated");
+			}
+			auto line = text.substr(pos, nl - pos);
+			pos = nl + 1u;
+			if (!line.empty() && line.back() == '\r')
+			{
+				line.remove_suffix(1u);
+			}
+			// whitespace separated words of the line, no allocation
+			std::string_view words[6];
+			size_t nWords = 0u;
+			for (size_t i = 0; i < line.size() && nWords < std::size(words);)
+			{
+				const size_t start = line.find_first_not_of(" \t", i);
+				if (start == std::string_view::npos)
+				{
+					break;
+				}
+				const size_t stop = std::min(line.find_first_of(" \t", start), line.size());
+				words[nWords++] = line.substr(start, stop - start);
+				i = stop;
+			}
+			if (first)
+			{
+				if (nWords != 1u || words[0] != "ply")
+				{
+					throw ParseError("Not a ply file");
+				}
+				first = false;
+				continue;
+			}
+			if (nWords == 0u || words[0] == "comment" || words[0] == "obj_info")
+			{
+				continue;
+			}
+			if (words[0] == "end_header")
+			{
+				header.size = pos;
+				return header;
+			}
+			if (words[0] == "format" && nWords >= 2u)
+			{
+				if (words[1] == "ascii")
+				{
+					header.format = PlyFormat::Ascii;
+				}
+				else if (words[1] == "binary_little_endian")
+				{
+					header.format = PlyFormat::BinaryLittleEndian;
+				}
+				else if (words[1] == "binary_big_endian")
+				{
+					header.format = PlyFormat::BinaryBigEndian;
+				}
+				else
+				{
+					throw ParseError("Unknown ply format " + std::string(words[1]));
+				}
+			}
+			else if (words[0] == "element" && nWords >= 3u)
+			{
+				size_t count = 0u;
+				std::from_chars(words[2].data(), words[2].data() + words[2].size(), count);
+				header.elements.push_back({ std::string(words[1]),count,{} });
+			}
+			else if (words[0] == "property" && !header.elements.empty())
+			{
+				auto& element = header.elements.back();
+				PlyProperty p = {};
+				if (nWords >= 5u && words[1] == "list")
+				{
+					p.isList = true;
+					p.countType = ParsePlyType(words[2]);
+					p.type = ParsePlyType(words[3]);
+					p.isFaceIndices = element.name == "face" && (words[4] == "vertex_indices" || words[4] == "vertex_index");
+				}
+				else if (nWords >= 3u)
+				{
+					p.type = ParsePlyType(words[1]);
+					p.slot = element.name == "vertex" ? ParsePlySlot(words[2]) : PlySlot::None;
+				}
+				else
+				{
+					throw ParseError("Malformed ply property");
+				}
+				element.properties.push_back(p);
+			}
+			else
+			{
+				throw ParseError("Unexpected ply header line");
+			}
+		}
+	}
+
+	template<class T>
+	T LoadScalar(const char* p, bool swap) noexcept
+	{
+		unsigned char bytes[sizeof(T)];
+		std::memcpy(bytes, p, sizeof(T));
+		if (swap)
+		{
+			std::reverse(std::begin(bytes), std::end(bytes));
+		}
+		T value;
+		std::memcpy(&value, bytes, sizeof(T));
+		return value;
+	}
+
+	double ReadPlyBinary(const char* p, PlyType type, bool swap) noexcept
+	{
+		switch (type)
+		{
+		case PlyType::Int8:
+			return double(LoadScalar<int8_t>(p, swap));
+		case PlyType::UInt8:
+			return double(LoadScalar<uint8_t>(p, swap));
+		case PlyType::Int16:
+			return double(LoadScalar<int16_t>(p, swap));
+		case PlyType::UInt16:
+			return double(LoadScalar<uint16_t>(p, swap));
+		case PlyType::Int32:
+			return double(LoadScalar<int32_t>(p, swap));
+		case PlyType::UInt32:
+			return double(LoadScalar<uint32_t>(p, swap));
+		case PlyType::Float32:
+			return double(LoadScalar<float>(p, swap));
+		default:
+			return LoadScalar<double>(p, swap);
+		}
+	}
+
+	// integer color channels are normalized by their type's range
+	float PlyColorScale(PlyType type) noexcept
+	{
+		switch (type)
+		{
+		case PlyType::UInt8:
+			return 1.0f / 255.0f;
+		case PlyType::UInt16:
+			return 1.0f / 65535.0f;
+		default:
+			return 1.0f;
+		}
+	}
+
+	// destination streams for ply vertices, written in place by record index
+	struct PlyVertexSink
+	{
+		ImportedMesh& mesh;
+		bool normals;
+		bool texcoords;
+		bool colors;
+		void Store(size_t i, const PlyProperty& p, double value) const noexcept
+		{
+			const float f = float(value);
+			switch (p.slot)
+			{
+			case PlySlot::X: mesh.positions[i].x = f; break;
+			case PlySlot::Y: mesh.positions[i].y = f; break;
+			case PlySlot::Z: mesh.positions[i].z = f; break;
+			case PlySlot::NX: if (normals) mesh.normals[i].x = f; break;
+			case PlySlot::NY: if (normals) mesh.normals[i].y = f; break;
+			case PlySlot::NZ: if (normals) mesh.normals[i].z = f; break;
+			case PlySlot::U: if (texcoords) mesh.texcoords[i].x = f; break;
+			case PlySlot::V: if (texcoords) mesh.texcoords[i].y = f; break;
+			case PlySlot::R: if (colors) mesh.colors[i].x = f * PlyColorScale(p.type); break;
+			case PlySlot::G: if (colors) mesh.colors[i].y = f * PlyColorScale(p.type); break;
+			case PlySlot::B: if (colors) mesh.colors[i].z = f * PlyColorScale(p.type); break;
+			case PlySlot::A: if (colors) mesh.colors[i].w = f * PlyColorScale(p.type); break;
+			default: break;
+			}
+		}
+	};
+
+	// fan-triangulate one polygon into the index list
+	template<class Get>
+	void EmitPolygon(std::vector<uint32_t>& indices, size_t nCorners, size_t nVertices, Get&& get)
+	{
+		if (nCorners < 3u)
+		{
+			return;
+		}
+		const uint32_t first = get(0u);
+		uint32_t previous = get(1u);
+		for (size_t k = 2u; k < nCorners; k++)
+		{
+			const uint32_t current = get(k);
+			if (first >= nVertices || previous >= nVertices || current >= nVertices)
+			{
+				throw ParseError("Face index out of range");
+			}
+			indices.push_back(first);
+			indices.push_back(previous);
+			indices.push_back(current);
+			previous = current;
+		}
+	}
+
+	// binary cursor over the reader window that refills as records are consumed
+	class BinaryCursor
+	{
+	public:
+		BinaryCursor(ChunkReader& reader, std::string_view window, size_t start)
+			:
+			reader(reader),
+			window(window),
+			pos(start)
+		{
+		}
+		// make sure n bytes are available at Data()
+		void Require(size_t n)
+		{
+			while (window.size() - pos < n)
+			{
+				if (reader.AtEnd())
+				{
+					throw ParseError("Unexpected end of ply data");
+				}
+				window = reader.Advance(pos);
+				pos = 0u;
+			}
+		}
+		size_t Available() const noexcept
+		{
+			return window.size() - pos;
+		}
+		const char* Data() const noexcept
+		{
+			return window.data() + pos;
+		}
+		void Skip(size_t n) noexcept
+		{
+			pos += n;
+		}
+	private:
+		ChunkReader& reader;
+		std::string_view window;
+		size_t pos;
+	};
+}
+
+MeshImporter::Exception::Exception(int line, const char* file, std::wstring path, std::string note) noexcept
+	:
+	ChiliException(line, file),
+	path(std::move(path)),
+	note(std::move(note))
+{
+}
+
+const char* MeshImporter::Exception::what() const noexcept
+{
+	std::ostringstream oss;
+	oss << GetType() << std::endl
+		<< "[Mesh] " << std::filesystem::path(path).string() << std::endl
+		<< "[Note] " << note << std::endl
+		<< GetOriginString();
+	whatBuffer = oss.str();
+	return whatBuffer.c_str();
+}
+
+const char* MeshImporter::Exception::GetType() const noexcept
+{
+	return "Chili Mesh Import Exception";
+}
+
+const std::string& MeshImporter::Exception::GetNote() const noexcept
+{
+	return note;
+}
+
+ImportedMesh MeshImporter::LoadObj(const std::wstring& path, const ImportOptions& options)
+{
+	ChunkReader reader(path);
+	if (!reader.IsOpen())
+	{
+		throw IMPORT_EXCEPT("Failed to open obj file");
+	}
+	// everything in file order; piece buffers are reused from chunk to chunk
+	ObjPiece all;
+	std::vector<ObjPiece> pieces;
+	std::vector<std::string_view> text;
+	try
+	{
+		ForEachLineBlock(reader, 0u, [&](std::string_view block)
+		{
+			SplitLines(block, text);
+			if (pieces.size() < text.size())
+			{
+				pieces.resize(text.size());
+			}
+			ParallelFor(text.size(), 1u, [&](size_t first, size_t last)
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					pieces[i].Clear();
+					ParseObjPiece(text[i], pieces[i]);
+				}
+			});
+			for (size_t i = 0; i < text.size(); i++)
+			{
+				auto& piece = pieces[i];
+				const int32_t pBase = int32_t(all.positions.size());
+				const int32_t tBase = int32_t(all.texcoords.size());
+				const int32_t nBase = int32_t(all.normals.size());
+				std::transform(piece.corners.begin(), piece.corners.end(), std::back_inserter(all.corners),
+					[=](ObjCorner c)
+					{
+						c.p += (c.relative & 1u) ? pBase : 0;
+						c.t += (c.relative & 2u) ? tBase : 0;
+						c.n += (c.relative & 4u) ? nBase : 0;
+						return c;
+					}
+				);
+				all.positions.insert(all.positions.end(), piece.positions.begin(), piece.positions.end());
+				all.colors.insert(all.colors.end(), piece.colors.begin(), piece.colors.end());
+				all.normals.insert(all.normals.end(), piece.normals.begin(), piece.normals.end());
+				all.texcoords.insert(all.texcoords.end(), piece.texcoords.begin(), piece.texcoords.end());
+				all.hasColors = all.hasColors || piece.hasColors;
+			}
+		});
+	}
+	catch (const ParseError& e)
+	{
+		throw IMPORT_EXCEPT(e.what());
+	}
+
+	// weld identical (position, texcoord, normal) tuples into single vertices
+	const bool useTexcoords = options.texcoords && !all.texcoords.empty();
+	const bool useNormals = options.normals && !all.normals.empty();
+	const bool useColors = options.colors && all.hasColors;
+	ImportedMesh mesh;
+	mesh.indices.reserve(all.corners.size());
+	// the position index is a perfect hash for the tuple: every bucket chains the few vertices
+	// that share a position, and faces touch positions in roughly file order so the buckets
+	// stay in cache where a hash over the whole tuple would miss on nearly every corner
+	constexpr uint32_t endOfChain = std::numeric_limits<uint32_t>::max();
+	std::vector<CornerKey> keys;
+	std::vector<uint32_t> chain;
+	std::vector<uint32_t> buckets(all.positions.size(), endOfChain);
+	keys.reserve(all.positions.size());
+	chain.reserve(all.positions.size());
+	for (const auto& c : all.corners)
+	{
+		const auto inRange = [](int32_t i, size_t count) { return i >= 0 && size_t(i) < count; };
+		const CornerKey key = { c.p,useTexcoords ? c.t : missingIndex,useNormals ? c.n : missingIndex };
+		if (!inRange(key.p, all.positions.size()) ||
+			(key.t != missingIndex && !inRange(key.t, all.texcoords.size())) ||
+			(key.n != missingIndex && !inRange(key.n, all.normals.size())))
+		{
+			throw IMPORT_EXCEPT("Face index out of range");
+		}
+		uint32_t i = buckets[key.p];
+		while (i != endOfChain && !(keys[i] == key))
+		{
+			i = chain[i];
+		}
+		if (i == endOfChain)
+		{
+			i = uint32_t(keys.size());
+			keys.push_back(key);
+			chain.push_back(buckets[key.p]);
+			buckets[key.p] = i;
+		}
+		mesh.indices.push_back(i);
+	}
+
+	mesh.positions.resize(keys.size());
+	mesh.normals.resize(useNormals ? keys.size() : 0u);
+	mesh.texcoords.resize(useTexcoords ? keys.size() : 0u);
+	mesh.colors.resize(useColors ? keys.size() : 0u);
+	ParallelFor(keys.size(), minParallelRecords, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			const auto& k = keys[i];
+			mesh.positions[i] = all.positions[k.p];
+			if (useNormals)
+			{
+				mesh.normals[i] = k.n != missingIndex ? all.normals[k.n] : dx::XMFLOAT3{ 0.0f,0.0f,0.0f };
+			}
+			if (useTexcoords)
+			{
+				mesh.texcoords[i] = k.t != missingIndex ? all.texcoords[k.t] : dx::XMFLOAT2{ 0.0f,0.0f };
+			}
+			if (useColors)
+			{
+				mesh.colors[i] = all.colors[k.p];
+			}
+		}
+	});
+	if (options.convertToLeftHanded)
+	{
+		ConvertToLeftHanded(mesh);
+	}
+	return mesh;
+}
+
+ImportedMesh MeshImporter::LoadPly(const std::wstring& path, const ImportOptions& options)
+{
+	ChunkReader reader(path);
+	if (!reader.IsOpen())
+	{
+		throw IMPORT_EXCEPT("Failed to open ply file");
+	}
+	ImportedMesh mesh;
+	try
+	{
+		auto window = reader.Advance(0u);
+		while (window.find("end_header") == std::string_view::npos && !reader.AtEnd())
+		{
+			window = reader.Advance(0u);
+		}
+		const auto header = ParsePlyHeader(window);
+		const auto iVertexElement = std::find_if(header.elements.begin(), header.elements.end(),
+			[](const PlyElement& e) { return e.name == "vertex"; }) - header.elements.begin();
+		if (size_t(iVertexElement) == header.elements.size())
+		{
+			throw ParseError("Ply file has no vertex element");
+		}
+		const auto& vertexElement = header.elements[iVertexElement];
+		const size_t nVertices = vertexElement.count;
+		const auto has = [&vertexElement](PlySlot a, PlySlot b)
+		{
+			return std::any_of(vertexElement.properties.begin(), vertexElement.properties.end(),
+				[a, b](const PlyProperty& p) { return p.slot >= a && p.slot <= b; });
+		};
+		// ply vertices are already one record per unique vertex, so there is nothing to weld
+		const PlyVertexSink sink = {
+			mesh,
+			options.normals && has(PlySlot::NX, PlySlot::NZ),
+			options.texcoords && has(PlySlot::U, PlySlot::V),
+			options.colors && has(PlySlot::R, PlySlot::A)
+		};
+		mesh.positions.resize(nVertices, { 0.0f,0.0f,0.0f });
+		mesh.normals.resize(sink.normals ? nVertices : 0u, { 0.0f,0.0f,0.0f });
+		mesh.texcoords.resize(sink.texcoords ? nVertices : 0u, { 0.0f,0.0f });
+		mesh.colors.resize(sink.colors ? nVertices : 0u, { 1.0f,1.0f,1.0f,1.0f });
+
+		if (header.format == PlyFormat::Ascii)
+		{
+			// line ranges of the elements, in file order
+			std::vector<size_t> elementStart;
+			size_t nLines = 0u;
+			for (const auto& e : header.elements)
+			{
+				elementStart.push_back(nLines);
+				nLines += e.count;
+			}
+			std::vector<std::string_view> text;
+			std::vector<size_t> pieceLine;
+			std::vector<std::vector<uint32_t>> pieceIndices;
+			size_t blockLine = 0u;
+			ForEachLineBlock(reader, header.size, [&](std::string_view block)
+			{
+				SplitLines(block, text);
+				pieceLine.assign(text.size() + 1u, 0u);
+				pieceIndices.resize(std::max(pieceIndices.size(), text.size()));
+				ParallelFor(text.size(), 1u, [&](size_t first, size_t last)
+				{
+					for (size_t i = first; i < last; i++)
+					{
+						pieceLine[i + 1u] = size_t(std::count(text[i].begin(), text[i].end(), '\n'));
+					}
+				});
+				pieceLine[0] = blockLine;
+				for (size_t i = 0; i < text.size(); i++)
+				{
+					pieceLine[i + 1u] += pieceLine[i];
+				}
+				ParallelFor(text.size(), 1u, [&](size_t first, size_t last)
+				{
+					for (size_t i = first; i < last; i++)
+					{
+						auto& indices = pieceIndices[i];
+						indices.clear();
+						size_t lineNumber = pieceLine[i];
+						ForEachLine(text[i], [&](const char* begin, const char* end)
+						{
+							const size_t iLine = lineNumber++;
+							if (iLine >= nLines)
+							{
+								return;
+							}
+							const size_t iElement = size_t(std::upper_bound(elementStart.begin(), elementStart.end(), iLine) - elementStart.begin()) - 1u;
+							const auto& element = header.elements[iElement];
+							LineCursor line(begin, end);
+							for (const auto& p : element.properties)
+							{
+								if (p.isList)
+								{
+									const size_t n = line.Expect<size_t>();
+									if (p.isFaceIndices)
+									{
+										// corners go through a small fixed buffer, larger polygons are rare
+										uint32_t corners[64];
+										if (n > std::size(corners))
+										{
+											throw ParseError("Ply polygon has too many corners");
+										}
+										for (size_t k = 0; k < n; k++)
+										{
+											corners[k] = line.Expect<uint32_t>();
+										}
+										EmitPolygon(indices, n, nVertices, [&corners](size_t k) { return corners[k]; });
+									}
+									else
+									{
+										for (size_t k = 0; k < n; k++)
+										{
+											line.SkipToken();
+										}
+									}
+								}
+								else if (iElement == size_t(iVertexElement))
+								{
+									sink.Store(iLine - elementStart[iElement], p, line.Expect<double>());
+								}
+								else
+								{
+									line.SkipToken();
+								}
+							}
+						});
+					}
+				});
+				for (size_t i = 0; i < text.size(); i++)
+				{
+					mesh.indices.insert(mesh.indices.end(), pieceIndices[i].begin(), pieceIndices[i].end());
+				}
+				blockLine = pieceLine[text.size()];
+			});
+		}
+		else
+		{
+			const bool swap = header.format == PlyFormat::BinaryBigEndian;
+			BinaryCursor cursor(reader, window, header.size);
+			for (size_t iElement = 0; iElement < header.elements.size(); iElement++)
+			{
+				const auto& element = header.elements[iElement];
+				const bool isVertex = iElement == size_t(iVertexElement);
+				if (element.IsFixedSize())
+				{
+					// fixed size records: decode whatever the window holds across all threads
+					const size_t recordSize = element.GetFixedSize();
+					for (size_t done = 0; done < element.count;)
+					{
+						cursor.Require(recordSize);
+						const size_t batch = std::min(element.count - done, cursor.Available() / recordSize);
+						if (isVertex)
+						{
+							const char* const pData = cursor.Data();
+							ParallelFor(batch, minParallelRecords, [&](size_t first, size_t last)
+							{
+								for (size_t r = first; r < last; r++)
+								{
+									const char* p = pData + r * recordSize;
+									for (const auto& prop : element.properties)
+									{
+										sink.Store(done + r, prop, ReadPlyBinary(p, prop.type, swap));
+										p += PlySize(prop.type);
+									}
+								}
+							});
+						}
+						cursor.Skip(batch * recordSize);
+						done += batch;
+					}
+					continue;
+				}
+				// records with lists are walked one at a time
+				uint32_t corners[64];
+				for (size_t r = 0; r < element.count; r++)
+				{
+					for (const auto& prop : element.properties)
+					{
+						if (!prop.isList)
+						{
+							cursor.Require(PlySize(prop.type));
+							if (isVertex)
+							{
+								sink.Store(r, prop, ReadPlyBinary(cursor.Data(), prop.type, swap));
+							}
+							cursor.Skip(PlySize(prop.type));
+							continue;
+						}
+						cursor.Require(PlySize(prop.countType));
+						const size_t n = size_t(ReadPlyBinary(cursor.Data(), prop.countType, swap));
+						cursor.Skip(PlySize(prop.countType));
+						const size_t itemSize = PlySize(prop.type);
+						cursor.Require(n * itemSize);
+						if (prop.isFaceIndices)
+						{
+							if (n > std::size(corners))
+							{
+								throw ParseError("Ply polygon has too many corners");
+							}
+							for (size_t k = 0; k < n; k++)
+							{
+								corners[k] = uint32_t(ReadPlyBinary(cursor.Data() + k * itemSize, prop.type, swap));
+							}
+							EmitPolygon(mesh.indices, n, nVertices, [&corners](size_t k) { return corners[k]; });
+						}
+						cursor.Skip(n * itemSize);
+					}
+				}
+			}
+		}
+	}
+	catch (const ParseError& e)
+	{
+		throw IMPORT_EXCEPT(e.what());
+	}
+	if (options.convertToLeftHanded)
+	{
+		ConvertToLeftHanded(mesh);
+	}
+	return mesh;
+}
+
+ImportedMesh MeshImporter::Load(const std::wstring& path, const ImportOptions& options)
+{
+	auto extension = std::filesystem::path(path).extension().wstring();
+	std::transform(extension.begin(), extension.end(), extension.begin(),
+		[](wchar_t c) { return wchar_t(std::towlower(c)); });
+	if (extension == L".obj")
+	{
+		return LoadObj(path, options);
+	}
+	if (extension == L".ply")
+	{
+		return LoadPly(path, options);
+	}
+	throw IMPORT_EXCEPT("Unsupported mesh file extension");
+}
\ No newline at end of file
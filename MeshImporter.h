@@ -0,0 +1,101 @@
+#pragma once
+#include "ChiliWin.h"
+#include "ChiliException.h"
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <vector>
+#include <string>
+#include <concepts>
+#include <cstdint>
+
+// which attributes besides position to import; attributes that are not asked for are
+// left out of the vertex welding key so they can't split vertices
+struct ImportOptions
+{
+	bool normals = false;
+	bool texcoords = false;
+	bool colors = false;
+	// obj and ply are right-handed with counter-clockwise front faces; mirror z, flip the
+	// winding and the v coordinate so the mesh renders as authored
+	bool convertToLeftHanded = true;
+};
+
+// welded mesh as parallel attribute streams, one entry per unique vertex
+// streams that weren't requested (or aren't in the file) are empty
+struct ImportedMesh
+{
+	std::vector<DirectX::XMFLOAT3> positions;
+	std::vector<DirectX::XMFLOAT3> normals;
+	std::vector<DirectX::XMFLOAT2> texcoords;
+	std::vector<DirectX::XMFLOAT4> colors;
+	std::vector<uint32_t> indices;
+};
+
+// streaming Wavefront OBJ and Stanford PLY (ascii / binary) importers
+// files are read in large chunks, each chunk is split at line (or record) boundaries
+// and parsed on all hardware threads; polygons are triangulated as fans
+class MeshImporter
+{
+public:
+	class Exception : public ChiliException
+	{
+	public:
+		Exception(int line, const char* file, std::wstring path, std::string note) noexcept;
+		const char* what() const noexcept override;
+		const char* GetType() const noexcept override;
+		const std::string& GetNote() const noexcept;
+	private:
+		std::wstring path;
+		std::string note;
+	};
+public:
+	static ImportedMesh LoadObj(const std::wstring& path, const ImportOptions& options);
+	static ImportedMesh LoadPly(const std::wstring& path, const ImportOptions& options);
+	// picks the importer from the file extension
+	static ImportedMesh Load(const std::wstring& path, const ImportOptions& options);
+	// fills V::pos plus V::n (XMFLOAT3), V::tc (XMFLOAT2) and V::color (XMFLOAT4) when V has them
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Load(const std::wstring& path,
+		std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		constexpr bool hasNormal = requires(V v) { { v.n } -> std::convertible_to<DirectX::XMFLOAT3&>; };
+		constexpr bool hasTexcoord = requires(V v) { { v.tc } -> std::convertible_to<DirectX::XMFLOAT2&>; };
+		constexpr bool hasColor = requires(V v) { { v.color } -> std::convertible_to<DirectX::XMFLOAT4&>; };
+		const auto imported = Load(path, { hasNormal,hasTexcoord,hasColor });
+
+		IndexedTriangleList<V, I>::CheckIndexRange(imported.positions.size());
+		IndexedTriangleList<V, I> mesh(pMem);
+		mesh.Reserve(imported.positions.size(), imported.indices.size());
+		for (size_t i = 0; i < imported.positions.size(); i++)
+		{
+			auto& v = mesh.GetVertices().emplace_back();
+			v.pos = imported.positions[i];
+			if constexpr (hasNormal)
+			{
+				if (!imported.normals.empty())
+				{
+					v.n = imported.normals[i];
+				}
+			}
+			if constexpr (hasTexcoord)
+			{
+				if (!imported.texcoords.empty())
+				{
+					v.tc = imported.texcoords[i];
+				}
+			}
+			if constexpr (hasColor)
+			{
+				if (!imported.colors.empty())
+				{
+					v.color = imported.colors[i];
+				}
+			}
+		}
+		for (const auto i : imported.indices)
+		{
+			mesh.indices.push_back((I)i);
+		}
+		return mesh;
+	}
+};
\ No newline at end of file
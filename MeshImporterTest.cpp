@@ -0,0 +1,90 @@
+#include "MeshImporterTest.h"
+#include "MeshImporter.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace
+{
+	// file in the temp directory that lives as long as the object
+	class TempFile
+	{
+	public:
+		TempFile(const char* name, const std::string& text)
+			:
+			path(std::filesystem::temp_directory_path() / name)
+		{
+			std::ofstream(path, std::ios::binary) << text;
+		}
+		TempFile(const TempFile&) = delete;
+		TempFile& operator=(const TempFile&) = delete;
+		~TempFile()
+		{
+			std::error_code error;
+			std::filesystem::remove(path, error);
+		}
+		std::wstring GetPath() const
+		{
+			return path.wstring();
+		}
+	private:
+		std::filesystem::path path;
+	};
+
+	bool Near(float a, float b) noexcept
+	{
+		return a - b < 1e-6f && b - a < 1e-6f;
+	}
+}
+
+bool MeshImporterTest::ObjHomogeneousVertex()
+{
+	const TempFile file("hw3d_obj_w.obj", "v 0 0 0 1\nv 1 0 0 1\nv 0 1 0 0.5\nf 1 2 3\n");
+	const auto mesh = MeshImporter::LoadObj(file.GetPath(), { false,false,true,false });
+	return mesh.positions.size() == 3u && mesh.indices.size() == 3u && mesh.colors.empty() &&
+		Near(mesh.positions[1].x, 1.0f) && Near(mesh.positions[2].y, 1.0f);
+}
+
+bool MeshImporterTest::ObjVertexColors()
+{
+	const TempFile file("hw3d_obj_rgb.obj", "v 0 0 0 1 0 0\nv 1 0 0 0 1 0\nv 0 1 0 1 0 0 1\nf 1 2 3\n");
+	const auto mesh = MeshImporter::LoadObj(file.GetPath(), { false,false,true,false });
+	if (mesh.positions.size() != 3u || mesh.colors.size() != 3u)
+	{
+		return false;
+	}
+	for (size_t i = 0; i < 3u; i++)
+	{
+		const auto& p = mesh.positions[i];
+		const auto& c = mesh.colors[i];
+		// welding keeps the first-seen order, so look vertices up by position
+		const bool red = Near(p.x, 0.0f) && Near(p.y, 0.0f);
+		const bool green = Near(p.x, 1.0f);
+		const bool blue = Near(p.y, 1.0f);
+		if ((red && !(Near(c.x, 1.0f) && Near(c.y, 0.0f) && Near(c.z, 0.0f))) ||
+			(green && !(Near(c.x, 0.0f) && Near(c.y, 1.0f) && Near(c.z, 0.0f))) ||
+			(blue && !(Near(c.x, 0.0f) && Near(c.y, 0.0f) && Near(c.z, 1.0f))))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool MeshImporterTest::ObjBadVertexArity()
+{
+	for (const char* text : { "v 0 0 0 1 2\nv 1 0 0\nv 0 1 0\nf 1 2 3\n","v 0 0 0 1 1 1 1 1\nv 1 0 0\nv 0 1 0\nf 1 2 3\n" })
+	{
+		const TempFile file("hw3d_obj_bad.obj", text);
+		try
+		{
+			MeshImporter::LoadObj(file.GetPath(), {});
+			return false;
+		}
+		catch (const MeshImporter::Exception&)
+		{
+		}
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+// import round trips over small files written to the temp directory (and removed again)
+// each returns whether the import came back as written; run by hw3dtest
+class MeshImporterTest
+{
+public:
+	// v x y z w: w is read and dropped, no colors
+	static bool ObjHomogeneousVertex();
+	// v x y z r g b and v x y z w r g b: colors come through, w is dropped
+	static bool ObjVertexColors();
+	// v with 5 or more than 7 numbers is rejected
+	static bool ObjBadVertexArity();
+};
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "MeshNormals.h"
+#include "ParallelFor.h"
+#include "ChiliMath.h"
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+#include <bit>
+#include <thread>
+#include <cassert>
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr size_t minChunkTriangles = 16384u;
+	constexpr size_t minChunkVertices = 16384u;
+
+	template<class T>
+	const T& Element(const T* p, size_t stride, size_t i) noexcept
+	{
+		return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(p) + i * stride);
+	}
+	template<class T>
+	T& Element(T* p, size_t stride, size_t i) noexcept
+	{
+		return *reinterpret_cast<T*>(reinterpret_cast<char*>(p) + i * stride);
+	}
+
+	dx::XMVECTOR NormalizeOrZero(dx::FXMVECTOR v) noexcept
+	{
+		const float length = dx::XMVectorGetX(dx::XMVector3Length(v));
+		return length > 0.0f ? dx::XMVectorScale(v, 1.0f / length) : dx::XMVectorZero();
+	}
+
+	// angle between two directions that are already unit length (or zero)
+	float Angle(dx::FXMVECTOR a, dx::FXMVECTOR b) noexcept
+	{
+		return std::acos(std::clamp(dx::XMVectorGetX(dx::XMVector3Dot(a, b)), -1.0f, 1.0f));
+	}
+
+	// sums per-corner values into per-vertex totals without atomics
+	// scatter: worker c walks its slice of the triangles and appends each corner's value to
+	//   bucket (c, range of the corner's vertex)
+	// gather: the worker for vertex range r adds up buckets (0..nChunks, r) in worker order,
+	//   so totals don't depend on scheduling
+	// with a single worker there is nothing to keep apart and corners add straight into totals
+	template<size_t N>
+	class VertexBuckets
+	{
+	public:
+		using Value = std::array<float, N>;
+	private:
+		struct Contribution
+		{
+			uint32_t vertex;
+			Value value;
+		};
+	public:
+		VertexBuckets(size_t nTriangles, size_t nVertices)
+			:
+			nTriangles(nTriangles),
+			nVertices(nVertices)
+		{
+			const size_t nThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1u);
+			nChunks = std::clamp<size_t>(nTriangles / minChunkTriangles, 1u, nThreads);
+			// power of two vertex ranges so finding a vertex's bucket is a shift
+			rangeShift = std::countr_zero(std::bit_ceil(std::max<size_t>((nVertices + nThreads - 1u) / nThreads, 1u)));
+			nRanges = (nVertices + (size_t(1) << rangeShift) - 1u) >> rangeShift;
+			if (nChunks == 1u)
+			{
+				totals.resize(nVertices);
+			}
+			else
+			{
+				buckets.resize(nChunks * nRanges);
+			}
+		}
+		// f(firstTriangle, lastTriangle, push) where push(vertex, value)
+		template<class F>
+		void Scatter(F&& f)
+		{
+			if (nChunks == 1u)
+			{
+				f(size_t(0u), nTriangles, [this](uint32_t vertex, const Value& value)
+				{
+					auto& total = totals[vertex];
+					for (size_t k = 0; k < N; k++)
+					{
+						total[k] += value[k];
+					}
+				});
+				return;
+			}
+			ParallelFor(nChunks, 1u, [&](size_t firstChunk, size_t lastChunk)
+			{
+				for (size_t c = firstChunk; c < lastChunk; c++)
+				{
+					auto* const pRow = &buckets[c * nRanges];
+					const size_t first = nTriangles * c / nChunks;
+					const size_t last = nTriangles * (c + 1u) / nChunks;
+					// corners spread roughly evenly over the ranges, a little slack saves regrowing
+					const size_t expected = (last - first) * 3u / nRanges;
+					for (size_t r = 0; r < nRanges; r++)
+					{
+						pRow[r].reserve(expected + expected / 8u + 16u);
+					}
+					const unsigned int shift = rangeShift;
+					f(first, last, [pRow, shift](uint32_t vertex, const Value& value)
+					{
+						pRow[vertex >> shift].push_back({ vertex,value });
+					});
+				}
+			});
+		}
+		// f(firstVertex, lastVertex, totals) where totals[v - firstVertex] belongs to vertex v
+		template<class F>
+		void Gather(F&& f)
+		{
+			if (nChunks == 1u)
+			{
+				ParallelFor(nVertices, minChunkVertices, [&](size_t first, size_t last)
+				{
+					f(first, last, std::span<const Value>(totals).subspan(first, last - first));
+				});
+				return;
+			}
+			ParallelFor(nRanges, 1u, [&](size_t firstRange, size_t lastRange)
+			{
+				std::vector<Value> totals;
+				for (size_t r = firstRange; r < lastRange; r++)
+				{
+					const size_t firstVertex = r << rangeShift;
+					const size_t lastVertex = std::min(firstVertex + (size_t(1) << rangeShift), nVertices);
+					totals.assign(lastVertex - firstVertex, Value{});
+					for (size_t c = 0; c < nChunks; c++)
+					{
+						for (const auto& contribution : buckets[c * nRanges + r])
+						{
+							auto& total = totals[contribution.vertex - firstVertex];
+							for (size_t k = 0; k < N; k++)
+							{
+								total[k] += contribution.value[k];
+							}
+						}
+					}
+					f(firstVertex, lastVertex, std::span<const Value>(totals));
+				}
+			});
+		}
+	private:
+		size_t nTriangles;
+		size_t nVertices;
+		size_t nChunks;
+		size_t nRanges;
+		unsigned int rangeShift;
+		// nChunks rows of nRanges buckets
+		std::vector<std::vector<Contribution>> buckets;
+		// only used with a single chunk
+		std::vector<Value> totals;
+	};
+}
+
+void MeshNormals::ComputeFlat(const DirectX::XMFLOAT3* pPositions, size_t positionStride,
+	DirectX::XMFLOAT3* pNormals, size_t normalStride, size_t nTriangles)
+{
+	ParallelFor(nTriangles, minChunkTriangles, [=](size_t first, size_t last)
+	{
+		for (size_t t = first; t < last; t++)
+		{
+			const auto p0 = dx::XMLoadFloat3(&Element(pPositions, positionStride, t * 3u));
+			const auto p1 = dx::XMLoadFloat3(&Element(pPositions, positionStride, t * 3u + 1u));
+			const auto p2 = dx::XMLoadFloat3(&Element(pPositions, positionStride, t * 3u + 2u));
+			const auto n = NormalizeOrZero(dx::XMVector3Cross(dx::XMVectorSubtract(p1, p0), dx::XMVectorSubtract(p2, p0)));
+			for (size_t k = 0; k < 3u; k++)
+			{
+				dx::XMStoreFloat3(&Element(pNormals, normalStride, t * 3u + k), n);
+			}
+		}
+	});
+}
+
+template<class I>
+void MeshNormals::ComputeSmooth(std::span<const I> indices,
+	const DirectX::XMFLOAT3* pPositions, size_t positionStride,
+	DirectX::XMFLOAT3* pNormals, size_t normalStride, size_t nVertices,
+	NormalWeighting weighting)
+{
+	assert("index count must be a multiple of 3" && indices.size() % 3u == 0u);
+	VertexBuckets<3> buckets(indices.size() / 3u, nVertices);
+	buckets.Scatter([&](size_t first, size_t last, auto&& push)
+	{
+		for (size_t t = first; t < last; t++)
+		{
+			const uint32_t i[3] = { uint32_t(indices[t * 3u]),uint32_t(indices[t * 3u + 1u]),uint32_t(indices[t * 3u + 2u]) };
+			const auto p0 = dx::XMLoadFloat3(&Element(pPositions, positionStride, i[0]));
+			const auto p1 = dx::XMLoadFloat3(&Element(pPositions, positionStride, i[1]));
+			const auto p2 = dx::XMLoadFloat3(&Element(pPositions, positionStride, i[2]));
+			const auto e01 = dx::XMVectorSubtract(p1, p0);
+			const auto e02 = dx::XMVectorSubtract(p2, p0);
+			// cross product length is twice the area, which is exactly the area weight
+			const auto n = dx::XMVector3Cross(e01, e02);
+			if (weighting == NormalWeighting::Area)
+			{
+				const std::array<float, 3> value = { dx::XMVectorGetX(n),dx::XMVectorGetY(n),dx::XMVectorGetZ(n) };
+				push(i[0], value);
+				push(i[1], value);
+				push(i[2], value);
+				continue;
+			}
+			const auto unit = NormalizeOrZero(n);
+			const auto d01 = NormalizeOrZero(e01);
+			const auto d02 = NormalizeOrZero(e02);
+			const auto d12 = NormalizeOrZero(dx::XMVectorSubtract(p2, p1));
+			// the third angle is whatever the first two leave of pi
+			float angles[3] = {
+				Angle(d01, d02),
+				Angle(dx::XMVectorNegate(d01), d12),
+			};
+			angles[2] = std::max(PI - angles[0] - angles[1], 0.0f);
+			for (size_t k = 0; k < 3u; k++)
+			{
+				const auto weighted = dx::XMVectorScale(unit, angles[k]);
+				push(i[k], { dx::XMVectorGetX(weighted),dx::XMVectorGetY(weighted),dx::XMVectorGetZ(weighted) });
+			}
+		}
+	});
+	buckets.Gather([&](size_t first, size_t last, std::span<const std::array<float, 3>> totals)
+	{
+		for (size_t v = first; v < last; v++)
+		{
+			const auto& total = totals[v - first];
+			dx::XMStoreFloat3(&Element(pNormals, normalStride, v),
+				NormalizeOrZero(dx::XMVectorSet(total[0], total[1], total[2], 0.0f)));
+		}
+	});
+}
+
+template<class I>
+void MeshNormals::ComputeTangents(std::span<const I> indices,
+	const DirectX::XMFLOAT3* pPositions, size_t positionStride,
+	const DirectX::XMFLOAT3* pNormals, size_t normalStride,
+	const DirectX::XMFLOAT2* pTexcoords, size_t texcoordStride,
+	DirectX::XMFLOAT4* pTangents, size_t tangentStride, size_t nVertices)
+{
+	assert("index count must be a multiple of 3" && indices.size() % 3u == 0u);
+	// per vertex: summed tangent (xyz) then summed bitangent (xyz)
+	VertexBuckets<6> buckets(indices.size() / 3u, nVertices);
+	buckets.Scatter([&](size_t first, size_t last, auto&& push)
+	{
+		for (size_t t = first; t < last; t++)
+		{
+			const uint32_t i[3] = { uint32_t(indices[t * 3u]),uint32_t(indices[t * 3u + 1u]),uint32_t(indices[t * 3u + 2u]) };
+			dx::XMVECTOR p[3];
+			for (size_t k = 0; k < 3u; k++)
+			{
+				p[k] = dx::XMLoadFloat3(&Element(pPositions, positionStride, i[k]));
+			}
+			const auto& uv0 = Element(pTexcoords, texcoordStride, i[0]);
+			const auto& uv1 = Element(pTexcoords, texcoordStride, i[1]);
+			const auto& uv2 = Element(pTexcoords, texcoordStride, i[2]);
+			const float s1x = uv1.x - uv0.x;
+			const float s1y = uv1.y - uv0.y;
+			const float s2x = uv2.x - uv0.x;
+			const float s2y = uv2.y - uv0.y;
+			const float signedArea = s1x * s2y - s1y * s2x;
+			if (signedArea == 0.0f)
+			{
+				// no uv gradient, the face has no say in its vertices' tangents
+				continue;
+			}
+			// directions of increasing u and v over the face, flipped back for mirrored uvs
+			const auto d1 = dx::XMVectorSubtract(p[1], p[0]);
+			const auto d2 = dx::XMVectorSubtract(p[2], p[0]);
+			const float orientation = signedArea > 0.0f ? 1.0f : -1.0f;
+			const auto os = dx::XMVectorScale(dx::XMVectorSubtract(dx::XMVectorScale(d1, s2y), dx::XMVectorScale(d2, s1y)), orientation);
+			const auto ot = dx::XMVectorScale(dx::XMVectorSubtract(dx::XMVectorScale(d2, s1x), dx::XMVectorScale(d1, s2x)), orientation);
+			for (size_t k = 0; k < 3u; k++)
+			{
+				const auto n = dx::XMLoadFloat3(&Element(pNormals, normalStride, i[k]));
+				const auto project = [n](dx::FXMVECTOR v)
+				{
+					return NormalizeOrZero(dx::XMVectorSubtract(v, dx::XMVectorScale(n, dx::XMVectorGetX(dx::XMVector3Dot(n, v)))));
+				};
+				// corner angle measured in the tangent plane of the corner normal
+				const float angle = Angle(
+					project(dx::XMVectorSubtract(p[(k + 2u) % 3u], p[k])),
+					project(dx::XMVectorSubtract(p[(k + 1u) % 3u], p[k]))
+				);
+				const auto tangent = dx::XMVectorScale(project(os), angle);
+				const auto bitangent = dx::XMVectorScale(project(ot), angle);
+				push(i[k], {
+					dx::XMVectorGetX(tangent),dx::XMVectorGetY(tangent),dx::XMVectorGetZ(tangent),
+					dx::XMVectorGetX(bitangent),dx::XMVectorGetY(bitangent),dx::XMVectorGetZ(bitangent)
+				});
+			}
+		}
+	});
+	buckets.Gather([&](size_t first, size_t last, std::span<const std::array<float, 6>> totals)
+	{
+		for (size_t v = first; v < last; v++)
+		{
+			const auto& total = totals[v - first];
+			const auto n = dx::XMLoadFloat3(&Element(pNormals, normalStride, v));
+			const auto sum = dx::XMVectorSet(total[0], total[1], total[2], 0.0f);
+			auto tangent = NormalizeOrZero(dx::XMVectorSubtract(sum, dx::XMVectorScale(n, dx::XMVectorGetX(dx::XMVector3Dot(n, sum)))));
+			if (dx::XMVector3Equal(tangent, dx::XMVectorZero()))
+			{
+				// no usable uvs around this vertex, any direction in the tangent plane will do
+				const auto axis = std::abs(dx::XMVectorGetX(n)) < 0.9f ? dx::XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f) : dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+				tangent = NormalizeOrZero(dx::XMVector3Cross(axis, n));
+			}
+			const auto bitangent = dx::XMVectorSet(total[3], total[4], total[5], 0.0f);
+			const float handedness = dx::XMVectorGetX(dx::XMVector3Dot(dx::XMVector3Cross(n, tangent), bitangent)) < 0.0f ? -1.0f : 1.0f;
+			dx::XMStoreFloat4(&Element(pTangents, tangentStride, v), dx::XMVectorSetW(tangent, handedness));
+		}
+	});
+}
+
+template void MeshNormals::ComputeSmooth<unsigned short>(std::span<const unsigned short>, const DirectX::XMFLOAT3*, size_t, DirectX::XMFLOAT3*, size_t, size_t, NormalWeighting);
+template void MeshNormals::ComputeSmooth<unsigned int>(std::span<const unsigned int>, const DirectX::XMFLOAT3*, size_t, DirectX::XMFLOAT3*, size_t, size_t, NormalWeighting);
+template void MeshNormals::ComputeTangents<unsigned short>(std::span<const unsigned short>, const DirectX::XMFLOAT3*, size_t, const DirectX::XMFLOAT3*, size_t, const DirectX::XMFLOAT2*, size_t, DirectX::XMFLOAT4*, size_t, size_t);
+template void MeshNormals::ComputeTangents<unsigned int>(std::span<const unsigned int>, const DirectX::XMFLOAT3*, size_t, const DirectX::XMFLOAT3*, size_t, const DirectX::XMFLOAT2*, size_t, DirectX::XMFLOAT4*, size_t, size_t);
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <span>
+#include <numeric>
+
+// how face normals are weighted when they are averaged into a shared vertex
+// area: big triangles dominate, cheapest
+// angle: each face counts by the angle it spans at the vertex, so the result doesn't depend on
+//   how the surface around the vertex happens to be triangulated
+enum class NormalWeighting
+{
+	Area,
+	Angle,
+};
+
+// per-vertex normals and tangents for meshes that don't come with them
+// per-corner contributions are scattered by worker into one bucket per vertex range, then each
+// vertex range is summed by a single worker, so there are no atomics and no per-thread copies
+// of the whole vertex buffer
+// attributes are read / written through byte strides so any vertex layout works
+// index-level work is instantiated for 16-bit and 32-bit indices in MeshNormals.cpp
+class MeshNormals
+{
+public:
+	// face normal of triangle t written to vertices 3t..3t+2, for meshes with no shared vertices
+	static void ComputeFlat(const DirectX::XMFLOAT3* pPositions, size_t positionStride,
+		DirectX::XMFLOAT3* pNormals, size_t normalStride, size_t nTriangles);
+	// unshares every corner (3 vertices per triangle, other attributes copied) and gives each
+	// the normal of its face, so every triangle is shaded flat
+	template<class V, class I>
+	static IndexedTriangleList<V, I> MakeFlat(const IndexedTriangleList<V, I>& mesh)
+	{
+		assert("apply or take the pending transform first" && !mesh.HasPendingTransform());
+		IndexedTriangleList<V, I>::CheckIndexRange(mesh.indices.size());
+		const auto& vertices = mesh.GetVertices();
+		IndexedTriangleList<V, I> flat(mesh.GetResource());
+		flat.Reserve(mesh.indices.size(), mesh.indices.size());
+		auto& flatVertices = flat.GetVertices();
+		for (const auto i : mesh.indices)
+		{
+			flatVertices.push_back(vertices[i]);
+		}
+		flat.indices.resize(mesh.indices.size());
+		std::iota(flat.indices.begin(), flat.indices.end(), I(0));
+		if (!flatVertices.empty())
+		{
+			ComputeFlat(&flatVertices.front().pos, sizeof(V), &flatVertices.front().n, sizeof(V), flat.indices.size() / 3u);
+		}
+		return flat;
+	}
+	// unit normals averaged over the faces around each vertex; vertices no triangle uses get 0
+	template<class I>
+	static void ComputeSmooth(std::span<const I> indices,
+		const DirectX::XMFLOAT3* pPositions, size_t positionStride,
+		DirectX::XMFLOAT3* pNormals, size_t normalStride, size_t nVertices,
+		NormalWeighting weighting = NormalWeighting::Angle);
+	template<class V, class I>
+	static void ComputeSmooth(IndexedTriangleList<V, I>& mesh, NormalWeighting weighting = NormalWeighting::Angle)
+	{
+		auto& vertices = mesh.GetVertices();
+		if (vertices.empty())
+		{
+			return;
+		}
+		ComputeSmooth<I>(mesh.indices, &vertices.front().pos, sizeof(V),
+			&vertices.front().n, sizeof(V), vertices.size(), weighting);
+	}
+	// tangent frames following MikkTSpace: per corner, the face's uv gradients are projected
+	// into the plane of the corner normal and weighted by the corner angle; xyz is the unit
+	// tangent, w the sign so that bitangent = w * cross(normal, tangent)
+	// normals must already be set. unlike mikktspace, vertices are not split here, so meshes
+	// should already have separate vertices across uv seams and mirrored uv islands
+	template<class I>
+	static void ComputeTangents(std::span<const I> indices,
+		const DirectX::XMFLOAT3* pPositions, size_t positionStride,
+		const DirectX::XMFLOAT3* pNormals, size_t normalStride,
+		const DirectX::XMFLOAT2* pTexcoords, size_t texcoordStride,
+		DirectX::XMFLOAT4* pTangents, size_t tangentStride, size_t nVertices);
+	template<class V, class I>
+	static void ComputeTangents(IndexedTriangleList<V, I>& mesh)
+	{
+		auto& vertices = mesh.GetVertices();
+		if (vertices.empty())
+		{
+			return;
+		}
+		ComputeTangents<I>(mesh.indices, &vertices.front().pos, sizeof(V), &vertices.front().n, sizeof(V),
+			&vertices.front().tc, sizeof(V), &vertices.front().tangent, sizeof(V), vertices.size());
+	}
+};
\ No newline at end of file
@@ -0,0 +1,569 @@
+#include "MeshOptimizer.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <limits>
+
+namespace
+{
+	// tuning constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	constexpr float cacheDecayPower = 1.5f;
+	constexpr float lastTriScore = 0.75f;
+	constexpr float valenceBoostScale = 2.0f;
+	constexpr float valenceBoostPower = 0.5f;
+	constexpr unsigned int valenceTableSize = 32u;
+	constexpr uint32_t noTriangle = std::numeric_limits<uint32_t>::max();
+	constexpr uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+
+	class VertexScorer
+	{
+	public:
+		VertexScorer(unsigned int cacheSize) noexcept
+		{
+			for (unsigned int i = 0; i < cacheSize; i++)
+			{
+				if (i < 3u)
+				{
+					// the last triangle's vertices get a fixed score so the next triangle
+					// doesn't get picked purely because it shares an edge with the last one
+					cacheScores[i] = lastTriScore;
+				}
+				else
+				{
+					const float scaler = 1.0f / float(cacheSize - 3u);
+					cacheScores[i] = std::pow(1.0f - float(i - 3u) * scaler, cacheDecayPower);
+				}
+			}
+			for (unsigned int i = 0; i < valenceTableSize; i++)
+			{
+				valenceScores[i] = ValenceBoost(i);
+			}
+		}
+		float operator()(int cachePos, uint32_t remaining) const noexcept
+		{
+			if (remaining == 0u)
+			{
+				// no triangles left that use this vertex
+				return -1.0f;
+			}
+			const float cacheScore = cachePos >= 0 ? cacheScores[cachePos] : 0.0f;
+			return cacheScore + (remaining < valenceTableSize ? valenceScores[remaining] : ValenceBoost(remaining));
+		}
+	private:
+		static float ValenceBoost(uint32_t remaining) noexcept
+		{
+			// boost vertices with few triangles left so that lone triangles get cleared out
+			return remaining == 0u ? 0.0f : valenceBoostScale * std::pow(float(remaining), -valenceBoostPower);
+		}
+	private:
+		float cacheScores[MeshOptimizer::maxCacheSize];
+		float valenceScores[valenceTableSize];
+	};
+
+	// positions of a vertex stream with an arbitrary layout
+	class PositionReader
+	{
+	public:
+		PositionReader(const DirectX::XMFLOAT3* pPositions, size_t stride) noexcept
+			:
+			pBytes(reinterpret_cast<const char*>(pPositions)),
+			stride(stride)
+		{
+		}
+		DirectX::XMVECTOR operator[](size_t i) const noexcept
+		{
+			return DirectX::XMLoadFloat3(reinterpret_cast<const DirectX::XMFLOAT3*>(pBytes + i * stride));
+		}
+	private:
+		const char* pBytes;
+		size_t stride;
+	};
+
+	// fifo post-transform cache model shared by the analyzers and the overdraw clustering
+	template<class I>
+	class FifoCache
+	{
+	public:
+		FifoCache(size_t nVertices, unsigned int cacheSize)
+			:
+			timestamps(nVertices, 0u),
+			cacheSize(cacheSize),
+			time(cacheSize + 1u)
+		{
+		}
+		// returns true if v had to be transformed
+		bool Access(I v) noexcept
+		{
+			if (time - timestamps[v] > cacheSize)
+			{
+				timestamps[v] = time++;
+				return true;
+			}
+			return false;
+		}
+		unsigned int AccessTriangle(const I* tri) noexcept
+		{
+			return (unsigned int)Access(tri[0]) + (unsigned int)Access(tri[1]) + (unsigned int)Access(tri[2]);
+		}
+		void Flush() noexcept
+		{
+			time += cacheSize + 1u;
+		}
+	private:
+		std::vector<uint32_t> timestamps;
+		uint32_t cacheSize;
+		uint32_t time;
+	};
+}
+
+template<class I>
+VertexCacheStats MeshOptimizer::AnalyzeVertexCache(std::span<const I> indices, size_t nVertices, unsigned int cacheSize)
+{
+	assert(indices.size() % 3 == 0);
+	if (indices.empty())
+	{
+		return { 0.0f,0.0f };
+	}
+	FifoCache<I> cache(nVertices, cacheSize);
+	std::vector<bool> referenced(nVertices, false);
+	size_t misses = 0u;
+	size_t nReferenced = 0u;
+	for (const auto i : indices)
+	{
+		assert(i < nVertices);
+		if (!referenced[i])
+		{
+			referenced[i] = true;
+			nReferenced++;
+		}
+		misses += cache.Access(i) ? 1u : 0u;
+	}
+	return {
+		float(misses) / float(indices.size() / 3u),
+		float(misses) / float(nReferenced)
+	};
+}
+
+template<class I>
+void MeshOptimizer::OptimizeVertexCache(std::span<I> indices, size_t nVertices, unsigned int cacheSize)
+{
+	assert(indices.size() % 3 == 0);
+	cacheSize = std::clamp(cacheSize, 4u, maxCacheSize);
+	const size_t nTriangles = indices.size() / 3u;
+	if (nTriangles == 0u)
+	{
+		return;
+	}
+	const VertexScorer score(cacheSize);
+
+	// vertex -> triangle adjacency in compressed rows; the live triangles of vertex v
+	// are adjacency[offsets[v] .. offsets[v] + remaining[v])
+	std::vector<uint32_t> remaining(nVertices, 0u);
+	for (const auto i : indices)
+	{
+		remaining[i]++;
+	}
+	std::vector<uint32_t> offsets(nVertices + 1u, 0u);
+	for (size_t v = 0; v < nVertices; v++)
+	{
+		offsets[v + 1u] = offsets[v] + remaining[v];
+	}
+	std::vector<uint32_t> adjacency(indices.size());
+	{
+		std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			adjacency[cursor[indices[i]]++] = uint32_t(i / 3u);
+		}
+	}
+
+	std::vector<int> cachePos(nVertices, -1);
+	std::vector<float> vertexScores(nVertices);
+	for (size_t v = 0; v < nVertices; v++)
+	{
+		vertexScores[v] = score(-1, remaining[v]);
+	}
+	std::vector<float> triangleScores(nTriangles);
+	for (size_t t = 0; t < nTriangles; t++)
+	{
+		triangleScores[t] = vertexScores[indices[t * 3u]] +
+			vertexScores[indices[t * 3u + 1u]] +
+			vertexScores[indices[t * 3u + 2u]];
+	}
+	std::vector<bool> emitted(nTriangles, false);
+	std::vector<I> output;
+	output.reserve(indices.size());
+
+	// lru cache plus room for the 3 vertices pushed in front of it each step
+	uint32_t cache[maxCacheSize + 3u];
+	uint32_t newCache[maxCacheSize + 3u];
+	size_t cacheCount = 0u;
+
+	uint32_t bestTriangle = uint32_t(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin());
+	size_t scanCursor = 0u;
+	for (size_t nEmitted = 0; nEmitted < nTriangles; nEmitted++)
+	{
+		if (bestTriangle == noTriangle)
+		{
+			// nothing adjacent to the cache left: resume from the next unemitted triangle
+			while (emitted[scanCursor])
+			{
+				scanCursor++;
+			}
+			bestTriangle = uint32_t(scanCursor);
+		}
+		const I* const tri = &indices[bestTriangle * 3u];
+		output.insert(output.end(), tri, tri + 3);
+		emitted[bestTriangle] = true;
+
+		// retire the triangle from its vertices' adjacency lists
+		for (int k = 0; k < 3; k++)
+		{
+			const auto v = tri[k];
+			auto* const first = &adjacency[offsets[v]];
+			auto* const last = first + remaining[v];
+			*std::find(first, last, bestTriangle) = *(last - 1);
+			remaining[v]--;
+		}
+
+		// move the triangle's vertices to the front of the lru cache
+		size_t newCount = 0u;
+		for (int k = 0; k < 3; k++)
+		{
+			newCache[newCount++] = uint32_t(tri[k]);
+		}
+		for (size_t i = 0; i < cacheCount; i++)
+		{
+			const auto v = cache[i];
+			if (v != tri[0] && v != tri[1] && v != tri[2])
+			{
+				newCache[newCount++] = v;
+			}
+		}
+
+		// rescore everything that moved (including vertices that just fell out) and
+		// pick the best live triangle touching the cache
+		float bestScore = -std::numeric_limits<float>::max();
+		bestTriangle = noTriangle;
+		for (size_t i = 0; i < newCount; i++)
+		{
+			const auto v = newCache[i];
+			cachePos[v] = i < cacheSize ? int(i) : -1;
+			const float newScore = score(cachePos[v], remaining[v]);
+			const float delta = newScore - vertexScores[v];
+			vertexScores[v] = newScore;
+			const auto first = adjacency.begin() + offsets[v];
+			for (auto it = first; it != first + remaining[v]; ++it)
+			{
+				triangleScores[*it] += delta;
+				if (triangleScores[*it] > bestScore)
+				{
+					bestScore = triangleScores[*it];
+					bestTriangle = *it;
+				}
+			}
+		}
+		cacheCount = std::min<size_t>(newCount, cacheSize);
+		std::copy(newCache, newCache + cacheCount, cache);
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+template<class I>
+OverdrawStats MeshOptimizer::AnalyzeOverdraw(std::span<const I> indices,
+	const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices)
+{
+	namespace dx = DirectX;
+	assert(indices.size() % 3 == 0);
+	OverdrawStats stats = { 0u,0u,0.0f };
+	if (indices.empty())
+	{
+		return stats;
+	}
+	const PositionReader pos(pPositions, stride);
+
+	// fit the mesh into the viewport from every direction
+	auto vMin = pos[indices[0]];
+	auto vMax = vMin;
+	for (const auto i : indices)
+	{
+		vMin = dx::XMVectorMin(vMin, pos[i]);
+		vMax = dx::XMVectorMax(vMax, pos[i]);
+	}
+	const auto center = dx::XMVectorScale(dx::XMVectorAdd(vMin, vMax), 0.5f);
+	const auto extent = dx::XMVectorSubtract(vMax, vMin);
+	const float maxExtent = std::max({ dx::XMVectorGetX(extent),dx::XMVectorGetY(extent),dx::XMVectorGetZ(extent),1e-12f });
+	constexpr float size = float(overdrawViewportSize);
+	const float scale = (size - 1.0f) / maxExtent;
+
+	struct View
+	{
+		dx::XMFLOAT3 forward;
+		dx::XMFLOAT3 up;
+	};
+	constexpr View views[] = {
+		{ { 0.0f,0.0f,1.0f },{ 0.0f,1.0f,0.0f } },
+		{ { 0.0f,0.0f,-1.0f },{ 0.0f,1.0f,0.0f } },
+		{ { 1.0f,0.0f,0.0f },{ 0.0f,1.0f,0.0f } },
+		{ { -1.0f,0.0f,0.0f },{ 0.0f,1.0f,0.0f } },
+		{ { 0.0f,1.0f,0.0f },{ 0.0f,0.0f,1.0f } },
+		{ { 0.0f,-1.0f,0.0f },{ 0.0f,0.0f,1.0f } },
+	};
+	std::vector<float> depth(overdrawViewportSize * overdrawViewportSize);
+	std::vector<dx::XMFLOAT3> screen(nVertices);
+	for (const auto& view : views)
+	{
+		// left-handed view basis looking down forward, x right / y up on screen
+		const auto forward = dx::XMLoadFloat3(&view.forward);
+		const auto up = dx::XMLoadFloat3(&view.up);
+		const auto right = dx::XMVector3Cross(up, forward);
+		for (const auto i : indices)
+		{
+			const auto p = dx::XMVectorSubtract(pos[i], center);
+			screen[i] = {
+				dx::XMVectorGetX(dx::XMVector3Dot(p, right)) * scale + size * 0.5f,
+				dx::XMVectorGetX(dx::XMVector3Dot(p, up)) * scale + size * 0.5f,
+				dx::XMVectorGetX(dx::XMVector3Dot(p, forward))
+			};
+		}
+		std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::infinity());
+		for (size_t t = 0; t < indices.size(); t += 3u)
+		{
+			const auto& a = screen[indices[t]];
+			const auto& b = screen[indices[t + 1u]];
+			const auto& c = screen[indices[t + 2u]];
+			const auto edge = [](const dx::XMFLOAT3& p0, const dx::XMFLOAT3& p1, float x, float y)
+			{
+				return (p1.x - p0.x) * (y - p0.y) - (p1.y - p0.y) * (x - p0.x);
+			};
+			// d3d default rasterizer state: clockwise is front facing, back faces culled
+			const float area = edge(a, b, c.x, c.y);
+			if (area >= 0.0f)
+			{
+				continue;
+			}
+			const int x0 = std::max(int(std::floor(std::min({ a.x,b.x,c.x }))), 0);
+			const int x1 = std::min(int(std::ceil(std::max({ a.x,b.x,c.x }))), int(overdrawViewportSize) - 1);
+			const int y0 = std::max(int(std::floor(std::min({ a.y,b.y,c.y }))), 0);
+			const int y1 = std::min(int(std::ceil(std::max({ a.y,b.y,c.y }))), int(overdrawViewportSize) - 1);
+			const float invArea = 1.0f / area;
+			for (int y = y0; y <= y1; y++)
+			{
+				const float py = float(y) + 0.5f;
+				for (int x = x0; x <= x1; x++)
+				{
+					const float px = float(x) + 0.5f;
+					// barycentrics are >= 0 inside (edge values share the sign of area)
+					const float w0 = edge(b, c, px, py) * invArea;
+					const float w1 = edge(c, a, px, py) * invArea;
+					const float w2 = edge(a, b, px, py) * invArea;
+					if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+					{
+						continue;
+					}
+					const float z = w0 * a.z + w1 * b.z + w2 * c.z;
+					auto& d = depth[size_t(y) * overdrawViewportSize + x];
+					if (z < d)
+					{
+						d = z;
+						stats.pixelsShaded++;
+					}
+				}
+			}
+		}
+		stats.pixelsCovered += std::count_if(depth.begin(), depth.end(),
+			[](float d) { return d != std::numeric_limits<float>::infinity(); });
+	}
+	stats.overdraw = stats.pixelsCovered ? float(stats.pixelsShaded) / float(stats.pixelsCovered) : 0.0f;
+	return stats;
+}
+
+template<class I>
+void MeshOptimizer::OptimizeOverdraw(std::span<I> indices,
+	const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices,
+	float threshold, unsigned int cacheSize)
+{
+	namespace dx = DirectX;
+	assert(indices.size() % 3 == 0);
+	const size_t nTriangles = indices.size() / 3u;
+	if (nTriangles == 0u)
+	{
+		return;
+	}
+	const PositionReader pos(pPositions, stride);
+
+	// hard boundaries: a triangle whose 3 vertices all miss the cache starts a new
+	// cluster, so reordering at these points does not hurt the vertex cache at all
+	std::vector<uint32_t> hardClusters;
+	{
+		FifoCache<I> cache(nVertices, cacheSize);
+		for (size_t t = 0; t < nTriangles; t++)
+		{
+			if (cache.AccessTriangle(&indices[t * 3u]) == 3u || t == 0u)
+			{
+				hardClusters.push_back(uint32_t(t));
+			}
+		}
+		hardClusters.push_back(uint32_t(nTriangles));
+	}
+	// soft boundaries: split hard clusters further wherever the running acmr since the last
+	// split is within threshold of the whole cluster's acmr
+	std::vector<uint32_t> clusters;
+	{
+		FifoCache<I> cache(nVertices, cacheSize);
+		for (size_t h = 0; h + 1u < hardClusters.size(); h++)
+		{
+			const size_t start = hardClusters[h];
+			const size_t end = hardClusters[h + 1u];
+			cache.Flush();
+			size_t clusterMisses = 0u;
+			for (size_t t = start; t < end; t++)
+			{
+				clusterMisses += cache.AccessTriangle(&indices[t * 3u]);
+			}
+			const float clusterThreshold = threshold * float(clusterMisses) / float(end - start);
+
+			cache.Flush();
+			clusters.push_back(uint32_t(start));
+			size_t misses = 0u;
+			size_t subStart = start;
+			for (size_t t = start; t < end; t++)
+			{
+				misses += cache.AccessTriangle(&indices[t * 3u]);
+				if (t + 1u < end && float(misses) / float(t + 1u - subStart) <= clusterThreshold)
+				{
+					clusters.push_back(uint32_t(t + 1u));
+					subStart = t + 1u;
+					misses = 0u;
+					cache.Flush();
+				}
+			}
+		}
+		clusters.push_back(uint32_t(nTriangles));
+	}
+
+	// sort key: how far out along its own facing direction a cluster sits. clusters on the
+	// outside that face outward are likely to occlude the rest, so they go first
+	auto meshCentroid = dx::XMVectorZero();
+	for (size_t v = 0; v < nVertices; v++)
+	{
+		meshCentroid = dx::XMVectorAdd(meshCentroid, pos[v]);
+	}
+	meshCentroid = dx::XMVectorScale(meshCentroid, 1.0f / float(std::max<size_t>(nVertices, 1u)));
+	const size_t nClusters = clusters.size() - 1u;
+	std::vector<float> sortKeys(nClusters);
+	for (size_t c = 0; c < nClusters; c++)
+	{
+		auto centroid = dx::XMVectorZero();
+		auto normal = dx::XMVectorZero();
+		float totalArea = 0.0f;
+		for (size_t t = clusters[c]; t < clusters[c + 1u]; t++)
+		{
+			const auto p0 = pos[indices[t * 3u]];
+			const auto p1 = pos[indices[t * 3u + 1u]];
+			const auto p2 = pos[indices[t * 3u + 2u]];
+			// clockwise front faces in a left-handed frame: (p1 - p0) x (p2 - p0) points outward
+			const auto n = dx::XMVector3Cross(dx::XMVectorSubtract(p1, p0), dx::XMVectorSubtract(p2, p0));
+			const float area = dx::XMVectorGetX(dx::XMVector3Length(n));
+			centroid = dx::XMVectorAdd(centroid,
+				dx::XMVectorScale(dx::XMVectorAdd(dx::XMVectorAdd(p0, p1), p2), area / 3.0f));
+			normal = dx::XMVectorAdd(normal, n);
+			totalArea += area;
+		}
+		centroid = totalArea > 0.0f ? dx::XMVectorScale(centroid, 1.0f / totalArea) : meshCentroid;
+		sortKeys[c] = dx::XMVectorGetX(dx::XMVector3Dot(
+			dx::XMVectorSubtract(centroid, meshCentroid),
+			dx::XMVector3Normalize(normal)
+		));
+	}
+	std::vector<uint32_t> order(nClusters);
+	for (size_t c = 0; c < nClusters; c++)
+	{
+		order[c] = uint32_t(c);
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[&sortKeys](uint32_t lhs, uint32_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+	std::vector<I> output;
+	output.reserve(indices.size());
+	for (const auto c : order)
+	{
+		output.insert(output.end(), indices.begin() + clusters[c] * 3u, indices.begin() + clusters[c + 1u] * 3u);
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+template<class I>
+VertexFetchStats MeshOptimizer::AnalyzeVertexFetch(std::span<const I> indices, size_t nVertices, size_t vertexSize)
+{
+	assert(indices.size() % 3 == 0);
+	// only vertices that miss the post-transform cache are fetched; fetches go through a
+	// fifo cache of lines, each line miss costs a full line of memory traffic
+	constexpr uint32_t nLines = uint32_t(fetchCacheSize / fetchCacheLineSize);
+	FifoCache<I> transformCache(nVertices, defaultCacheSize);
+	std::vector<uint32_t> lineTimestamps((nVertices * vertexSize + fetchCacheLineSize - 1u) / fetchCacheLineSize, 0u);
+	uint32_t lineTime = nLines + 1u;
+	std::vector<bool> referenced(nVertices, false);
+	size_t nReferenced = 0u;
+	VertexFetchStats stats = { 0u,0.0f };
+	for (const auto i : indices)
+	{
+		if (!referenced[i])
+		{
+			referenced[i] = true;
+			nReferenced++;
+		}
+		if (!transformCache.Access(i))
+		{
+			continue;
+		}
+		const size_t firstLine = size_t(i) * vertexSize / fetchCacheLineSize;
+		const size_t lastLine = (size_t(i) * vertexSize + vertexSize - 1u) / fetchCacheLineSize;
+		for (size_t line = firstLine; line <= lastLine; line++)
+		{
+			if (lineTime - lineTimestamps[line] > nLines)
+			{
+				lineTimestamps[line] = lineTime++;
+				stats.bytesFetched += fetchCacheLineSize;
+			}
+		}
+	}
+	stats.overfetch = nReferenced ? float(stats.bytesFetched) / float(nReferenced * vertexSize) : 0.0f;
+	return stats;
+}
+
+template<class I>
+std::vector<uint32_t> MeshOptimizer::MakeFetchRemap(std::span<const I> indices, size_t nVertices)
+{
+	std::vector<uint32_t> remap(nVertices, noVertex);
+	uint32_t next = 0u;
+	for (const auto i : indices)
+	{
+		if (remap[i] == noVertex)
+		{
+			remap[i] = next++;
+		}
+	}
+	for (auto& r : remap)
+	{
+		if (r == noVertex)
+		{
+			r = next++;
+		}
+	}
+	return remap;
+}
+
+template VertexCacheStats MeshOptimizer::AnalyzeVertexCache<unsigned short>(std::span<const unsigned short>, size_t, unsigned int);
+template VertexCacheStats MeshOptimizer::AnalyzeVertexCache<unsigned int>(std::span<const unsigned int>, size_t, unsigned int);
+template void MeshOptimizer::OptimizeVertexCache<unsigned short>(std::span<unsigned short>, size_t, unsigned int);
+template void MeshOptimizer::OptimizeVertexCache<unsigned int>(std::span<unsigned int>, size_t, unsigned int);
+template OverdrawStats MeshOptimizer::AnalyzeOverdraw<unsigned short>(std::span<const unsigned short>, const DirectX::XMFLOAT3*, size_t, size_t);
+template void MeshOptimizer::OptimizeOverdraw<unsigned short>(std::span<unsigned short>, const DirectX::XMFLOAT3*, size_t, size_t, float, unsigned int);
+template VertexFetchStats MeshOptimizer::AnalyzeVertexFetch<unsigned short>(std::span<const unsigned short>, size_t, size_t);
+template std::vector<uint32_t> MeshOptimizer::MakeFetchRemap<unsigned short>(std::span<const unsigned short>, size_t);
+template OverdrawStats MeshOptimizer::AnalyzeOverdraw<unsigned int>(std::span<const unsigned int>, const DirectX::XMFLOAT3*, size_t, size_t);
+template void MeshOptimizer::OptimizeOverdraw<unsigned int>(std::span<unsigned int>, const DirectX::XMFLOAT3*, size_t, size_t, float, unsigned int);
+template VertexFetchStats MeshOptimizer::AnalyzeVertexFetch<unsigned int>(std::span<const unsigned int>, size_t, size_t);
+template std::vector<uint32_t> MeshOptimizer::MakeFetchRemap<unsigned int>(std::span<const unsigned int>, size_t);
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <span>
+#include <vector>
+#include <cstdint>
+
+// post-transform vertex cache efficiency of an index stream
+// acmr: transformed vertices per triangle (ideal ~0.5 for large regular meshes, worst 3.0)
+// atvr: transformed vertices per referenced vertex (ideal 1.0)
+struct VertexCacheStats
+{
+	float acmr;
+	float atvr;
+};
+
+struct VertexCacheReport
+{
+	VertexCacheStats before;
+	VertexCacheStats after;
+};
+
+// result of rasterizing a mesh on the cpu from a set of view directions
+// overdraw: shaded pixels / covered pixels (1.0 means every visible pixel is shaded once)
+struct OverdrawStats
+{
+	size_t pixelsCovered;
+	size_t pixelsShaded;
+	float overdraw;
+};
+
+// vertex memory traffic after the post-transform cache, through a cache-line model
+// overfetch: bytes fetched / bytes of referenced vertex data (1.0 is ideal)
+struct VertexFetchStats
+{
+	size_t bytesFetched;
+	float overfetch;
+};
+
+// index / vertex reordering passes that make meshes cheaper for the gpu to process
+// index-level work is instantiated for 16-bit and 32-bit indices in MeshOptimizer.cpp
+class MeshOptimizer
+{
+public:
+	static constexpr unsigned int defaultCacheSize = 16u;
+	static constexpr unsigned int maxCacheSize = 64u;
+	static constexpr float defaultOverdrawThreshold = 1.05f;
+	static constexpr unsigned int overdrawViewportSize = 256u;
+	static constexpr size_t fetchCacheLineSize = 64u;
+	static constexpr size_t fetchCacheSize = 16u * 1024u;
+public:
+	// simulate a fifo post-transform cache of cacheSize entries
+	template<class I>
+	static VertexCacheStats AnalyzeVertexCache(std::span<const I> indices, size_t nVertices,
+		unsigned int cacheSize = defaultCacheSize);
+	// reorder triangles (Forsyth's linear-speed algorithm) so that consecutive triangles
+	// reuse recently transformed vertices. triangle winding is preserved
+	template<class I>
+	static void OptimizeVertexCache(std::span<I> indices, size_t nVertices,
+		unsigned int cacheSize = defaultCacheSize);
+	template<class V, class I>
+	static VertexCacheReport OptimizeVertexCache(IndexedTriangleList<V, I>& mesh,
+		unsigned int cacheSize = defaultCacheSize)
+	{
+		VertexCacheReport report;
+		report.before = AnalyzeVertexCache<I>(mesh.indices, mesh.GetVertexCount(), cacheSize);
+		OptimizeVertexCache<I>(mesh.indices, mesh.GetVertexCount(), cacheSize);
+		report.after = AnalyzeVertexCache<I>(mesh.indices, mesh.GetVertexCount(), cacheSize);
+		return report;
+	}
+	// rasterize with back-face culling and a less-than depth test from the 6 axis directions
+	// positions are read from pPositions with a byte stride so any vertex layout works
+	template<class I>
+	static OverdrawStats AnalyzeOverdraw(std::span<const I> indices,
+		const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices);
+	template<class V, class I>
+	static OverdrawStats AnalyzeOverdraw(const IndexedTriangleList<V, I>& mesh)
+	{
+		assert("apply or take the pending transform first" && !mesh.HasPendingTransform());
+		const auto& vertices = mesh.GetVertices();
+		return AnalyzeOverdraw<I>(mesh.indices, vertices.empty() ? nullptr : &vertices.front().pos, sizeof(V), vertices.size());
+	}
+	// split a vertex cache optimized index stream into clusters and order the clusters
+	// so that outward-facing ones on the outside of the mesh are drawn first. threshold
+	// bounds how much worse the acmr is allowed to get (1.05 = 5%)
+	template<class I>
+	static void OptimizeOverdraw(std::span<I> indices,
+		const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices,
+		float threshold = defaultOverdrawThreshold, unsigned int cacheSize = defaultCacheSize);
+	template<class V, class I>
+	static void OptimizeOverdraw(IndexedTriangleList<V, I>& mesh,
+		float threshold = defaultOverdrawThreshold, unsigned int cacheSize = defaultCacheSize)
+	{
+		const auto& vertices = mesh.GetVertices();
+		OptimizeOverdraw<I>(mesh.indices, vertices.empty() ? nullptr : &vertices.front().pos, sizeof(V), vertices.size(),
+			threshold, cacheSize);
+	}
+	// simulate fetching vertices of vertexSize bytes (post-transform cache misses only)
+	// through a cache of fetchCacheSize bytes made of fetchCacheLineSize byte lines
+	template<class I>
+	static VertexFetchStats AnalyzeVertexFetch(std::span<const I> indices, size_t nVertices, size_t vertexSize);
+	template<class V, class I>
+	static VertexFetchStats AnalyzeVertexFetch(const IndexedTriangleList<V, I>& mesh)
+	{
+		return AnalyzeVertexFetch<I>(mesh.indices, mesh.GetVertexCount(), sizeof(V));
+	}
+	// order of vertices by first use in the index stream; unreferenced vertices go last
+	// remap[oldIndex] = newIndex
+	template<class I>
+	static std::vector<uint32_t> MakeFetchRemap(std::span<const I> indices, size_t nVertices);
+	// reorder the vertex buffer to match the index stream and rewrite the indices
+	template<class V, class I>
+	static void OptimizeVertexFetch(IndexedTriangleList<V, I>& mesh)
+	{
+		auto& vertices = mesh.GetVertices();
+		const auto remap = MakeFetchRemap<I>(mesh.indices, vertices.size());
+		std::pmr::vector<V> reordered(vertices.size(), mesh.GetResource());
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			reordered[remap[i]] = vertices[i];
+		}
+		vertices = std::move(reordered);
+		for (auto& i : mesh.indices)
+		{
+			i = (I)remap[i];
+		}
+	}
+};
\ No newline at end of file
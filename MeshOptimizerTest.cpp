@@ -0,0 +1,156 @@
+#include "MeshOptimizerTest.h"
+#include "MeshOptimizer.h"
+#include "Plane.h"
+#include "Sphere.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <random>
+#include <array>
+#include <vector>
+#include <cstdio>
+
+namespace dx = DirectX;
+
+namespace
+{
+	struct Vertex
+	{
+		dx::XMFLOAT3 pos;
+	};
+
+	// a vertex the size of a typical lit one, so fetch locality shows up in the cache-line model
+	struct WideVertex
+	{
+		dx::XMFLOAT3 pos;
+		float pad[5];
+	};
+
+	// triangles rotated to start at their smallest index (which keeps the winding), then sorted
+	std::vector<std::array<unsigned int, 3>> SortedTriangles(const std::pmr::vector<unsigned int>& indices)
+	{
+		std::vector<std::array<unsigned int, 3>> triangles;
+		triangles.reserve(indices.size() / 3u);
+		for (size_t i = 0; i < indices.size(); i += 3u)
+		{
+			std::array<unsigned int, 3> t = { indices[i],indices[i + 1u],indices[i + 2u] };
+			std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+			triangles.push_back(t);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	void ShuffleTriangles(std::pmr::vector<unsigned int>& indices, unsigned int seed)
+	{
+		std::vector<std::array<unsigned int, 3>> triangles;
+		for (size_t i = 0; i < indices.size(); i += 3u)
+		{
+			triangles.push_back({ indices[i],indices[i + 1u],indices[i + 2u] });
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(seed));
+		for (size_t i = 0; i < triangles.size(); i++)
+		{
+			std::copy(triangles[i].begin(), triangles[i].end(), indices.begin() + i * 3u);
+		}
+	}
+
+	// half-size sphere followed by a unit sphere around it, vertex cache optimized
+	IndexedTriangleList<WideVertex, unsigned int> MakeNestedSpheres()
+	{
+		const auto sphere = Sphere::MakeTesselated<WideVertex, unsigned int>(16, 32);
+		IndexedTriangleList<WideVertex, unsigned int> nested;
+		auto& vertices = nested.GetVertices();
+		for (auto v : sphere.GetVertices())
+		{
+			dx::XMStoreFloat3(&v.pos, dx::XMVectorScale(dx::XMLoadFloat3(&v.pos), 0.5f));
+			vertices.push_back(v);
+		}
+		vertices.insert(vertices.end(), sphere.GetVertices().begin(), sphere.GetVertices().end());
+		nested.indices = sphere.indices;
+		for (const auto i : sphere.indices)
+		{
+			nested.indices.push_back(i + (unsigned int)sphere.GetVertexCount());
+		}
+		MeshOptimizer::OptimizeVertexCache(nested);
+		return nested;
+	}
+
+	bool OptimizeAndCheck(IndexedTriangleList<Vertex, unsigned int>& mesh, float minAcmrBefore, float maxAcmrAfter)
+	{
+		const auto triangles = SortedTriangles(mesh.indices);
+		const auto report = MeshOptimizer::OptimizeVertexCache(mesh);
+		std::printf("       acmr %.3f -> %.3f, atvr %.3f -> %.3f\n",
+			report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr);
+		return SortedTriangles(mesh.indices) == triangles &&
+			report.before.acmr >= minAcmrBefore && report.after.acmr <= maxAcmrAfter;
+	}
+}
+
+bool MeshOptimizerTest::VertexCacheOnPlane()
+{
+	auto plane = Plane::MakeTesselated<Vertex, unsigned int>(300, 300);
+	return OptimizeAndCheck(plane, 0.99f, 0.75f);
+}
+
+bool MeshOptimizerTest::VertexCacheOnShuffledPlane()
+{
+	auto plane = Plane::MakeTesselated<Vertex, unsigned int>(300, 300);
+	ShuffleTriangles(plane.indices, 1u);
+	return OptimizeAndCheck(plane, 2.9f, 0.75f);
+}
+
+bool MeshOptimizerTest::OverdrawOnNestedSpheres()
+{
+	auto mesh = MakeNestedSpheres();
+	const auto triangles = SortedTriangles(mesh.indices);
+	const auto overdrawBefore = MeshOptimizer::AnalyzeOverdraw(mesh);
+	const auto cacheBefore = MeshOptimizer::AnalyzeVertexCache<unsigned int>(mesh.indices, mesh.GetVertexCount());
+	MeshOptimizer::OptimizeOverdraw(mesh);
+	const auto overdrawAfter = MeshOptimizer::AnalyzeOverdraw(mesh);
+	const auto cacheAfter = MeshOptimizer::AnalyzeVertexCache<unsigned int>(mesh.indices, mesh.GetVertexCount());
+	std::printf("       overdraw %.3f -> %.3f, acmr %.3f -> %.3f\n",
+		overdrawBefore.overdraw, overdrawAfter.overdraw, cacheBefore.acmr, cacheAfter.acmr);
+	return SortedTriangles(mesh.indices) == triangles &&
+		overdrawBefore.overdraw >= 1.2f && overdrawAfter.overdraw <= 1.1f &&
+		cacheAfter.acmr <= cacheBefore.acmr * MeshOptimizer::defaultOverdrawThreshold;
+}
+
+bool MeshOptimizerTest::VertexFetchOnShuffledVertices()
+{
+	auto mesh = MakeNestedSpheres();
+	auto& vertices = mesh.GetVertices();
+	std::vector<unsigned int> shuffle(vertices.size());
+	for (unsigned int i = 0; i < shuffle.size(); i++)
+	{
+		shuffle[i] = i;
+	}
+	std::shuffle(shuffle.begin(), shuffle.end(), std::mt19937(3u));
+	const auto original = vertices;
+	for (size_t i = 0; i < shuffle.size(); i++)
+	{
+		vertices[shuffle[i]] = original[i];
+	}
+	for (auto& i : mesh.indices)
+	{
+		i = shuffle[i];
+	}
+
+	std::vector<dx::XMFLOAT3> corners;
+	for (const auto i : mesh.indices)
+	{
+		corners.push_back(vertices[i].pos);
+	}
+	const auto before = MeshOptimizer::AnalyzeVertexFetch(mesh);
+	MeshOptimizer::OptimizeVertexFetch(mesh);
+	const auto after = MeshOptimizer::AnalyzeVertexFetch(mesh);
+	std::printf("       overfetch %.3f -> %.3f\n", before.overfetch, after.overfetch);
+	for (size_t i = 0; i < corners.size(); i++)
+	{
+		const auto& p = mesh.GetVertices()[mesh.indices[i]].pos;
+		if (p.x != corners[i].x || p.y != corners[i].y || p.z != corners[i].z)
+		{
+			return false;
+		}
+	}
+	return before.overfetch >= 1.2f && after.overfetch <= 1.05f;
+}
\ No newline at end of file
@@ -0,0 +1,535 @@
+#include "MeshSimplifier.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+#include <limits>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	namespace dx = DirectX;
+
+	constexpr uint32_t noVertex = std::numeric_limits<uint32_t>::max();
+	// open edge bookkeeping marker for a vertex with more than one open edge in a direction
+	constexpr uint32_t manyVertices = noVertex - 1u;
+	// open borders / seams get a perpendicular plane quadric this much stronger than the
+	// surface so that collapses do not pull them out of shape
+	constexpr float edgeWeight = 10.0f;
+	constexpr size_t minParallelChunk = 16u * 1024u;
+
+	enum class VertexKind : unsigned char
+	{
+		// interior vertex, free to collapse onto any neighbour
+		Manifold,
+		// single open boundary running through the vertex, collapses along it only
+		Border,
+		// two coincident vertices whose attributes differ, collapse together along the seam
+		Seam,
+		// anything else (corners, non-manifold fans, multi-way seams), never moves
+		Locked,
+	};
+
+	// symmetric 4x4 quadric for sum of weighted squared distances to planes
+	struct Quadric
+	{
+		float a00, a11, a22;
+		float a10, a20, a21;
+		float b0, b1, b2;
+		float c;
+		float w;
+		static Quadric FromPlane(float nx, float ny, float nz, float d, float w) noexcept
+		{
+			return {
+				w * nx * nx, w * ny * ny, w * nz * nz,
+				w * ny * nx, w * nz * nx, w * nz * ny,
+				w * nx * d, w * ny * d, w * nz * d,
+				w * d * d,
+				w
+			};
+		}
+		Quadric& operator+=(const Quadric& rhs) noexcept
+		{
+			a00 += rhs.a00; a11 += rhs.a11; a22 += rhs.a22;
+			a10 += rhs.a10; a20 += rhs.a20; a21 += rhs.a21;
+			b0 += rhs.b0; b1 += rhs.b1; b2 += rhs.b2;
+			c += rhs.c;
+			w += rhs.w;
+			return *this;
+		}
+		// weighted mean squared distance of p to the planes
+		float Error(const dx::XMFLOAT3& p) const noexcept
+		{
+			const float rx = a00 * p.x + a10 * p.y + a20 * p.z + 2.0f * b0;
+			const float ry = a10 * p.x + a11 * p.y + a21 * p.z + 2.0f * b1;
+			const float rz = a20 * p.x + a21 * p.y + a22 * p.z + 2.0f * b2;
+			const float e = rx * p.x + ry * p.y + rz * p.z + c;
+			return w > 0.0f ? std::abs(e) / w : 0.0f;
+		}
+	};
+
+	uint32_t HashMix(uint64_t k) noexcept
+	{
+		k ^= k >> 33u;
+		k *= 0xff51afd7ed558ccdull;
+		k ^= k >> 33u;
+		return uint32_t(k);
+	}
+
+	size_t TableSizeFor(size_t count) noexcept
+	{
+		size_t size = 16u;
+		while (size < count * 2u)
+		{
+			size *= 2u;
+		}
+		return size;
+	}
+
+	// open addressing set of directed edges a->b
+	class EdgeSet
+	{
+	public:
+		EdgeSet(size_t capacity)
+			:
+			keys(TableSizeFor(capacity), empty),
+			mask(keys.size() - 1u)
+		{
+		}
+		void Insert(uint32_t a, uint32_t b) noexcept
+		{
+			const uint64_t key = Key(a, b);
+			for (size_t i = HashMix(key) & mask;; i = (i + 1u) & mask)
+			{
+				if (keys[i] == key)
+				{
+					return;
+				}
+				if (keys[i] == empty)
+				{
+					keys[i] = key;
+					return;
+				}
+			}
+		}
+		bool Contains(uint32_t a, uint32_t b) const noexcept
+		{
+			const uint64_t key = Key(a, b);
+			for (size_t i = HashMix(key) & mask;; i = (i + 1u) & mask)
+			{
+				if (keys[i] == key)
+				{
+					return true;
+				}
+				if (keys[i] == empty)
+				{
+					return false;
+				}
+			}
+		}
+	private:
+		static uint64_t Key(uint32_t a, uint32_t b) noexcept
+		{
+			return (uint64_t(a) << 32u) | b;
+		}
+	private:
+		static constexpr uint64_t empty = std::numeric_limits<uint64_t>::max();
+		std::vector<uint64_t> keys;
+		size_t mask;
+	};
+
+	// group bitwise-identical positions: group[v] is the first vertex at v's position and
+	// wedge[] links all vertices at one position into a ring
+	void BuildPositionGroups(const std::vector<dx::XMFLOAT3>& points,
+		std::vector<uint32_t>& group, std::vector<uint32_t>& wedge)
+	{
+		const size_t nVertices = points.size();
+		std::vector<uint32_t> table(TableSizeFor(nVertices), noVertex);
+		const size_t mask = table.size() - 1u;
+		const auto bits = [](float f)
+		{
+			uint32_t u;
+			std::memcpy(&u, &f, sizeof(u));
+			return uint64_t(u);
+		};
+		for (size_t v = 0; v < nVertices; v++)
+		{
+			const auto& p = points[v];
+			const uint64_t h = bits(p.x) * 73856093u ^ bits(p.y) * 19349663u ^ bits(p.z) * 83492791u;
+			for (size_t i = HashMix(h) & mask;; i = (i + 1u) & mask)
+			{
+				if (table[i] == noVertex)
+				{
+					table[i] = uint32_t(v);
+					group[v] = uint32_t(v);
+					wedge[v] = uint32_t(v);
+					break;
+				}
+				const auto& q = points[table[i]];
+				if (bits(q.x) == bits(p.x) && bits(q.y) == bits(p.y) && bits(q.z) == bits(p.z))
+				{
+					const uint32_t first = table[i];
+					group[v] = first;
+					wedge[v] = wedge[first];
+					wedge[first] = uint32_t(v);
+					break;
+				}
+			}
+		}
+	}
+
+	// vertex -> triangle lists in compressed row form, keyed by position group
+	struct Adjacency
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+	};
+
+	template<class I>
+	void BuildAdjacency(Adjacency& adj, std::span<const I> indices, const std::vector<uint32_t>& group)
+	{
+		const size_t nVertices = group.size();
+		adj.offsets.assign(nVertices + 1u, 0u);
+		for (const auto i : indices)
+		{
+			adj.offsets[group[i] + 1u]++;
+		}
+		for (size_t v = 0; v < nVertices; v++)
+		{
+			adj.offsets[v + 1u] += adj.offsets[v];
+		}
+		adj.triangles.resize(indices.size());
+		std::vector<uint32_t> cursor(adj.offsets.begin(), adj.offsets.end() - 1u);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			adj.triangles[cursor[group[indices[i]]]++] = uint32_t(i / 3u);
+		}
+	}
+
+	dx::XMFLOAT3 TriangleNormal(const dx::XMFLOAT3& p0, const dx::XMFLOAT3& p1, const dx::XMFLOAT3& p2) noexcept
+	{
+		const float ex = p1.x - p0.x, ey = p1.y - p0.y, ez = p1.z - p0.z;
+		const float fx = p2.x - p0.x, fy = p2.y - p0.y, fz = p2.z - p0.z;
+		return { ey * fz - ez * fy,ez * fx - ex * fz,ex * fy - ey * fx };
+	}
+
+	float Dot(const dx::XMFLOAT3& a, const dx::XMFLOAT3& b) noexcept
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	bool CanCollapse(VertexKind from, VertexKind to, bool openEdge) noexcept
+	{
+		switch (from)
+		{
+		case VertexKind::Manifold:
+			return true;
+		case VertexKind::Border:
+		case VertexKind::Seam:
+			return to == from && openEdge;
+		default:
+			return false;
+		}
+	}
+
+	// v0 collapses onto v1
+	struct Collapse
+	{
+		uint32_t v0;
+		uint32_t v1;
+		float error;
+	};
+}
+
+template<class I>
+SimplifyResult MeshSimplifier::Simplify(std::span<I> indices,
+	const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices,
+	size_t targetTriangles, float targetError)
+{
+	assert(indices.size() % 3 == 0);
+	size_t nTriangles = indices.size() / 3u;
+	SimplifyResult result = { nTriangles,0.0f };
+	if (nTriangles <= targetTriangles || nVertices == 0u)
+	{
+		return result;
+	}
+
+	// work in a unit-sized copy of the positions so errors are relative to the mesh extent
+	const auto pBytes = reinterpret_cast<const char*>(pPositions);
+	std::vector<dx::XMFLOAT3> points(nVertices);
+	for (size_t v = 0; v < nVertices; v++)
+	{
+		points[v] = *reinterpret_cast<const dx::XMFLOAT3*>(pBytes + v * stride);
+	}
+	{
+		dx::XMFLOAT3 lo = points[0];
+		dx::XMFLOAT3 hi = points[0];
+		for (const auto& p : points)
+		{
+			lo = { std::min(lo.x,p.x),std::min(lo.y,p.y),std::min(lo.z,p.z) };
+			hi = { std::max(hi.x,p.x),std::max(hi.y,p.y),std::max(hi.z,p.z) };
+		}
+		const float extent = std::max({ hi.x - lo.x,hi.y - lo.y,hi.z - lo.z });
+		const float scale = extent > 0.0f ? 1.0f / extent : 0.0f;
+		ParallelFor(nVertices, minParallelChunk, [&points, lo, scale](size_t first, size_t last)
+		{
+			for (size_t v = first; v < last; v++)
+			{
+				auto& p = points[v];
+				p = { (p.x - lo.x) * scale,(p.y - lo.y) * scale,(p.z - lo.z) * scale };
+			}
+		});
+	}
+
+	std::vector<uint32_t> group(nVertices);
+	std::vector<uint32_t> wedge(nVertices);
+	BuildPositionGroups(points, group, wedge);
+
+	// classify vertices from their open (unpaired) edges
+	std::vector<VertexKind> kinds(nVertices, VertexKind::Manifold);
+	std::vector<Quadric> quadrics(nVertices, Quadric{});
+	{
+		EdgeSet edges(indices.size());
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			edges.Insert(uint32_t(indices[i]), uint32_t(indices[i - i % 3u + (i + 1u) % 3u]));
+		}
+		std::vector<uint32_t> openOut(nVertices, noVertex);
+		std::vector<uint32_t> openIn(nVertices, noVertex);
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			const uint32_t a = indices[i];
+			const uint32_t b = indices[i - i % 3u + (i + 1u) % 3u];
+			if (a != b && !edges.Contains(b, a))
+			{
+				openOut[a] = openOut[a] == noVertex ? b : manyVertices;
+				openIn[b] = openIn[b] == noVertex ? a : manyVertices;
+			}
+		}
+		const auto single = [](uint32_t v) { return v != noVertex && v != manyVertices; };
+		for (size_t v = 0; v < nVertices; v++)
+		{
+			const bool closed = openOut[v] == noVertex && openIn[v] == noVertex;
+			const bool border = single(openOut[v]) && single(openIn[v]);
+			if (wedge[v] == v)
+			{
+				kinds[v] = closed ? VertexKind::Manifold : border ? VertexKind::Border : VertexKind::Locked;
+			}
+			else if (wedge[wedge[v]] == v)
+			{
+				// a seam is a pair of borders running in opposite directions over the same positions
+				const uint32_t w = wedge[v];
+				const bool seam = border && single(openOut[w]) && single(openIn[w]) &&
+					group[openIn[v]] == group[openOut[w]] && group[openOut[v]] == group[openIn[w]];
+				kinds[v] = seam ? VertexKind::Seam : VertexKind::Locked;
+			}
+			else
+			{
+				kinds[v] = VertexKind::Locked;
+			}
+		}
+
+		// quadrics live on the first vertex of each position group so that wedges share them
+		std::vector<Quadric> triangleQuadrics(nTriangles);
+		ParallelFor(nTriangles, minParallelChunk, [&](size_t first, size_t last)
+		{
+			for (size_t t = first; t < last; t++)
+			{
+				const auto& p0 = points[indices[t * 3u]];
+				const auto n = TriangleNormal(p0, points[indices[t * 3u + 1u]], points[indices[t * 3u + 2u]]);
+				const float length = std::sqrt(Dot(n, n));
+				if (length == 0.0f)
+				{
+					triangleQuadrics[t] = {};
+					continue;
+				}
+				const float nx = n.x / length, ny = n.y / length, nz = n.z / length;
+				triangleQuadrics[t] = Quadric::FromPlane(nx, ny, nz, -(nx * p0.x + ny * p0.y + nz * p0.z), length * 0.5f);
+			}
+		});
+		Adjacency adj;
+		BuildAdjacency<I>(adj, indices, group);
+		ParallelFor(nVertices, minParallelChunk, [&](size_t first, size_t last)
+		{
+			for (size_t v = first; v < last; v++)
+			{
+				for (uint32_t j = adj.offsets[v]; j < adj.offsets[v + 1u]; j++)
+				{
+					quadrics[v] += triangleQuadrics[adj.triangles[j]];
+				}
+			}
+		});
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			const uint32_t a = indices[i];
+			const uint32_t b = indices[i - i % 3u + (i + 1u) % 3u];
+			const uint32_t c = indices[i - i % 3u + (i + 2u) % 3u];
+			if (a == b || edges.Contains(b, a))
+			{
+				continue;
+			}
+			// plane through the open edge, perpendicular to its triangle
+			const auto& pa = points[a];
+			const auto& pb = points[b];
+			const auto n = TriangleNormal(pa, pb, points[c]);
+			const dx::XMFLOAT3 e = { pb.x - pa.x,pb.y - pa.y,pb.z - pa.z };
+			const dx::XMFLOAT3 m = { e.y * n.z - e.z * n.y,e.z * n.x - e.x * n.z,e.x * n.y - e.y * n.x };
+			const float length = std::sqrt(Dot(m, m));
+			if (length == 0.0f)
+			{
+				continue;
+			}
+			const float mx = m.x / length, my = m.y / length, mz = m.z / length;
+			const auto q = Quadric::FromPlane(mx, my, mz, -(mx * pa.x + my * pa.y + mz * pa.z),
+				std::sqrt(Dot(e, e)) * edgeWeight);
+			quadrics[group[a]] += q;
+			quadrics[group[b]] += q;
+		}
+	}
+
+	// each pass collapses a batch of the cheapest independent edges and rewrites the indices
+	const float errorLimit = targetError * targetError;
+	float maxError = 0.0f;
+	std::vector<uint32_t> remap(nVertices);
+	std::iota(remap.begin(), remap.end(), 0u);
+	std::vector<unsigned char> locked(nVertices, 0u);
+	std::vector<Collapse> collapses;
+	Adjacency adj;
+	while (nTriangles > targetTriangles)
+	{
+		const auto live = indices.first(nTriangles * 3u);
+		EdgeSet edges(live.size());
+		for (size_t i = 0; i < live.size(); i++)
+		{
+			edges.Insert(uint32_t(live[i]), uint32_t(live[i - i % 3u + (i + 1u) % 3u]));
+		}
+		collapses.clear();
+		for (size_t i = 0; i < live.size(); i++)
+		{
+			const uint32_t a = live[i];
+			const uint32_t b = live[i - i % 3u + (i + 1u) % 3u];
+			// interior edges are seen from both sides, keep one
+			if (a != b && (a < b || !edges.Contains(b, a)))
+			{
+				collapses.push_back({ a,b,0.0f });
+			}
+		}
+		ParallelFor(collapses.size(), minParallelChunk, [&](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i++)
+			{
+				auto& c = collapses[i];
+				const bool open = !edges.Contains(c.v1, c.v0) || !edges.Contains(c.v0, c.v1);
+				const auto cost = [&](uint32_t from, uint32_t to)
+				{
+					if (!CanCollapse(kinds[from], kinds[to], open))
+					{
+						return std::numeric_limits<float>::infinity();
+					}
+					auto q = quadrics[group[from]];
+					q += quadrics[group[to]];
+					return q.Error(points[to]);
+				};
+				const float forward = cost(c.v0, c.v1);
+				const float backward = cost(c.v1, c.v0);
+				if (backward < forward)
+				{
+					c = { c.v1,c.v0,backward };
+				}
+				else
+				{
+					c.error = forward;
+				}
+			}
+		});
+		std::sort(collapses.begin(), collapses.end(),
+			[](const Collapse& lhs, const Collapse& rhs) { return lhs.error < rhs.error; });
+
+		BuildAdjacency<I>(adj, live, group);
+		const size_t goal = nTriangles - targetTriangles;
+		size_t removed = 0u;
+		size_t nApplied = 0u;
+		for (const auto& c : collapses)
+		{
+			if (c.error > errorLimit || removed >= goal)
+			{
+				break;
+			}
+			const uint32_t g0 = group[c.v0];
+			const uint32_t g1 = group[c.v1];
+			if (locked[g0] || locked[g1])
+			{
+				continue;
+			}
+			// reject the collapse if any surviving triangle around v0 would flip over
+			const auto& target = points[c.v1];
+			bool flips = false;
+			for (uint32_t j = adj.offsets[g0]; j < adj.offsets[g0 + 1u] && !flips; j++)
+			{
+				const size_t t = adj.triangles[j];
+				dx::XMFLOAT3 before[3];
+				dx::XMFLOAT3 after[3];
+				bool degenerate = false;
+				for (size_t k = 0; k < 3u; k++)
+				{
+					const uint32_t v = remap[live[t * 3u + k]];
+					degenerate = degenerate || group[v] == g1;
+					before[k] = points[v];
+					after[k] = group[v] == g0 ? target : points[v];
+				}
+				if (!degenerate)
+				{
+					flips = Dot(TriangleNormal(before[0], before[1], before[2]),
+						TriangleNormal(after[0], after[1], after[2])) <= 0.0f;
+				}
+			}
+			if (flips)
+			{
+				continue;
+			}
+			remap[c.v0] = c.v1;
+			if (kinds[c.v0] == VertexKind::Seam)
+			{
+				remap[wedge[c.v0]] = wedge[c.v1];
+			}
+			quadrics[g1] += quadrics[g0];
+			locked[g0] = 1u;
+			locked[g1] = 1u;
+			maxError = std::max(maxError, c.error);
+			removed += kinds[c.v0] == VertexKind::Border ? 1u : 2u;
+			nApplied++;
+		}
+		if (nApplied == 0u)
+		{
+			break;
+		}
+
+		size_t nKept = 0u;
+		for (size_t t = 0; t < nTriangles; t++)
+		{
+			const I i0 = (I)remap[live[t * 3u]];
+			const I i1 = (I)remap[live[t * 3u + 1u]];
+			const I i2 = (I)remap[live[t * 3u + 2u]];
+			if (i0 != i1 && i1 != i2 && i2 != i0)
+			{
+				indices[nKept * 3u] = i0;
+				indices[nKept * 3u + 1u] = i1;
+				indices[nKept * 3u + 2u] = i2;
+				nKept++;
+			}
+		}
+		nTriangles = nKept;
+		std::fill(locked.begin(), locked.end(), (unsigned char)0u);
+	}
+
+	result.nTriangles = nTriangles;
+	result.error = std::sqrt(maxError);
+	return result;
+}
+
+template SimplifyResult MeshSimplifier::Simplify<unsigned short>(std::span<unsigned short>,
+	const DirectX::XMFLOAT3*, size_t, size_t, size_t, float);
+template SimplifyResult MeshSimplifier::Simplify<unsigned int>(std::span<unsigned int>,
+	const DirectX::XMFLOAT3*, size_t, size_t, size_t, float);
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <span>
+#include <vector>
+#include <memory_resource>
+
+// outcome of a simplification run
+// error: largest collapse error accepted, as a distance relative to the mesh extent
+struct SimplifyResult
+{
+	size_t nTriangles;
+	float error;
+};
+
+// edge collapse simplification driven by quadric error metrics (Garland & Heckbert)
+// vertices only ever collapse onto other existing vertices, so the vertex buffer is left
+// untouched and every level of a lod chain can index the same vertices. attribute seams
+// (coincident vertices with different attributes) and open borders only collapse along
+// themselves, so uv / normal discontinuities and mesh outlines keep their shape
+class MeshSimplifier
+{
+public:
+	static constexpr float defaultTargetError = 1e-2f;
+public:
+	// simplify in place towards targetTriangles, never accepting a collapse with error
+	// above targetError. the first result.nTriangles * 3 indices hold the new mesh
+	template<class I>
+	static SimplifyResult Simplify(std::span<I> indices,
+		const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices,
+		size_t targetTriangles, float targetError = defaultTargetError);
+	template<class V, class I>
+	static SimplifyResult Simplify(IndexedTriangleList<V, I>& mesh,
+		size_t targetTriangles, float targetError = defaultTargetError)
+	{
+		const auto& vertices = mesh.GetVertices();
+		const auto result = Simplify<I>(mesh.indices, vertices.empty() ? nullptr : &vertices.front().pos, sizeof(V), vertices.size(),
+			targetTriangles, targetError);
+		mesh.indices.resize(result.nTriangles * 3u);
+		return result;
+	}
+	// index streams for up to nLevels levels, each aiming for ratio times the triangles
+	// of the previous one. level 0 is the mesh's own index stream; generation stops early
+	// once a level can't get below targetError. all levels index the mesh's vertices
+	template<class V, class I>
+	static std::vector<std::pmr::vector<I>> MakeLodChain(const IndexedTriangleList<V, I>& mesh,
+		size_t nLevels, float ratio = 0.5f, float targetError = defaultTargetError)
+	{
+		assert("apply or take the pending transform first" && !mesh.HasPendingTransform());
+		std::vector<std::pmr::vector<I>> levels;
+		levels.reserve(nLevels);
+		if (nLevels == 0u)
+		{
+			return levels;
+		}
+		levels.emplace_back(mesh.indices, mesh.GetResource());
+		const auto& vertices = mesh.GetVertices();
+		while (levels.size() < nLevels)
+		{
+			std::pmr::vector<I> indices(levels.back(), mesh.GetResource());
+			const size_t nPrevious = indices.size() / 3u;
+			const auto result = Simplify<I>(indices, vertices.empty() ? nullptr : &vertices.front().pos, sizeof(V), vertices.size(),
+				size_t(float(nPrevious) * ratio), targetError);
+			// a level that didn't shrink noticeably is not worth a draw call of its own
+			if (float(result.nTriangles) > float(nPrevious) * (ratio + 1.0f) * 0.5f)
+			{
+				break;
+			}
+			indices.resize(result.nTriangles * 3u);
+			levels.push_back(std::move(indices));
+		}
+		return levels;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,355 @@
+#include "MeshletBuilder.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <limits>
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr uint32_t notInMeshlet = std::numeric_limits<uint32_t>::max();
+	constexpr uint32_t noTriangle = std::numeric_limits<uint32_t>::max();
+	// cones with a triangle this close to perpendicular to the axis can't cull anything useful
+	constexpr float minConeDot = 0.1f;
+	constexpr size_t minParallelMeshlets = 256u;
+
+	dx::XMVECTOR LoadPosition(const dx::XMFLOAT3* pPositions, size_t stride, size_t i) noexcept
+	{
+		return dx::XMLoadFloat3(reinterpret_cast<const dx::XMFLOAT3*>(reinterpret_cast<const char*>(pPositions) + i * stride));
+	}
+
+	// triangles around each vertex, with a count of the ones not yet in a meshlet
+	struct VertexTriangles
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> triangles;
+
+		template<class I>
+		VertexTriangles(std::span<const I> indices, size_t nVertices)
+			:
+			offsets(nVertices + 1u, 0u),
+			triangles(indices.size())
+		{
+			for (const auto i : indices)
+			{
+				offsets[i + 1u]++;
+			}
+			for (size_t v = 0; v < nVertices; v++)
+			{
+				offsets[v + 1u] += offsets[v];
+			}
+			std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				triangles[fill[indices[i]]++] = uint32_t(i / 3u);
+			}
+		}
+		std::span<const uint32_t> Around(size_t v) const noexcept
+		{
+			return { triangles.data() + offsets[v],triangles.data() + offsets[v + 1u] };
+		}
+	};
+}
+
+template<class I>
+MeshletSet MeshletBuilder::Build(std::span<I> indices, const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices,
+	size_t maxVertices, size_t maxTriangles, float coneWeight)
+{
+	assert("index count must be a multiple of 3" && indices.size() % 3u == 0u);
+	assert("meshlet limits out of range" && maxVertices >= 3u && maxTriangles >= 1u);
+	const size_t nTriangles = indices.size() / 3u;
+	MeshletSet set;
+	if (nTriangles == 0u)
+	{
+		return set;
+	}
+
+	// unit face normals, zero for degenerate triangles so they never bend a cone
+	std::vector<dx::XMFLOAT3> normals(nTriangles);
+	ParallelFor(nTriangles, 4096u, [&](size_t first, size_t last)
+	{
+		for (size_t t = first; t < last; t++)
+		{
+			const auto p0 = LoadPosition(pPositions, stride, indices[t * 3u]);
+			const auto p1 = LoadPosition(pPositions, stride, indices[t * 3u + 1u]);
+			const auto p2 = LoadPosition(pPositions, stride, indices[t * 3u + 2u]);
+			const auto n = dx::XMVector3Cross(dx::XMVectorSubtract(p1, p0), dx::XMVectorSubtract(p2, p0));
+			const float length = dx::XMVectorGetX(dx::XMVector3Length(n));
+			dx::XMStoreFloat3(&normals[t], length > 0.0f ? dx::XMVectorScale(n, 1.0f / length) : dx::XMVectorZero());
+		}
+	});
+
+	const VertexTriangles adjacency(std::span<const I>(indices), nVertices);
+	std::vector<bool> used(nTriangles, false);
+	std::vector<uint32_t> localSlot(nVertices, notInMeshlet);
+	std::vector<uint32_t> order;
+	order.reserve(nTriangles);
+
+	// meshlet being grown
+	std::vector<uint32_t> meshletVertices;
+	meshletVertices.reserve(maxVertices);
+	auto normalSum = dx::XMVectorZero();
+	size_t nMeshletTriangles = 0u;
+	size_t seedCursor = 0u;
+
+	const auto newVertices = [&](uint32_t t)
+	{
+		const uint32_t a = uint32_t(indices[t * 3u]);
+		const uint32_t b = uint32_t(indices[t * 3u + 1u]);
+		const uint32_t c = uint32_t(indices[t * 3u + 2u]);
+		return size_t(localSlot[a] == notInMeshlet) +
+			size_t(localSlot[b] == notInMeshlet && b != a) +
+			size_t(localSlot[c] == notInMeshlet && c != a && c != b);
+	};
+	const auto add = [&](uint32_t t)
+	{
+		used[t] = true;
+		order.push_back(t);
+		nMeshletTriangles++;
+		for (size_t k = 0; k < 3u; k++)
+		{
+			const uint32_t v = uint32_t(indices[t * 3u + k]);
+			if (localSlot[v] == notInMeshlet)
+			{
+				localSlot[v] = uint32_t(meshletVertices.size());
+				meshletVertices.push_back(v);
+			}
+		}
+		normalSum = dx::XMVectorAdd(normalSum, dx::XMLoadFloat3(&normals[t]));
+	};
+	const auto finish = [&]()
+	{
+		const size_t firstTriangle = order.size() - nMeshletTriangles;
+		set.meshlets.push_back({ uint32_t(firstTriangle * 3u),uint32_t(nMeshletTriangles),uint32_t(meshletVertices.size()) });
+		for (const auto v : meshletVertices)
+		{
+			localSlot[v] = notInMeshlet;
+		}
+		meshletVertices.clear();
+		normalSum = dx::XMVectorZero();
+		nMeshletTriangles = 0u;
+	};
+	// best unused triangle around the given vertices that still fits, lower score is better
+	const auto pickAround = [&](std::span<const uint32_t> around)
+	{
+		const auto axis = dx::XMVector3Normalize(normalSum);
+		uint32_t best = noTriangle;
+		float bestScore = std::numeric_limits<float>::max();
+		for (const auto v : around)
+		{
+			for (const auto t : adjacency.Around(v))
+			{
+				if (used[t])
+				{
+					continue;
+				}
+				const size_t extra = newVertices(t);
+				if (meshletVertices.size() + extra > maxVertices)
+				{
+					continue;
+				}
+				const float spread = 1.0f - dx::XMVectorGetX(dx::XMVector3Dot(axis, dx::XMLoadFloat3(&normals[t])));
+				const float score = float(extra) + coneWeight * spread;
+				if (score < bestScore)
+				{
+					bestScore = score;
+					best = t;
+				}
+			}
+		}
+		return best;
+	};
+
+	while (order.size() < nTriangles)
+	{
+		while (used[seedCursor])
+		{
+			seedCursor++;
+		}
+		add(uint32_t(seedCursor));
+		while (nMeshletTriangles < maxTriangles)
+		{
+			// neighbours of the last triangle first, it keeps the meshlet compact and is cheap;
+			// then anything touching the meshlet; a meshlet with no fitting neighbour is done
+			const uint32_t lastTriangle = order.back();
+			const uint32_t lastCorners[3] = { uint32_t(indices[lastTriangle * 3u]),
+				uint32_t(indices[lastTriangle * 3u + 1u]),uint32_t(indices[lastTriangle * 3u + 2u]) };
+			uint32_t next = pickAround(lastCorners);
+			if (next == noTriangle)
+			{
+				next = pickAround(meshletVertices);
+			}
+			if (next == noTriangle)
+			{
+				break;
+			}
+			add(next);
+		}
+		finish();
+	}
+
+	// rewrite the indices meshlet by meshlet
+	std::vector<I> reordered(indices.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		std::copy_n(indices.begin() + order[i] * 3u, 3u, reordered.begin() + i * 3u);
+	}
+	std::copy(reordered.begin(), reordered.end(), indices.begin());
+
+	// bounds, one meshlet per task
+	const size_t nMeshlets = set.meshlets.size();
+	const size_t padded = (nMeshlets + 3u) & ~size_t(3u);
+	auto& b = set.bounds;
+	for (auto* pStream : { &b.centerX,&b.centerY,&b.centerZ,&b.radius,&b.axisX,&b.axisY,&b.axisZ,&b.cutoff })
+	{
+		pStream->assign(padded, 0.0f);
+	}
+	ParallelFor(nMeshlets, minParallelMeshlets, [&](size_t first, size_t last)
+	{
+		std::vector<dx::XMVECTOR> points;
+		points.reserve(maxTriangles * 3u);
+		for (size_t m = first; m < last; m++)
+		{
+			const auto& meshlet = set.meshlets[m];
+			const auto corners = indices.subspan(meshlet.firstIndex, meshlet.nTriangles * 3u);
+			points.clear();
+			auto sum = dx::XMVectorZero();
+			for (size_t i = 0; i < corners.size(); i++)
+			{
+				points.push_back(LoadPosition(pPositions, stride, corners[i]));
+				if (i % 3u == 2u)
+				{
+					// normals were computed in the old order, recompute from the rewritten corners
+					const auto n = dx::XMVector3Cross(
+						dx::XMVectorSubtract(points[i - 1u], points[i - 2u]),
+						dx::XMVectorSubtract(points[i], points[i - 2u])
+					);
+					const float length = dx::XMVectorGetX(dx::XMVector3Length(n));
+					if (length > 0.0f)
+					{
+						sum = dx::XMVectorAdd(sum, dx::XMVectorScale(n, 1.0f / length));
+					}
+				}
+			}
+			const auto sphere = MeshBounds::ComputeSphere(reinterpret_cast<const dx::XMFLOAT3*>(points.data()),
+				sizeof(dx::XMVECTOR), points.size());
+			b.radius[m] = sphere.radius;
+			b.centerX[m] = sphere.center.x;
+			b.centerY[m] = sphere.center.y;
+			b.centerZ[m] = sphere.center.z;
+
+			const float sumLength = dx::XMVectorGetX(dx::XMVector3Length(sum));
+			const auto axis = sumLength > 0.0f ? dx::XMVectorScale(sum, 1.0f / sumLength) : dx::XMVectorZero();
+			float minDot = 1.0f;
+			for (size_t i = 0; i + 2u < points.size(); i += 3u)
+			{
+				const auto n = dx::XMVector3Cross(
+					dx::XMVectorSubtract(points[i + 1u], points[i]),
+					dx::XMVectorSubtract(points[i + 2u], points[i])
+				);
+				const float length = dx::XMVectorGetX(dx::XMVector3Length(n));
+				if (length > 0.0f)
+				{
+					minDot = std::min(minDot, dx::XMVectorGetX(dx::XMVector3Dot(axis, n)) / length);
+				}
+			}
+			b.axisX[m] = dx::XMVectorGetX(axis);
+			b.axisY[m] = dx::XMVectorGetY(axis);
+			b.axisZ[m] = dx::XMVectorGetZ(axis);
+			b.cutoff[m] = sumLength > 0.0f && minDot > minConeDot ? std::sqrt(1.0f - minDot * minDot) : 1.0f;
+		}
+	});
+	return set;
+}
+
+MeshletCullStats MeshletBuilder::Cull(const MeshletSet& set, DirectX::FXMMATRIX world, DirectX::CXMMATRIX viewProj,
+	const DirectX::XMFLOAT3& eyeWorld, std::vector<IndexRange>& visible)
+{
+	// clip space planes pulled back into object space: x,y in [-w,w], z in [0,w]
+	const auto m = dx::XMMatrixTranspose(dx::XMMatrixMultiply(world, viewProj));
+	dx::XMVECTOR planes[6] = {
+		dx::XMVectorAdd(m.r[3], m.r[0]),
+		dx::XMVectorSubtract(m.r[3], m.r[0]),
+		dx::XMVectorAdd(m.r[3], m.r[1]),
+		dx::XMVectorSubtract(m.r[3], m.r[1]),
+		m.r[2],
+		dx::XMVectorSubtract(m.r[3], m.r[2]),
+	};
+	for (auto& p : planes)
+	{
+		p = dx::XMVectorDivide(p, dx::XMVector3Length(p));
+	}
+	const auto eye = dx::XMVector3TransformCoord(dx::XMLoadFloat3(&eyeWorld), dx::XMMatrixInverse(nullptr, world));
+	const auto eyeX = dx::XMVectorSplatX(eye);
+	const auto eyeY = dx::XMVectorSplatY(eye);
+	const auto eyeZ = dx::XMVectorSplatZ(eye);
+	const auto one = dx::XMVectorReplicate(1.0f);
+
+	MeshletCullStats stats = {};
+	const auto& b = set.bounds;
+	const size_t nMeshlets = set.meshlets.size();
+	const auto load = [](const std::vector<float>& stream, size_t i)
+	{
+		return dx::XMLoadFloat4(reinterpret_cast<const dx::XMFLOAT4*>(stream.data() + i));
+	};
+	for (size_t i = 0; i < nMeshlets; i += 4u)
+	{
+		const auto cx = load(b.centerX, i);
+		const auto cy = load(b.centerY, i);
+		const auto cz = load(b.centerZ, i);
+		const auto r = load(b.radius, i);
+		const auto negR = dx::XMVectorNegate(r);
+		auto inside = dx::XMVectorTrueInt();
+		for (const auto& p : planes)
+		{
+			const auto d = dx::XMVectorMultiplyAdd(dx::XMVectorSplatX(p), cx,
+				dx::XMVectorMultiplyAdd(dx::XMVectorSplatY(p), cy,
+				dx::XMVectorMultiplyAdd(dx::XMVectorSplatZ(p), cz, dx::XMVectorSplatW(p))));
+			inside = dx::XMVectorAndInt(inside, dx::XMVectorGreaterOrEqual(d, negR));
+		}
+		const auto dx_ = dx::XMVectorSubtract(cx, eyeX);
+		const auto dy = dx::XMVectorSubtract(cy, eyeY);
+		const auto dz = dx::XMVectorSubtract(cz, eyeZ);
+		const auto distance = dx::XMVectorSqrt(dx::XMVectorMultiplyAdd(dx_, dx_, dx::XMVectorMultiplyAdd(dy, dy, dx::XMVectorMultiply(dz, dz))));
+		const auto along = dx::XMVectorMultiplyAdd(dx_, load(b.axisX, i),
+			dx::XMVectorMultiplyAdd(dy, load(b.axisY, i), dx::XMVectorMultiply(dz, load(b.axisZ, i))));
+		const auto cutoff = load(b.cutoff, i);
+		const auto facingAway = dx::XMVectorGreaterOrEqual(along,
+			dx::XMVectorMultiplyAdd(cutoff, distance, dx::XMVectorMultiply(r, dx::XMVectorAdd(one, cutoff))));
+		uint32_t insideLanes[4];
+		uint32_t awayLanes[4];
+		dx::XMStoreInt4(insideLanes, inside);
+		dx::XMStoreInt4(awayLanes, facingAway);
+
+		for (size_t lane = 0; lane < 4u && i + lane < nMeshlets; lane++)
+		{
+			if (insideLanes[lane] == 0u)
+			{
+				stats.nFrustumCulled++;
+				continue;
+			}
+			if (awayLanes[lane] != 0u)
+			{
+				stats.nBackfaceCulled++;
+				continue;
+			}
+			const auto& meshlet = set.meshlets[i + lane];
+			stats.nVisible++;
+			stats.nTrianglesVisible += meshlet.nTriangles;
+			if (!visible.empty() && visible.back().firstIndex + visible.back().nIndices == meshlet.firstIndex)
+			{
+				visible.back().nIndices += meshlet.nTriangles * 3u;
+			}
+			else
+			{
+				visible.push_back({ meshlet.firstIndex,meshlet.nTriangles * 3u });
+			}
+		}
+	}
+	return stats;
+}
+
+template MeshletSet MeshletBuilder::Build<unsigned short>(std::span<unsigned short>, const DirectX::XMFLOAT3*, size_t, size_t, size_t, size_t, float);
+template MeshletSet MeshletBuilder::Build<unsigned int>(std::span<unsigned int>, const DirectX::XMFLOAT3*, size_t, size_t, size_t, size_t, float);
\ No newline at end of file
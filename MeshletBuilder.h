@@ -0,0 +1,86 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <span>
+#include <vector>
+#include <cstdint>
+
+// a cluster of triangles that is one contiguous range of the (reordered) index buffer
+struct Meshlet
+{
+	uint32_t firstIndex;
+	uint32_t nTriangles;
+	uint32_t nVertices;
+};
+
+// bounding sphere and normal cone of every meshlet, structure of arrays padded to a multiple
+// of 4 so the culling pass tests four meshlets per vector op
+// cone: axis is the average outward normal and cutoff the sine of the widest angle between it
+// and any triangle normal; the whole meshlet faces away from eye when
+//   dot(center - eye, axis) >= cutoff * length(center - eye) + radius * (1 + cutoff)
+// a cutoff of 1 marks a cone too wide to ever cull
+struct MeshletBounds
+{
+	std::vector<float> centerX;
+	std::vector<float> centerY;
+	std::vector<float> centerZ;
+	std::vector<float> radius;
+	std::vector<float> axisX;
+	std::vector<float> axisY;
+	std::vector<float> axisZ;
+	std::vector<float> cutoff;
+};
+
+struct MeshletSet
+{
+	std::vector<Meshlet> meshlets;
+	MeshletBounds bounds;
+};
+
+struct IndexRange
+{
+	uint32_t firstIndex;
+	uint32_t nIndices;
+};
+
+struct MeshletCullStats
+{
+	size_t nVisible;
+	size_t nFrustumCulled;
+	size_t nBackfaceCulled;
+	size_t nTrianglesVisible;
+};
+
+// splits a mesh into meshlets and culls them on the cpu every frame
+// index-level work is instantiated for 16-bit and 32-bit indices in MeshletBuilder.cpp
+class MeshletBuilder
+{
+public:
+	static constexpr size_t maxMeshletVertices = 64u;
+	static constexpr size_t maxMeshletTriangles = 124u;
+	// how much a triangle that bends away from the meshlet's average normal is penalized
+	// against one that needs an extra vertex; 0 builds purely for vertex reuse
+	static constexpr float defaultConeWeight = 0.25f;
+public:
+	// grows meshlets triangle by triangle over shared vertices, preferring triangles that add
+	// no new vertices and keep the normal cone tight, then rewrites indices so every meshlet
+	// is contiguous. winding is preserved
+	template<class I>
+	static MeshletSet Build(std::span<I> indices, const DirectX::XMFLOAT3* pPositions, size_t stride, size_t nVertices,
+		size_t maxVertices = maxMeshletVertices, size_t maxTriangles = maxMeshletTriangles,
+		float coneWeight = defaultConeWeight);
+	template<class V, class I>
+	static MeshletSet Build(IndexedTriangleList<V, I>& mesh,
+		size_t maxVertices = maxMeshletVertices, size_t maxTriangles = maxMeshletTriangles,
+		float coneWeight = defaultConeWeight)
+	{
+		const auto& vertices = mesh.GetVertices();
+		return Build<I>(mesh.indices, vertices.empty() ? nullptr : &vertices.front().pos, sizeof(V), vertices.size(),
+			maxVertices, maxTriangles, coneWeight);
+	}
+	// frustum (from world * viewProj) and cone test of every meshlet; survivors are appended
+	// to visible with neighbouring ranges merged, ready for one DrawIndexed apiece
+	// cone culling assumes world has no non-uniform scale
+	static MeshletCullStats Cull(const MeshletSet& set, DirectX::FXMMATRIX world, DirectX::CXMMATRIX viewProj,
+		const DirectX::XMFLOAT3& eyeWorld, std::vector<IndexRange>& visible);
+};
\ No newline at end of file
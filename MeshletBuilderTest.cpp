@@ -0,0 +1,143 @@
+#include "MeshletBuilderTest.h"
+#include "MeshletBuilder.h"
+#include "Icosphere.h"
+#include "Sphere.h"
+#include <DirectXMath.h>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace dx = DirectX;
+
+namespace
+{
+	struct Vertex
+	{
+		dx::XMFLOAT3 pos;
+	};
+
+	// triangles rotated to start at their smallest index (which keeps the winding), then sorted
+	std::vector<std::array<unsigned int, 3>> SortedTriangles(const std::pmr::vector<unsigned int>& indices)
+	{
+		std::vector<std::array<unsigned int, 3>> triangles;
+		triangles.reserve(indices.size() / 3u);
+		for (size_t i = 0; i < indices.size(); i += 3u)
+		{
+			std::array<unsigned int, 3> t = { indices[i],indices[i + 1u],indices[i + 2u] };
+			std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+			triangles.push_back(t);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	bool CheckBuild(IndexedTriangleList<Vertex, unsigned int> mesh, size_t maxVertices, size_t maxTriangles)
+	{
+		const auto triangles = SortedTriangles(mesh.indices);
+		const auto set = MeshletBuilder::Build(mesh, maxVertices, maxTriangles);
+		if (SortedTriangles(mesh.indices) != triangles)
+		{
+			return false;
+		}
+		uint32_t nextIndex = 0u;
+		for (const auto& m : set.meshlets)
+		{
+			if (m.firstIndex != nextIndex || m.nTriangles == 0u || m.nTriangles > maxTriangles || m.nVertices > maxVertices)
+			{
+				return false;
+			}
+			const auto first = mesh.indices.begin() + m.firstIndex;
+			std::vector<unsigned int> used(first, first + m.nTriangles * 3u);
+			std::sort(used.begin(), used.end());
+			if (size_t(std::unique(used.begin(), used.end()) - used.begin()) != m.nVertices)
+			{
+				return false;
+			}
+			nextIndex += m.nTriangles * 3u;
+		}
+		// bounds are padded to a multiple of 4 for the culling pass
+		const size_t nPadded = (set.meshlets.size() + 3u) & ~size_t(3u);
+		return nextIndex == mesh.indices.size() && set.bounds.radius.size() == nPadded && set.bounds.cutoff.size() == nPadded;
+	}
+
+	struct Camera
+	{
+		dx::XMFLOAT3 eye = { 0.0f,0.0f,-4.0f };
+		dx::XMMATRIX viewProj = dx::XMMatrixMultiply(
+			dx::XMMatrixLookAtLH(dx::XMVectorSet(0.0f, 0.0f, -4.0f, 1.0f), dx::XMVectorZero(), dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)),
+			dx::XMMatrixPerspectiveFovLH(1.0f, 1.0f, 0.5f, 40.0f)
+		);
+	};
+
+	bool Covered(const std::vector<IndexRange>& visible, size_t index)
+	{
+		return std::any_of(visible.begin(), visible.end(), [index](const IndexRange& r)
+		{
+			return index >= r.firstIndex && index < size_t(r.firstIndex) + r.nIndices;
+		});
+	}
+}
+
+bool MeshletBuilderTest::BuildRespectsLimits()
+{
+	return CheckBuild(Icosphere::MakeTesselated<Vertex, unsigned int>(4), MeshletBuilder::maxMeshletVertices, MeshletBuilder::maxMeshletTriangles) &&
+		CheckBuild(Icosphere::MakeTesselated<Vertex, unsigned int>(4), 32u, 40u) &&
+		CheckBuild(Sphere::MakeTesselated<Vertex, unsigned int>(40, 80), MeshletBuilder::maxMeshletVertices, MeshletBuilder::maxMeshletTriangles);
+}
+
+bool MeshletBuilderTest::CullKeepsVisibleTriangles()
+{
+	auto mesh = Icosphere::MakeTesselated<Vertex, unsigned int>(4);
+	const auto set = MeshletBuilder::Build(mesh);
+	const Camera camera;
+	// far enough right that the view's right edge cuts through the sphere
+	const auto world = dx::XMMatrixTranslation(1.6f, 0.0f, 0.0f);
+	std::vector<IndexRange> visible;
+	const auto stats = MeshletBuilder::Cull(set, world, camera.viewProj, camera.eye, visible);
+	size_t nVisibleIndices = 0u;
+	for (const auto& r : visible)
+	{
+		nVisibleIndices += r.nIndices;
+	}
+	if (stats.nVisible + stats.nFrustumCulled + stats.nBackfaceCulled != set.meshlets.size() ||
+		stats.nFrustumCulled == 0u || stats.nBackfaceCulled == 0u || stats.nVisible == 0u ||
+		nVisibleIndices != stats.nTrianglesVisible * 3u)
+	{
+		return false;
+	}
+
+	// a triangle faces the eye when its cross product normal (what the cones are built from)
+	// points towards it; such a triangle with any corner inside the clip volume has to be drawn
+	const auto worldViewProj = dx::XMMatrixMultiply(world, camera.viewProj);
+	const auto eye = dx::XMLoadFloat3(&camera.eye);
+	const auto& vertices = mesh.GetVertices();
+	for (size_t i = 0; i < mesh.indices.size(); i += 3u)
+	{
+		dx::XMVECTOR p[3];
+		bool onScreen = false;
+		for (size_t c = 0; c < 3u; c++)
+		{
+			p[c] = dx::XMVector3Transform(dx::XMLoadFloat3(&vertices[mesh.indices[i + c]].pos), world);
+			dx::XMFLOAT4 clip;
+			dx::XMStoreFloat4(&clip, dx::XMVector3Transform(dx::XMLoadFloat3(&vertices[mesh.indices[i + c]].pos), worldViewProj));
+			onScreen = onScreen || (clip.x > -clip.w && clip.x < clip.w && clip.y > -clip.w && clip.y < clip.w && clip.z > 0.0f && clip.z < clip.w);
+		}
+		const auto n = dx::XMVector3Cross(dx::XMVectorSubtract(p[1], p[0]), dx::XMVectorSubtract(p[2], p[0]));
+		const bool facesEye = dx::XMVectorGetX(dx::XMVector3Dot(n, dx::XMVectorSubtract(p[0], eye))) < 0.0f;
+		if (onScreen && facesEye && !Covered(visible, i))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool MeshletBuilderTest::CullRejectsOffScreen()
+{
+	auto mesh = Icosphere::MakeTesselated<Vertex, unsigned int>(4);
+	const auto set = MeshletBuilder::Build(mesh);
+	const Camera camera;
+	std::vector<IndexRange> visible;
+	const auto stats = MeshletBuilder::Cull(set, dx::XMMatrixTranslation(0.0f, 0.0f, -10.0f), camera.viewProj, camera.eye, visible);
+	return visible.empty() && stats.nVisible == 0u && stats.nFrustumCulled == set.meshlets.size();
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+// meshlet building and culling on the cpu; each returns whether the result held up; run by hw3dtest
+class MeshletBuilderTest
+{
+public:
+	// meshlets stay within the vertex and triangle limits (the default ones and tighter ones),
+	// tile the index buffer in order, and the rewritten indices hold the same triangles
+	// with the same winding
+	static bool BuildRespectsLimits();
+	// a sphere straddling the edge of the view: some meshlets are frustum culled, some back-face
+	// culled, and no triangle that faces the eye with a corner on screen is lost
+	static bool CullKeepsVisibleTriangles();
+	// a sphere behind the eye: every meshlet is frustum culled and nothing is emitted
+	static bool CullRejectsOffScreen();
+};
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+#include <future>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// split [0,count) into one contiguous chunk per hardware thread and call f(first,last)
+// for each chunk on a worker. ranges too small to give every worker minChunk items use
+// fewer workers, down to running inline on the calling thread
+template<class F>
+void ParallelFor(size_t count, size_t minChunk, F&& f)
+{
+	const size_t nWorkers = std::clamp<size_t>(
+		std::thread::hardware_concurrency(), 1u, std::max<size_t>(count / std::max<size_t>(minChunk, 1u), 1u)
+	);
+	if (nWorkers == 1u)
+	{
+		if (count > 0u)
+		{
+			f(size_t(0u), count);
+		}
+		return;
+	}
+	std::vector<std::future<void>> workers;
+	workers.reserve(nWorkers);
+	for (size_t i = 0; i < nWorkers; i++)
+	{
+		const size_t first = count * i / nWorkers;
+		const size_t last = count * (i + 1) / nWorkers;
+		workers.push_back(std::async(std::launch::async, [&f, first, last] { f(first, last); }));
+	}
+	// join everyone before get() can rethrow, so no worker outlives the captures
+	for (auto& w : workers)
+	{
+		w.wait();
+	}
+	for (auto& w : workers)
+	{
+		w.get();
+	}
+}
\ No newline at end of file
@@ -6,8 +6,8 @@
 class Plane
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselated(int divisions_x, int divisions_y)
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> MakeTesselated(int divisions_x, int divisions_y, std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
 	{
 		namespace dx = DirectX;
 		assert(divisions_x >= 1);
@@ -16,7 +16,8 @@ public:
 		constexpr float height = 2.0f;
 		const int nVertices_x = divisions_x + 1;
 		const int nVertices_y = divisions_y + 1;
-		std::vector<V> vertices(nVertices_x * nVertices_y);
+		IndexedTriangleList<V, I>::CheckIndexRange(size_t(nVertices_x) * nVertices_y);
+		std::pmr::vector<V> vertices(size_t(nVertices_x) * nVertices_y, pMem);
 		{
 			const float side_x = width / 2.0f;
 			const float side_y = height / 2.0f;
@@ -37,18 +38,18 @@ public:
 			}
 		}
 
-		std::vector<unsigned short> indices;
-		indices.reserve(sq(divisions_x * divisions_y) * 6);
+		std::pmr::vector<I> indices(pMem);
+		indices.reserve(size_t(divisions_x) * divisions_y * 6u);
 		{
 			const auto vxy2i = [nVertices_x](size_t x, size_t y)
 				{
-					return (unsigned short)(y * nVertices_x + x);
+					return (I)(y * nVertices_x + x);
 				};
 			for (size_t y = 0; y < divisions_y; y++)
 			{
 				for (size_t x = 0; x < divisions_x; x++)
 				{
-					const std::array<unsigned short, 4> indexArray =
+					const std::array<I, 4> indexArray =
 					{ vxy2i(x,y),vxy2i(x + 1,y),vxy2i(x,y + 1),vxy2i(x + 1,y + 1) };
 					indices.push_back(indexArray[0]);
 					indices.push_back(indexArray[2]);
@@ -61,9 +62,9 @@ public:
 		}
 		return{ std::move(vertices),std::move(indices) };
 	}
-	template<class V>
-	static IndexedTriangleList<V> Make()
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Make(std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
 	{
-		return MakeTesselated<V>(1, 1);
+		return MakeTesselated<V, I>(1, 1, pMem);
 	}
 };
\ No newline at end of file
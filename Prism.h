@@ -1,81 +1,65 @@
 #pragma once
 #include "IndexedTriangleList.h"
+#include "RevolvedSurface.h"
 #include <DirectXMath.h>
 #include "ChiliMath.h"
+#include <span>
+#include <cassert>
 class Prism
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselated(int longDiv)
+	// near and far rings plus their centers
+	static constexpr size_t VertexCount(int longDiv) noexcept
 	{
-		namespace dx = DirectX;
-		assert(longDiv >= 3);
-		const auto base = dx::XMVectorSet(1.0f, 0.0f, -1.0f, 0.0f);
-		const auto offset = dx::XMVectorSet(0.0f, 0.0f, 2.0f, 0.0f);
-		const float longitudeAngle = 2.0f * PI / longDiv;
-		// near center
-		std::vector<V> vertices;
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,-1.0f };
-		const auto iCenterNear = (unsigned short)(vertices.size() - 1);
-		// far center
-		vertices.emplace_back();
-		vertices.back().pos = { 0.0f,0.0f,1.0f };
-		const auto iCenterFar = (unsigned short)(vertices.size() - 1);
-		// base vertices
-		for (int iLong = 0; iLong < longDiv; iLong++)
-		{
-			// near base
-			{
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-			}
-			// far base
-			{
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					base,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				v = dx::XMVectorAdd(v, offset);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-			}
-		}
-
-		// side indices
-		std::vector<unsigned short> indices;
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			const auto i = iLong * 2;
-			const auto mod = longDiv * 2;
-			indices.push_back(i + 2);
-			indices.push_back((i + 2) % mod + 2);
-			indices.push_back(i + 1 + 2);
-			indices.push_back((i + 2) % mod + 2);
-			indices.push_back((i + 3) % mod + 2);
-			indices.push_back(i + 1 + 2);
-		}
-		// base indices
-		for (unsigned short iLong = 0; iLong < longDiv; iLong++)
-		{
-			const auto i = iLong * 2;
-			const auto mod = longDiv * 2;
-			indices.push_back(i + 2);
-			indices.push_back(iCenterNear);
-			indices.push_back((i + 2) % mod + 2);
-			indices.push_back(iCenterFar);
-			indices.push_back(i + 1 + 2);
-			indices.push_back((i + 3) % mod + 2);
-		}
+		return size_t(longDiv) * 2u + 2u;
+	}
+	// a side quad and a triangle in each cap per division
+	static constexpr size_t IndexCount(int longDiv) noexcept
+	{
+		return size_t(longDiv) * 12u;
+	}
+	// fills positions (V::pos, or V itself for XMFLOAT3) and indices; constexpr so fixed
+	// tessellations can be baked by MakeTable
+	template<class V, class I>
+	static constexpr void Generate(int longDiv, std::span<V> vertices, std::span<I> indices)
+	{
+		assert(vertices.size() == VertexCount(longDiv));
+		assert(indices.size() == IndexCount(longDiv));
+		RevolvedSurface<V, I> surface(longDiv, 0.0, vertices, indices);
+		const auto iNear = surface.Ring(1.0, -1.0);
+		const auto iFar = surface.Ring(1.0, 1.0);
+		const auto iCenterNear = surface.AxisPoint(-1.0);
+		const auto iCenterFar = surface.AxisPoint(1.0);
+		// sides
+		surface.Band(iFar, iNear);
+		// bases
+		surface.FanDown(iCenterNear, iNear);
+		surface.FanUp(iCenterFar, iFar);
+		assert(surface.Filled());
+	}
+	template<int longDiv, class I = unsigned int>
+	static constexpr auto MakeTable()
+	{
+		static_assert(VertexCount(longDiv) <= size_t(std::numeric_limits<I>::max()) + 1u,
+			"Prism table has more vertices than its index type can address");
+		TriangleTable<VertexCount(longDiv), IndexCount(longDiv), I> table = {};
+		Generate<DirectX::XMFLOAT3, I>(longDiv, table.positions, table.indices);
+		return table;
+	}
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> MakeTesselated(int longDiv, std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		const size_t nVertices = VertexCount(longDiv);
+		IndexedTriangleList<V, I>::CheckIndexRange(nVertices);
+		std::pmr::vector<V> vertices(nVertices, pMem);
+		std::pmr::vector<I> indices(IndexCount(longDiv), pMem);
+		Generate<V, I>(longDiv, vertices, indices);
 		return { std::move(vertices),std::move(indices) };
 	}
-	template<class V>
-	static IndexedTriangleList<V> Make()
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Make(std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
 	{
-		return MakeTesselated<V>(24);
+		static constexpr auto table = MakeTable<24, I>();
+		return IndexedTriangleList<V, I>::FromTable(table, pMem);
 	}
 };
\ No newline at end of file
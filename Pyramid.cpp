@@ -3,12 +3,14 @@
 #include "GraphicsThrowMacros.h"
 #include "Cone.h"
 Pyramid::Pyramid(Graphics& gfx,
+	std::pmr::memory_resource* pMem,
 	std::mt19937& rng,
 	std::uniform_real_distribution<float>& adist,
 	std::uniform_real_distribution<float>& ddist,
 	std::uniform_real_distribution<float>& odist,
 	std::uniform_real_distribution<float>& rdist)
 	:
+	DrawableBase(pMem),
 	r(rdist(rng)),
 	droll(ddist(rng)),
 	dpitch(ddist(rng)),
@@ -21,7 +23,7 @@ Pyramid::Pyramid(Graphics& gfx,
 	phi(adist(rng))
 {
 	namespace dx = DirectX;
-	if (!IsStaticInitialized())
+	InitializeStatic([&gfx]
 	{
 		struct Vertex
 		{
@@ -36,33 +38,31 @@ Pyramid::Pyramid(Graphics& gfx,
 		};
 		auto model = Cone::MakeTesselated<Vertex>(4);
 		// set vertex colors for mesh
-		model.vertices[0].color = { 255,255,0 };
-		model.vertices[1].color = { 255,255,0 };
-		model.vertices[2].color = { 255,255,0 };
-		model.vertices[3].color = { 255,255,0 };
-		model.vertices[4].color = { 255,255,80 };
-		model.vertices[5].color = { 255,10,0 };
+		auto& vertices = model.GetVertices();
+		vertices[0].color = { 255,255,0 };
+		vertices[1].color = { 255,255,0 };
+		vertices[2].color = { 255,255,0 };
+		vertices[3].color = { 255,255,0 };
+		vertices[4].color = { 255,255,80 };
+		vertices[5].color = { 255,10,0 };
 		// deform mesh linearly
 		model.Transform(dx::XMMatrixScaling(1.0f, 1.0f, 0.7f));
-		AddStaticBind(std::make_unique<VertexBuffer>(gfx, model.vertices));
-		auto pvs = std::make_unique<VertexShader>(gfx, L"ColorBlendVS.cso");
+		AddStaticBind(MakeStaticBind<VertexBuffer>(gfx, model));
+		auto pvs = MakeStaticBind<VertexShader>(gfx, L"ColorBlendVS.cso");
 		auto pvsbc = pvs->GetBytecode();
 		AddStaticBind(std::move(pvs));
-		AddStaticBind(std::make_unique<PixelShader>(gfx, L"ColorBlendPS.cso"));
-		AddStaticIndexBuffer(std::make_unique<IndexBuffer>(gfx, model.indices));
+		AddStaticBind(MakeStaticBind<PixelShader>(gfx, L"ColorBlendPS.cso"));
+		AddStaticIndexBuffer(MakeStaticBind<IndexBuffer>(gfx, model.indices));
 		const std::vector<D3D11_INPUT_ELEMENT_DESC> ied =
 		{
 			{ "Position",0,DXGI_FORMAT_R32G32B32_FLOAT,0,0,D3D11_INPUT_PER_VERTEX_DATA,0 },
 			{ "Color",0,DXGI_FORMAT_R8G8B8A8_UNORM,0,12,D3D11_INPUT_PER_VERTEX_DATA,0 },
 		};
-		AddStaticBind(std::make_unique<InputLayout>(gfx, ied, pvsbc));
-		AddStaticBind(std::make_unique<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
-	}
-	else
-	{
-		SetIndexFromStatic();
-	}
-	AddBind(std::make_unique<TransformCbuf>(gfx, *this));
+		AddStaticBind(MakeStaticBind<InputLayout>(gfx, ied, pvsbc));
+		AddStaticBind(MakeStaticBind<Topology>(gfx, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+	});
+	SetIndexFromStatic();
+	AddBind(MakeBind<TransformCbuf>(gfx, *this));
 }
 void Pyramid::Update(float dt) noexcept
 {
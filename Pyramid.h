@@ -4,7 +4,8 @@
 class Pyramid : public DrawableBase<Pyramid>
 {
 public:
-	Pyramid(Graphics& gfx, std::mt19937& rng,
+	Pyramid(Graphics& gfx, std::pmr::memory_resource* pMem,
+		std::mt19937& rng,
 		std::uniform_real_distribution<float>& adist,
 		std::uniform_real_distribution<float>& ddist,
 		std::uniform_real_distribution<float>& odist,
@@ -0,0 +1,153 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include "ChiliMath.h"
+#include <span>
+#include <vector>
+#include <cassert>
+
+// builds a surface of revolution about the z axis into exactly sized vertex / index spans:
+// rings of longDiv vertices at some radius and height, points on the axis, quad bands between
+// two rings and triangle fans from an axis point to a ring
+// the unit circle is evaluated once (4 angles per XMVectorSinCos at runtime) and every ring is
+// one multiply-add of it, so no vertex pays for a rotation matrix
+// constexpr so fixed tessellations can be baked at compile time
+// V is a vertex with a pos member, or XMFLOAT3 itself
+template<class V, class I>
+class RevolvedSurface
+{
+public:
+	// ring vertex j sits at angle startAngle + j * 2pi / longDiv, counter-clockwise seen from +z
+	constexpr RevolvedSurface(int longDiv, double startAngle, std::span<V> vertices, std::span<I> indices)
+		:
+		longDiv(longDiv),
+		circle(((size_t)longDiv + 3u) & ~size_t(3u)),
+		vertices(vertices),
+		indices(indices)
+	{
+		assert(longDiv >= 3);
+		const double step = 2.0 * PI_D / longDiv;
+		if (std::is_constant_evaluated())
+		{
+			for (int j = 0; j < longDiv; j++)
+			{
+				circle[j] = {
+					(float)constexpr_cos(startAngle + step * j),
+					(float)constexpr_sin(startAngle + step * j)
+				};
+			}
+		}
+		else
+		{
+			namespace dx = DirectX;
+			const auto first = dx::XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+			for (size_t j = 0; j < circle.size(); j += 4u)
+			{
+				const auto angles = dx::XMVectorMultiplyAdd(
+					dx::XMVectorAdd(first, dx::XMVectorReplicate((float)j)),
+					dx::XMVectorReplicate((float)step),
+					dx::XMVectorReplicate((float)startAngle)
+				);
+				dx::XMVECTOR s;
+				dx::XMVECTOR c;
+				dx::XMVectorSinCos(&s, &c, angles);
+				// interleave into (cos,sin) pairs, two per store
+				dx::XMStoreFloat4(reinterpret_cast<dx::XMFLOAT4*>(&circle[j]), dx::XMVectorMergeXY(c, s));
+				dx::XMStoreFloat4(reinterpret_cast<dx::XMFLOAT4*>(&circle[j + 2u]), dx::XMVectorMergeZW(c, s));
+			}
+		}
+	}
+	// writes the next longDiv vertices, returns the index of the first
+	constexpr I Ring(double radius, double z)
+	{
+		assert(nVertices + longDiv <= vertices.size());
+		const auto first = (I)nVertices;
+		if (std::is_constant_evaluated())
+		{
+			for (int j = 0; j < longDiv; j++)
+			{
+				PositionOf(vertices[nVertices++]) = {
+					(float)(radius * circle[j].x),
+					(float)(radius * circle[j].y),
+					(float)z
+				};
+			}
+		}
+		else
+		{
+			namespace dx = DirectX;
+			const auto scale = dx::XMVectorSet((float)radius, (float)radius, 0.0f, 0.0f);
+			const auto offset = dx::XMVectorSet(0.0f, 0.0f, (float)z, 0.0f);
+			for (int j = 0; j < longDiv; j++)
+			{
+				dx::XMStoreFloat3(&PositionOf(vertices[nVertices++]),
+					dx::XMVectorMultiplyAdd(dx::XMLoadFloat2(&circle[j]), scale, offset));
+			}
+		}
+		return first;
+	}
+	// writes one vertex on the axis, returns its index
+	constexpr I AxisPoint(double z)
+	{
+		assert(nVertices < vertices.size());
+		PositionOf(vertices[nVertices]) = { 0.0f,0.0f,(float)z };
+		return (I)nVertices++;
+	}
+	// quads joining two rings, front faces point away from the axis when upper has the
+	// greater z (swap the rings for a surface seen from inside)
+	constexpr void Band(I upper, I lower)
+	{
+		assert(nIndices + size_t(longDiv) * 6u <= indices.size());
+		for (int j = 0; j < longDiv - 1; j++)
+		{
+			Quad((I)(upper + j), (I)(upper + j + 1), (I)(lower + j), (I)(lower + j + 1));
+		}
+		// last quad wraps around to the first column
+		Quad((I)(upper + longDiv - 1), upper, (I)(lower + longDiv - 1), lower);
+	}
+	// fan whose front faces point toward +z: a top cap, or the side of a cone rising to apex
+	constexpr void FanUp(I apex, I ring)
+	{
+		assert(nIndices + size_t(longDiv) * 3u <= indices.size());
+		for (int j = 0; j < longDiv - 1; j++)
+		{
+			Triangle(apex, (I)(ring + j), (I)(ring + j + 1));
+		}
+		Triangle(apex, (I)(ring + longDiv - 1), ring);
+	}
+	// fan whose front faces point toward -z: a bottom cap, or a cone falling to apex
+	constexpr void FanDown(I apex, I ring)
+	{
+		assert(nIndices + size_t(longDiv) * 3u <= indices.size());
+		for (int j = 0; j < longDiv - 1; j++)
+		{
+			Triangle(apex, (I)(ring + j + 1), (I)(ring + j));
+		}
+		Triangle(apex, ring, (I)(ring + longDiv - 1));
+	}
+	// true once every vertex and index of the spans has been written
+	constexpr bool Filled() const noexcept
+	{
+		return nVertices == vertices.size() && nIndices == indices.size();
+	}
+private:
+	constexpr void Triangle(I a, I b, I c)
+	{
+		indices[nIndices++] = a;
+		indices[nIndices++] = b;
+		indices[nIndices++] = c;
+	}
+	constexpr void Quad(I upperA, I upperB, I lowerA, I lowerB)
+	{
+		Triangle(upperA, lowerA, upperB);
+		Triangle(upperB, lowerA, lowerB);
+	}
+private:
+	int longDiv;
+	// (cos,sin) of every column, padded to a multiple of 4 for the runtime fill
+	std::vector<DirectX::XMFLOAT2> circle;
+	std::span<V> vertices;
+	std::span<I> indices;
+	size_t nVertices = 0u;
+	size_t nIndices = 0u;
+};
\ No newline at end of file
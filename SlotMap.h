@@ -0,0 +1,172 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <limits>
+#include <utility>
+
+// slot map: O(1) insert / remove / lookup through generational handles, with the
+// live elements kept packed in a dense array for iteration. removing an element
+// bumps its slot generation, so stale handles resolve to nullptr instead of aliasing
+// whatever gets inserted into the recycled slot later
+template<class T>
+class SlotMap
+{
+public:
+	class Handle
+	{
+		friend class SlotMap;
+	public:
+		Handle() = default;
+		bool IsNull() const noexcept
+		{
+			return index == npos;
+		}
+		bool operator==(const Handle& rhs) const noexcept
+		{
+			return index == rhs.index && generation == rhs.generation;
+		}
+		bool operator!=(const Handle& rhs) const noexcept
+		{
+			return !(*this == rhs);
+		}
+	private:
+		Handle(uint32_t index, uint32_t generation) noexcept
+			:
+			index(index),
+			generation(generation)
+		{
+		}
+	private:
+		uint32_t index = npos;
+		uint32_t generation = 0u;
+	};
+public:
+	SlotMap() = default;
+	SlotMap(size_t capacity)
+	{
+		Reserve(capacity);
+	}
+	// preallocate so that inserting up to capacity elements never reallocates
+	void Reserve(size_t capacity)
+	{
+		assert("SlotMap capacity exceeds handle range" && capacity < npos);
+		slots.reserve(capacity);
+		dense.reserve(capacity);
+		denseToSlot.reserve(capacity);
+	}
+	template<class... Args>
+	Handle Emplace(Args&&... args)
+	{
+		uint32_t iSlot;
+		if (freeHead != npos)
+		{
+			iSlot = freeHead;
+			freeHead = slots[iSlot].index;
+		}
+		else
+		{
+			assert("SlotMap handle range exhausted" && slots.size() < npos);
+			iSlot = (uint32_t)slots.size();
+			slots.push_back({ 0u,0u });
+		}
+		dense.emplace_back(std::forward<Args>(args)...);
+		denseToSlot.push_back(iSlot);
+		slots[iSlot].index = uint32_t(dense.size() - 1u);
+		return { iSlot,slots[iSlot].generation };
+	}
+	Handle Insert(T value)
+	{
+		return Emplace(std::move(value));
+	}
+	// swap-with-last removal; invalidates the handle and keeps the dense array packed
+	bool Remove(Handle h)
+	{
+		if (!Contains(h))
+		{
+			return false;
+		}
+		auto& slot = slots[h.index];
+		const uint32_t iDense = slot.index;
+		if (iDense != dense.size() - 1u)
+		{
+			dense[iDense] = std::move(dense.back());
+			denseToSlot[iDense] = denseToSlot.back();
+			slots[denseToSlot[iDense]].index = iDense;
+		}
+		dense.pop_back();
+		denseToSlot.pop_back();
+		slot.generation++;
+		slot.index = freeHead;
+		freeHead = h.index;
+		return true;
+	}
+	bool Contains(Handle h) const noexcept
+	{
+		return h.index < slots.size() && slots[h.index].generation == h.generation &&
+			slots[h.index].index < dense.size() && denseToSlot[slots[h.index].index] == h.index;
+	}
+	T* Get(Handle h) noexcept
+	{
+		return Contains(h) ? &dense[slots[h.index].index] : nullptr;
+	}
+	const T* Get(Handle h) const noexcept
+	{
+		return Contains(h) ? &dense[slots[h.index].index] : nullptr;
+	}
+	// handle of the element currently at position i of the dense array
+	Handle HandleAt(size_t i) const noexcept
+	{
+		assert(i < dense.size());
+		const auto iSlot = denseToSlot[i];
+		return { iSlot,slots[iSlot].generation };
+	}
+	void Clear()
+	{
+		while (!dense.empty())
+		{
+			Remove(HandleAt(dense.size() - 1u));
+		}
+	}
+	size_t Size() const noexcept
+	{
+		return dense.size();
+	}
+	bool Empty() const noexcept
+	{
+		return dense.empty();
+	}
+	size_t Capacity() const noexcept
+	{
+		return dense.capacity();
+	}
+	auto begin() noexcept
+	{
+		return dense.begin();
+	}
+	auto end() noexcept
+	{
+		return dense.end();
+	}
+	auto begin() const noexcept
+	{
+		return dense.begin();
+	}
+	auto end() const noexcept
+	{
+		return dense.end();
+	}
+private:
+	static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+	struct Slot
+	{
+		// dense index while occupied, next free slot while on the free list
+		uint32_t index;
+		uint32_t generation;
+	};
+	std::vector<Slot> slots;
+	std::vector<T> dense;
+	std::vector<uint32_t> denseToSlot;
+	uint32_t freeHead = npos;
+};
\ No newline at end of file
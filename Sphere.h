@@ -1,93 +1,76 @@
 #pragma once
 #include "IndexedTriangleList.h"
+#include "RevolvedSurface.h"
 #include <DirectXMath.h>
 #include "ChiliMath.h"
+#include <span>
+#include <cassert>
 class Sphere
 {
 public:
-	template<class V>
-	static IndexedTriangleList<V> MakeTesselated(int latDiv, int longDiv)
+	// (latDiv - 1) rings of longDiv vertices plus the two poles
+	static constexpr size_t VertexCount(int latDiv, int longDiv) noexcept
+	{
+		return size_t(latDiv - 1) * longDiv + 2u;
+	}
+	// (latDiv - 2) bands of longDiv quads plus two caps of longDiv triangles
+	static constexpr size_t IndexCount(int latDiv, int longDiv) noexcept
+	{
+		return size_t(latDiv - 1) * longDiv * 6u;
+	}
+	// fills positions (V::pos, or V itself for XMFLOAT3) and indices; constexpr so fixed
+	// tessellations can be baked by MakeTable
+	template<class V, class I>
+	static constexpr void Generate(int latDiv, int longDiv, std::span<V> vertices, std::span<I> indices)
 	{
-		namespace dx = DirectX;
 		assert(latDiv >= 3);
-		assert(longDiv >= 3);
-		constexpr float radius = 1.0f;
-		const auto base = dx::XMVectorSet(0.0f, 0.0f, radius, 0.0f);
-		const float lattitudeAngle = PI / latDiv;
-		const float longitudeAngle = 2.0f * PI / longDiv;
-		std::vector<V> vertices;
+		assert(vertices.size() == VertexCount(latDiv, longDiv));
+		assert(indices.size() == IndexCount(latDiv, longDiv));
+		constexpr double radius = 1.0;
+		const double lattitudeAngle = PI_D / latDiv;
+		// columns start at -y, where (0,0,r) rotated about x then z lands
+		RevolvedSurface<V, I> surface(longDiv, -PI_D / 2.0, vertices, indices);
 		for (int iLat = 1; iLat < latDiv; iLat++)
 		{
-			const auto latBase = dx::XMVector3Transform(
-				base,
-				dx::XMMatrixRotationX(lattitudeAngle * iLat)
-			);
-			for (int iLong = 0; iLong < longDiv; iLong++)
-			{
-				vertices.emplace_back();
-				auto v = dx::XMVector3Transform(
-					latBase,
-					dx::XMMatrixRotationZ(longitudeAngle * iLong)
-				);
-				dx::XMStoreFloat3(&vertices.back().pos, v);
-			}
+			surface.Ring(radius * constexpr_sin(lattitudeAngle * iLat), radius * constexpr_cos(lattitudeAngle * iLat));
 		}
 		// add the cap vertices
-		const auto iNorthPole = (unsigned short)vertices.size();
-		vertices.emplace_back();
-		dx::XMStoreFloat3(&vertices.back().pos, base);
-		const auto iSouthPole = (unsigned short)vertices.size();
-		vertices.emplace_back();
-		dx::XMStoreFloat3(&vertices.back().pos, dx::XMVectorNegate(base));
+		const auto iNorthPole = surface.AxisPoint(radius);
+		const auto iSouthPole = surface.AxisPoint(-radius);
 
-		const auto calcIdx = [latDiv, longDiv](unsigned short iLat, unsigned short iLong)
-			{ return iLat * longDiv + iLong; };
-		std::vector<unsigned short> indices;
-		for (unsigned short iLat = 0; iLat < latDiv - 2; iLat++)
-		{
-			for (unsigned short iLong = 0; iLong < longDiv - 1; iLong++)
-			{
-				indices.push_back(calcIdx(iLat, iLong));
-				indices.push_back(calcIdx(iLat + 1, iLong));
-				indices.push_back(calcIdx(iLat, iLong + 1));
-				indices.push_back(calcIdx(iLat, iLong + 1));
-				indices.push_back(calcIdx(iLat + 1, iLong));
-				indices.push_back(calcIdx(iLat + 1, iLong + 1));
-			}
-			// wrap band
-			indices.push_back(calcIdx(iLat, longDiv - 1));
-			indices.push_back(calcIdx(iLat + 1, longDiv - 1));
-			indices.push_back(calcIdx(iLat, 0));
-			indices.push_back(calcIdx(iLat, 0));
-			indices.push_back(calcIdx(iLat + 1, longDiv - 1));
-			indices.push_back(calcIdx(iLat + 1, 0));
-		}
-		// cap fans
-		for (unsigned short iLong = 0; iLong < longDiv - 1; iLong++)
+		const auto ringStart = [longDiv](int iLat)
+			{ return (I)(iLat * longDiv); };
+		for (int iLat = 0; iLat < latDiv - 2; iLat++)
 		{
-			// north
-			indices.push_back(iNorthPole);
-			indices.push_back(calcIdx(0, iLong));
-			indices.push_back(calcIdx(0, iLong + 1));
-			// south
-			indices.push_back(calcIdx(latDiv - 2, iLong + 1));
-			indices.push_back(calcIdx(latDiv - 2, iLong));
-			indices.push_back(iSouthPole);
+			surface.Band(ringStart(iLat), ringStart(iLat + 1));
 		}
-		// wrap triangles
-		// north
-		indices.push_back(iNorthPole);
-		indices.push_back(calcIdx(0, longDiv - 1));
-		indices.push_back(calcIdx(0, 0));
-		// south
-		indices.push_back(calcIdx(latDiv - 2, 0));
-		indices.push_back(calcIdx(latDiv - 2, longDiv - 1));
-		indices.push_back(iSouthPole);
+		surface.FanUp(iNorthPole, ringStart(0));
+		surface.FanDown(iSouthPole, ringStart(latDiv - 2));
+		assert(surface.Filled());
+	}
+	template<int latDiv, int longDiv, class I = unsigned int>
+	static constexpr auto MakeTable()
+	{
+		static_assert(VertexCount(latDiv, longDiv) <= size_t(std::numeric_limits<I>::max()) + 1u,
+			"Sphere table has more vertices than its index type can address");
+		TriangleTable<VertexCount(latDiv, longDiv), IndexCount(latDiv, longDiv), I> table = {};
+		Generate<DirectX::XMFLOAT3, I>(latDiv, longDiv, table.positions, table.indices);
+		return table;
+	}
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> MakeTesselated(int latDiv, int longDiv, std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
+	{
+		const size_t nVertices = VertexCount(latDiv, longDiv);
+		IndexedTriangleList<V, I>::CheckIndexRange(nVertices);
+		std::pmr::vector<V> vertices(nVertices, pMem);
+		std::pmr::vector<I> indices(IndexCount(latDiv, longDiv), pMem);
+		Generate<V, I>(latDiv, longDiv, vertices, indices);
 		return { std::move(vertices),std::move(indices) };
 	}
-	template<class V>
-	static IndexedTriangleList<V> Make()
+	template<class V, class I = unsigned int>
+	static IndexedTriangleList<V, I> Make(std::pmr::memory_resource* pMem = std::pmr::get_default_resource())
 	{
-		return MakeTesselated<V>(12, 24);
+		static constexpr auto table = MakeTable<12, 24, I>();
+		return IndexedTriangleList<V, I>::FromTable(table, pMem);
 	}
 };
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "StreamTransform.h"
+#include "ParallelFor.h"
+#include <algorithm>
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr size_t minChunkVertices = 16384u;
+
+	dx::XMFLOAT3& Element(dx::XMFLOAT3* p, size_t stride, size_t i) noexcept
+	{
+		return *reinterpret_cast<dx::XMFLOAT3*>(reinterpret_cast<char*>(p) + i * stride);
+	}
+
+	// matrix elements splatted once per stream: row r, column c
+	struct SplatMatrix
+	{
+		SplatMatrix(dx::FXMMATRIX m) noexcept
+		{
+			for (size_t r = 0; r < 4u; r++)
+			{
+				e[r][0] = dx::XMVectorSplatX(m.r[r]);
+				e[r][1] = dx::XMVectorSplatY(m.r[r]);
+				e[r][2] = dx::XMVectorSplatZ(m.r[r]);
+			}
+		}
+		// column c of (x,y,z,1) * m for four vertices at once
+		dx::XMVECTOR Column(size_t c, dx::FXMVECTOR x, dx::FXMVECTOR y, dx::FXMVECTOR z) const noexcept
+		{
+			return dx::XMVectorMultiplyAdd(x, e[0][c], dx::XMVectorMultiplyAdd(y, e[1][c], dx::XMVectorMultiplyAdd(z, e[2][c], e[3][c])));
+		}
+		dx::XMVECTOR e[4][3];
+	};
+
+	// f(x,y,z) takes and returns four vertices as x / y / z vectors; the tail that doesn't fill
+	// a batch of four is padded with copies of the last vertex
+	template<class F>
+	void ForEachBatch(dx::XMFLOAT3* pStream, size_t stride, size_t count, F&& f)
+	{
+		ParallelFor(count, minChunkVertices, [=, &f](size_t first, size_t last)
+		{
+			for (size_t i = first; i < last; i += 4u)
+			{
+				const size_t n = std::min<size_t>(last - i, 4u);
+				dx::XMVECTOR v[4];
+				for (size_t k = 0; k < 4u; k++)
+				{
+					v[k] = dx::XMLoadFloat3(&Element(pStream, stride, i + std::min(k, n - 1u)));
+				}
+				// 4x3 transpose: (a,b,c,d) -> (x,y,z)
+				const auto ac = dx::XMVectorMergeXY(v[0], v[2]);
+				const auto bd = dx::XMVectorMergeXY(v[1], v[3]);
+				const auto acZ = dx::XMVectorMergeZW(v[0], v[2]);
+				const auto bdZ = dx::XMVectorMergeZW(v[1], v[3]);
+				dx::XMVECTOR out[3];
+				f(dx::XMVectorMergeXY(ac, bd), dx::XMVectorMergeZW(ac, bd), dx::XMVectorMergeXY(acZ, bdZ), out);
+				// and back
+				const auto xz = dx::XMVectorMergeXY(out[0], out[2]);
+				const auto y0 = dx::XMVectorMergeXY(out[1], dx::XMVectorZero());
+				const auto xzHigh = dx::XMVectorMergeZW(out[0], out[2]);
+				const auto y0High = dx::XMVectorMergeZW(out[1], dx::XMVectorZero());
+				v[0] = dx::XMVectorMergeXY(xz, y0);
+				v[1] = dx::XMVectorMergeZW(xz, y0);
+				v[2] = dx::XMVectorMergeXY(xzHigh, y0High);
+				v[3] = dx::XMVectorMergeZW(xzHigh, y0High);
+				for (size_t k = 0; k < n; k++)
+				{
+					dx::XMStoreFloat3(&Element(pStream, stride, i + k), v[k]);
+				}
+			}
+		});
+	}
+}
+
+void StreamTransform::Points(DirectX::XMFLOAT3* pStream, size_t stride, size_t count, DirectX::FXMMATRIX matrix)
+{
+	const SplatMatrix m(matrix);
+	ForEachBatch(pStream, stride, count, [&m](dx::FXMVECTOR x, dx::FXMVECTOR y, dx::FXMVECTOR z, dx::XMVECTOR* out)
+	{
+		out[0] = m.Column(0u, x, y, z);
+		out[1] = m.Column(1u, x, y, z);
+		out[2] = m.Column(2u, x, y, z);
+	});
+}
+
+void StreamTransform::Normals(DirectX::XMFLOAT3* pStream, size_t stride, size_t count, DirectX::FXMMATRIX matrix)
+{
+	// translation doesn't apply to directions
+	auto linear = matrix;
+	for (size_t r = 0; r < 3u; r++)
+	{
+		linear.r[r] = dx::XMVectorSetW(linear.r[r], 0.0f);
+	}
+	linear.r[3] = dx::XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+	const SplatMatrix m(dx::XMMatrixTranspose(dx::XMMatrixInverse(nullptr, linear)));
+	ForEachBatch(pStream, stride, count, [&m](dx::FXMVECTOR x, dx::FXMVECTOR y, dx::FXMVECTOR z, dx::XMVECTOR* out)
+	{
+		const auto nx = m.Column(0u, x, y, z);
+		const auto ny = m.Column(1u, x, y, z);
+		const auto nz = m.Column(2u, x, y, z);
+		const auto lengthSq = dx::XMVectorMultiplyAdd(nx, nx, dx::XMVectorMultiplyAdd(ny, ny, dx::XMVectorMultiply(nz, nz)));
+		const auto zero = dx::XMVectorZero();
+		const auto scale = dx::XMVectorSelect(zero, dx::XMVectorDivide(dx::XMVectorReplicate(1.0f), dx::XMVectorSqrt(lengthSq)),
+			dx::XMVectorGreater(lengthSq, zero));
+		out[0] = dx::XMVectorMultiply(nx, scale);
+		out[1] = dx::XMVectorMultiply(ny, scale);
+		out[2] = dx::XMVectorMultiply(nz, scale);
+	});
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstddef>
+
+// in-place transforms of strided XMFLOAT3 streams, so one attribute of an interleaved vertex
+// buffer can be transformed without touching the rest
+// vertices are gathered four at a time into x / y / z vectors, transformed with one
+// multiply-add per matrix element for all four, and scattered back; large streams are split
+// into chunks across workers
+class StreamTransform
+{
+public:
+	// p' = (p,1) * matrix, without the divide by w (matrix is taken to be affine)
+	static void Points(DirectX::XMFLOAT3* pStream, size_t stride, size_t count, DirectX::FXMMATRIX matrix);
+	// n' = normalize(n * inverse transpose of the 3x3 part of matrix), pass the same matrix the
+	// points went through. zero normals stay zero
+	static void Normals(DirectX::XMFLOAT3* pStream, size_t stride, size_t count, DirectX::FXMMATRIX matrix);
+};
\ No newline at end of file
@@ -0,0 +1,472 @@
+#include "SubdivisionSurface.h"
+#include "MeshAdjacency.h"
+#include "ParallelFor.h"
+#include "ChiliMath.h"
+#include <unordered_map>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cassert>
+
+namespace dx = DirectX;
+
+namespace
+{
+	constexpr size_t minChunkRows = 4096u;
+	constexpr uint32_t none = MeshAdjacency::none;
+
+	// stencils while building: weights in double, since composing levels sums many small products
+	struct Entry
+	{
+		uint32_t source;
+		double weight;
+	};
+	struct Stencils
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<Entry> entries;
+		size_t GetRowCount() const noexcept
+		{
+			return offsets.size() - 1u;
+		}
+	};
+
+	// rows [0,nRows) from emit(row,add), add(source,weight) called any number of times per row;
+	// rows are built in one chunk per worker, then sorted by source with repeats summed, and the
+	// chunks stitched together in order
+	template<class F>
+	Stencils BuildRows(size_t nRows, F&& emit)
+	{
+		const size_t nThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1u);
+		const size_t nChunks = std::clamp<size_t>(nRows / minChunkRows, 1u, nThreads);
+		std::vector<Stencils> chunks(nChunks);
+		ParallelFor(nChunks, 1u, [&](size_t firstChunk, size_t lastChunk)
+		{
+			for (size_t chunk = firstChunk; chunk < lastChunk; chunk++)
+			{
+				const size_t first = nRows * chunk / nChunks;
+				const size_t last = nRows * (chunk + 1u) / nChunks;
+				auto& out = chunks[chunk];
+				out.offsets.reserve(last - first + 1u);
+				out.offsets.push_back(0u);
+				const auto add = [&out](uint32_t source, double weight)
+				{
+					out.entries.push_back({ source,weight });
+				};
+				for (size_t r = first; r < last; r++)
+				{
+					emit(r, add);
+					const auto begin = out.entries.begin() + out.offsets.back();
+					std::sort(begin, out.entries.end(), [](const Entry& a, const Entry& b)
+					{
+						return a.source < b.source;
+					});
+					auto kept = begin;
+					for (auto i = begin; i != out.entries.end(); ++i)
+					{
+						if (kept != begin && (kept - 1)->source == i->source)
+						{
+							(kept - 1)->weight += i->weight;
+						}
+						else
+						{
+							*kept++ = *i;
+						}
+					}
+					out.entries.erase(kept, out.entries.end());
+					out.offsets.push_back((uint32_t)out.entries.size());
+				}
+			}
+		});
+		Stencils stencils;
+		stencils.offsets.resize(nRows + 1u);
+		std::vector<size_t> bases(nChunks);
+		size_t nEntries = 0u;
+		for (size_t chunk = 0; chunk < nChunks; chunk++)
+		{
+			bases[chunk] = nEntries;
+			nEntries += chunks[chunk].entries.size();
+		}
+		assert("too many stencil terms for 32-bit offsets" && nEntries <= 0xFFFFFFFFu);
+		stencils.entries.resize(nEntries);
+		ParallelFor(nChunks, 1u, [&](size_t firstChunk, size_t lastChunk)
+		{
+			for (size_t chunk = firstChunk; chunk < lastChunk; chunk++)
+			{
+				const size_t first = nRows * chunk / nChunks;
+				const auto& in = chunks[chunk];
+				for (size_t i = 1; i < in.offsets.size(); i++)
+				{
+					stencils.offsets[first + i] = uint32_t(bases[chunk] + in.offsets[i]);
+				}
+				std::copy(in.entries.begin(), in.entries.end(), stencils.entries.begin() + bases[chunk]);
+			}
+		});
+		return stencils;
+	}
+
+	// rows of step * previous, refined vertices of this level over the control vertices
+	Stencils Compose(const Stencils& step, const Stencils& previous)
+	{
+		return BuildRows(step.GetRowCount(), [&](size_t r, const auto& add)
+		{
+			for (uint32_t i = step.offsets[r]; i < step.offsets[r + 1u]; i++)
+			{
+				const auto& outer = step.entries[i];
+				for (uint32_t j = previous.offsets[outer.source]; j < previous.offsets[outer.source + 1u]; j++)
+				{
+					add(previous.entries[j].source, outer.weight * previous.entries[j].weight);
+				}
+			}
+		});
+	}
+
+	// the mesh one level down, as stencils over this level's vertices and the refined indices
+	class Level
+	{
+	public:
+		Level(std::span<const uint32_t> indices_in, size_t nVertices, SubdivisionScheme scheme_in)
+			:
+			scheme(scheme_in),
+			indices(indices_in),
+			adjacency(indices_in, nVertices),
+			nCornersAt(nVertices),
+			faceOf(adjacency.GetTriangleCount()),
+			edgeOf(indices_in.size())
+		{
+			for (const auto v : indices)
+			{
+				nCornersAt[v]++;
+			}
+			FindFaces();
+			NumberEdges();
+		}
+		Stencils MakeStencils() const
+		{
+			const size_t nVertices = adjacency.GetVertexCount();
+			const size_t nEdges = edgeCorners.size();
+			const size_t nRows = nVertices + nEdges + (scheme == SubdivisionScheme::CatmullClark ? GetFaceCount() : 0u);
+			return BuildRows(nRows, [&](size_t r, const auto& add)
+			{
+				if (r < nVertices)
+				{
+					VertexRow(uint32_t(r), add);
+				}
+				else if (r < nVertices + nEdges)
+				{
+					EdgeRow(edgeCorners[r - nVertices], add);
+				}
+				else
+				{
+					const uint32_t f = uint32_t(r - nVertices - nEdges);
+					const double weight = 1.0 / double(FaceSize(f));
+					ForEachFaceVertex(f, [&](uint32_t v) { add(v, weight); });
+				}
+			});
+		}
+		std::vector<uint32_t> MakeIndices() const
+		{
+			const uint32_t edgeBase = uint32_t(adjacency.GetVertexCount());
+			std::vector<uint32_t> refined;
+			if (scheme == SubdivisionScheme::Loop)
+			{
+				// corner, the midpoints of its two edges; then the middle triangle of midpoints
+				refined.resize(indices.size() * 4u);
+				ParallelFor(adjacency.GetTriangleCount(), minChunkRows, [&](size_t first, size_t last)
+				{
+					for (size_t t = first; t < last; t++)
+					{
+						const uint32_t c = uint32_t(t * 3u);
+						const uint32_t e[3] = { edgeBase + edgeOf[c],edgeBase + edgeOf[c + 1u],edgeBase + edgeOf[c + 2u] };
+						uint32_t* pOut = &refined[t * 12u];
+						for (uint32_t k = 0; k < 3u; k++)
+						{
+							*pOut++ = indices[c + k];
+							*pOut++ = e[k];
+							*pOut++ = e[(k + 2u) % 3u];
+						}
+						*pOut++ = e[0];
+						*pOut++ = e[1];
+						*pOut++ = e[2];
+					}
+				});
+			}
+			else
+			{
+				// a quad (corner, edge point, face point, edge point) per face side, as two
+				// triangles over the corner - face point diagonal
+				const uint32_t faceBase = edgeBase + uint32_t(edgeCorners.size());
+				std::vector<size_t> firstIndex(GetFaceCount() + 1u);
+				for (uint32_t f = 0; f < GetFaceCount(); f++)
+				{
+					firstIndex[f + 1u] = firstIndex[f] + FaceSize(f) * 6u;
+				}
+				refined.resize(firstIndex.back());
+				ParallelFor(GetFaceCount(), minChunkRows, [&](size_t first, size_t last)
+				{
+					for (size_t f = first; f < last; f++)
+					{
+						const auto& sides = faceSides[f];
+						const size_t n = FaceSize(uint32_t(f));
+						const uint32_t center = faceBase + uint32_t(f);
+						uint32_t* pOut = &refined[firstIndex[f]];
+						for (size_t k = 0; k < n; k++)
+						{
+							const uint32_t corner = indices[sides[k]];
+							const uint32_t next = edgeBase + edgeOf[sides[k]];
+							const uint32_t prev = edgeBase + edgeOf[sides[(k + n - 1u) % n]];
+							*pOut++ = corner;
+							*pOut++ = next;
+							*pOut++ = center;
+							*pOut++ = corner;
+							*pOut++ = center;
+							*pOut++ = prev;
+						}
+					}
+				});
+			}
+			return refined;
+		}
+	private:
+		size_t GetFaceCount() const noexcept
+		{
+			return faceSides.size();
+		}
+		size_t FaceSize(uint32_t f) const noexcept
+		{
+			return faceSides[f][3] == none ? 3u : 4u;
+		}
+		template<class F>
+		void ForEachFaceVertex(uint32_t face, F&& f) const
+		{
+			const size_t n = FaceSize(face);
+			for (size_t k = 0; k < n; k++)
+			{
+				f(indices[faceSides[face][k]]);
+			}
+		}
+		// the edge between the two triangles of a quad
+		bool IsDiagonal(uint32_t corner) const noexcept
+		{
+			const uint32_t twin = adjacency.Twin(corner);
+			return twin != none && faceOf[MeshAdjacency::Triangle(corner)] == faceOf[MeshAdjacency::Triangle(twin)];
+		}
+		// faces as the corners starting each side, in winding order
+		void FindFaces()
+		{
+			const uint32_t nTriangles = uint32_t(adjacency.GetTriangleCount());
+			for (uint32_t t = 0; t < nTriangles; t++)
+			{
+				const uint32_t c = t * 3u;
+				faceOf[t] = uint32_t(faceSides.size());
+				if (scheme == SubdivisionScheme::CatmullClark && t + 1u < nTriangles)
+				{
+					// triangle (a,b,c) whose edge a->b has its twin b->a in the next triangle (b,a,d)
+					// makes the quad a,d,b,c
+					uint32_t k = 0;
+					while (k < 3u && adjacency.Twin(c + k) / 3u != t + 1u)
+					{
+						k++;
+					}
+					if (k < 3u)
+					{
+						const uint32_t j = adjacency.Twin(c + k);
+						faceSides.push_back({ MeshAdjacency::Next(j),MeshAdjacency::Prev(j),
+							MeshAdjacency::Next(c + k),MeshAdjacency::Prev(c + k) });
+						faceOf[t + 1u] = faceOf[t];
+						t++;
+						continue;
+					}
+				}
+				faceSides.push_back({ c,c + 1u,c + 2u,none });
+			}
+		}
+		// one refined vertex per edge, except quad diagonals; half-edges on a non-manifold edge
+		// have no twin to pair with, so they find each other by their vertices
+		void NumberEdges()
+		{
+			std::unordered_map<uint64_t, uint32_t> nonManifoldEdges;
+			for (uint32_t c = 0; c < indices.size(); c++)
+			{
+				if (scheme == SubdivisionScheme::CatmullClark && IsDiagonal(c))
+				{
+					edgeOf[c] = none;
+					continue;
+				}
+				const uint32_t twin = adjacency.Twin(c);
+				if (twin != none)
+				{
+					if (c < twin)
+					{
+						edgeOf[c] = edgeOf[twin] = uint32_t(edgeCorners.size());
+						edgeCorners.push_back(c);
+					}
+				}
+				else if (adjacency.IsNonManifold(c))
+				{
+					const uint32_t a = adjacency.Origin(c);
+					const uint32_t b = adjacency.Target(c);
+					const auto [i, inserted] = nonManifoldEdges.try_emplace(
+						(uint64_t(std::min(a, b)) << 32) | std::max(a, b), uint32_t(edgeCorners.size()));
+					if (inserted)
+					{
+						edgeCorners.push_back(c);
+					}
+					edgeOf[c] = i->second;
+				}
+				else
+				{
+					edgeOf[c] = uint32_t(edgeCorners.size());
+					edgeCorners.push_back(c);
+				}
+			}
+		}
+		template<class A>
+		void VertexRow(uint32_t v, const A& add) const
+		{
+			const uint32_t first = adjacency.OutgoingCorner(v);
+			uint32_t last = none;
+			uint32_t nCorners = 0u;
+			uint32_t nFaces = 0u;
+			adjacency.ForEachOutgoing(v, [&](uint32_t corner)
+			{
+				last = corner;
+				nCorners++;
+				// every face around v starts at the one edge of it leaving v that isn't a diagonal
+				nFaces += (scheme == SubdivisionScheme::Loop || !IsDiagonal(corner)) ? 1u : 0u;
+			});
+			// unused, on more than one fan (non-manifold), or a corner of a single face
+			if (first == none || nCorners != nCornersAt[v] || (adjacency.Twin(first) == none && nFaces == 1u))
+			{
+				add(v, 1.0);
+				return;
+			}
+			if (adjacency.Twin(first) == none)
+			{
+				add(v, 0.75);
+				add(adjacency.Target(first), 0.125);
+				add(adjacency.Origin(MeshAdjacency::Prev(last)), 0.125);
+				return;
+			}
+			const double n = double(nFaces);
+			if (scheme == SubdivisionScheme::Loop)
+			{
+				// Loop's original weights
+				const double w = 0.375 + 0.25 * std::cos(2.0 * PI_D / n);
+				const double beta = (0.625 - w * w) / n;
+				add(v, 1.0 - n * beta);
+				adjacency.ForEachOneRing(v, [&](uint32_t u) { add(u, beta); });
+				return;
+			}
+			// (Q + 2R + (n - 3)v) / n, Q the average face point and R the average edge midpoint
+			add(v, (n - 3.0) / n);
+			const double weight = 1.0 / (n * n);
+			adjacency.ForEachOutgoing(v, [&](uint32_t corner)
+			{
+				if (IsDiagonal(corner))
+				{
+					return;
+				}
+				add(v, weight);
+				add(adjacency.Target(corner), weight);
+				const uint32_t f = faceOf[MeshAdjacency::Triangle(corner)];
+				const double faceWeight = weight / double(FaceSize(f));
+				ForEachFaceVertex(f, [&](uint32_t u) { add(u, faceWeight); });
+			});
+		}
+		template<class A>
+		void EdgeRow(uint32_t corner, const A& add) const
+		{
+			const uint32_t a = adjacency.Origin(corner);
+			const uint32_t b = adjacency.Target(corner);
+			const uint32_t twin = adjacency.Twin(corner);
+			if (twin == none)
+			{
+				add(a, 0.5);
+				add(b, 0.5);
+			}
+			else if (scheme == SubdivisionScheme::Loop)
+			{
+				add(a, 0.375);
+				add(b, 0.375);
+				add(adjacency.Origin(MeshAdjacency::Prev(corner)), 0.125);
+				add(adjacency.Origin(MeshAdjacency::Prev(twin)), 0.125);
+			}
+			else
+			{
+				// average of the endpoints and the face points on either side
+				add(a, 0.25);
+				add(b, 0.25);
+				for (const uint32_t side : { corner,twin })
+				{
+					const uint32_t f = faceOf[MeshAdjacency::Triangle(side)];
+					const double weight = 0.25 / double(FaceSize(f));
+					ForEachFaceVertex(f, [&](uint32_t u) { add(u, weight); });
+				}
+			}
+		}
+	private:
+		SubdivisionScheme scheme;
+		std::span<const uint32_t> indices;
+		MeshAdjacency adjacency;
+		std::vector<uint32_t> nCornersAt;
+		std::vector<uint32_t> faceOf;
+		std::vector<std::array<uint32_t, 4>> faceSides;
+		std::vector<uint32_t> edgeOf;
+		std::vector<uint32_t> edgeCorners;
+	};
+}
+
+template<class I>
+SubdivisionSurface::SubdivisionSurface(std::span<const I> indices_in, size_t nVertices, SubdivisionScheme scheme, int levels)
+	:
+	indices(indices_in.begin(), indices_in.end()),
+	nControlVertices(nVertices)
+{
+	assert("index count must be a multiple of 3" && indices_in.size() % 3u == 0u);
+	assert(levels >= 0 && levels <= maxLevels);
+	// level 0 is the identity
+	Stencils stencils = BuildRows(nVertices, [](size_t r, const auto& add)
+	{
+		add(uint32_t(r), 1.0);
+	});
+	for (int level = 0; level < levels; level++)
+	{
+		const Level step(indices, stencils.GetRowCount(), scheme);
+		auto stepStencils = step.MakeStencils();
+		indices = step.MakeIndices();
+		stencils = level == 0 ? std::move(stepStencils) : Compose(stepStencils, stencils);
+	}
+	rowOffsets = std::move(stencils.offsets);
+	terms.resize(stencils.entries.size());
+	ParallelFor(terms.size(), minChunkRows, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			terms[i] = { stencils.entries[i].source,float(stencils.entries[i].weight) };
+		}
+	});
+}
+
+void SubdivisionSurface::Refine(const dx::XMFLOAT3* pControl, size_t controlStride, dx::XMFLOAT3* pRefined, size_t refinedStride) const
+{
+	const char* pSource = reinterpret_cast<const char*>(pControl);
+	char* pTarget = reinterpret_cast<char*>(pRefined);
+	ParallelFor(GetVertexCount(), minChunkRows, [=, this](size_t first, size_t last)
+	{
+		for (size_t r = first; r < last; r++)
+		{
+			auto sum = dx::XMVectorZero();
+			for (uint32_t i = rowOffsets[r]; i < rowOffsets[r + 1u]; i++)
+			{
+				const auto& term = terms[i];
+				const auto p = dx::XMLoadFloat3(reinterpret_cast<const dx::XMFLOAT3*>(pSource + term.source * controlStride));
+				sum = dx::XMVectorMultiplyAdd(p, dx::XMVectorReplicate(term.weight), sum);
+			}
+			dx::XMStoreFloat3(reinterpret_cast<dx::XMFLOAT3*>(pTarget + r * refinedStride), sum);
+		}
+	});
+}
+
+template SubdivisionSurface::SubdivisionSurface(std::span<const unsigned short>, size_t, SubdivisionScheme, int);
+template SubdivisionSurface::SubdivisionSurface(std::span<const unsigned int>, size_t, SubdivisionScheme, int);
\ No newline at end of file
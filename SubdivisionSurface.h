@@ -0,0 +1,95 @@
+#pragma once
+#include "IndexedTriangleList.h"
+#include <DirectXMath.h>
+#include <span>
+#include <vector>
+#include <cstdint>
+
+enum class SubdivisionScheme
+{
+	// triangles split in four, vertices smoothed with Loop's weights
+	Loop,
+	// faces split into quads around a face point. consecutive triangles sharing an edge are
+	// taken as one quad (the layout Plane and every Catmull-Clark level emit), any other
+	// triangle as a triangular face; each refined quad is emitted as two consecutive triangles
+	CatmullClark
+};
+
+// subdivision surface over a control cage: the refined topology and, for every refined vertex,
+// a stencil of weights over the control vertices, built once from the cage's indices with
+// every level folded into a single table. refining new cage positions (an animated cage, every
+// frame) is then one sparse matrix-vector product split across workers, with no topology work
+// boundary edges follow the cubic b-spline curve rule and non-manifold edges are treated as
+// boundaries; boundary vertices in a single face and non-manifold vertices stay where they are
+// index-level work is instantiated for 16-bit and 32-bit indices in SubdivisionSurface.cpp
+class SubdivisionSurface
+{
+public:
+	// each level has four times the faces of the one before
+	static constexpr int maxLevels = 8;
+public:
+	template<class I>
+	SubdivisionSurface(std::span<const I> indices, size_t nVertices, SubdivisionScheme scheme, int levels);
+	template<class V, class I>
+	SubdivisionSurface(const IndexedTriangleList<V, I>& cage, SubdivisionScheme scheme, int levels)
+		:
+		SubdivisionSurface(std::span<const I>(cage.indices), cage.GetVertexCount(), scheme, levels)
+	{
+	}
+	size_t GetControlVertexCount() const noexcept
+	{
+		return nControlVertices;
+	}
+	size_t GetVertexCount() const noexcept
+	{
+		return rowOffsets.size() - 1u;
+	}
+	size_t GetTermCount() const noexcept
+	{
+		return terms.size();
+	}
+	// refined triangles, indexing the refined vertices
+	const std::vector<uint32_t>& GetIndices() const noexcept
+	{
+		return indices;
+	}
+	// GetVertexCount() refined positions from GetControlVertexCount() control positions
+	void Refine(const DirectX::XMFLOAT3* pControl, size_t controlStride, DirectX::XMFLOAT3* pRefined, size_t refinedStride) const;
+	// the refined mesh of cage; vertices only get positions, other attributes are value-initialized
+	template<class V, class I>
+	IndexedTriangleList<V, I> Make(const IndexedTriangleList<V, I>& cage) const
+	{
+		IndexedTriangleList<V, I>::CheckIndexRange(GetVertexCount());
+		IndexedTriangleList<V, I> list(cage.GetResource());
+		list.GetVertices().resize(GetVertexCount());
+		list.indices.assign(indices.begin(), indices.end());
+		Refine(cage, list);
+		return list;
+	}
+	// new positions of a (deformed) cage into a mesh Make built from it, other attributes are left alone
+	template<class V, class I>
+	void Refine(const IndexedTriangleList<V, I>& cage, IndexedTriangleList<V, I>& refined) const
+	{
+		assert("apply or take the pending transform first" && !cage.HasPendingTransform() && !refined.HasPendingTransform());
+		const auto& control = cage.GetVertices();
+		auto& vertices = refined.GetVertices();
+		assert("cage doesn't match the control vertices" && control.size() == nControlVertices);
+		assert("refined mesh doesn't match the stencils" && vertices.size() == GetVertexCount());
+		if (!vertices.empty())
+		{
+			Refine(&control.front().pos, sizeof(V), &vertices.front().pos, sizeof(V));
+		}
+	}
+private:
+	struct Term
+	{
+		uint32_t source;
+		float weight;
+	};
+	// refined vertex r is the sum of weight * control vertex source over
+	// terms[rowOffsets[r]] .. terms[rowOffsets[r + 1] - 1]
+	std::vector<uint32_t> rowOffsets;
+	std::vector<Term> terms;
+	std::vector<uint32_t> indices;
+	size_t nControlVertices;
+};
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "MeshImporterTest.h"
+#include "GeometryBenchmark.h"
+#include "FrameAllocatorTest.h"
+#include "MeshOptimizerTest.h"
+#include "MeshCleanerTest.h"
+#include "MeshletBuilderTest.h"
+#include <exception>
+#include <iterator>
+#include <cstdio>
+#include <cstring>
+
+// entry point of hw3dtest: runs every cpu-side check, prints one line per check and
+// exits non-zero when any of them failed (the post-build step turns that into a build error)
+// hw3dtest -benchmark runs the generator benchmarks instead; only release numbers mean anything
+namespace
+{
+	struct Check
+	{
+		const char* name;
+		bool (*run)();
+	};
+
+	constexpr Check checks[] = {
+		{ "MeshImporter obj homogeneous vertex",&MeshImporterTest::ObjHomogeneousVertex },
+		{ "MeshImporter obj vertex colors",&MeshImporterTest::ObjVertexColors },
+		{ "MeshImporter obj bad vertex arity",&MeshImporterTest::ObjBadVertexArity },
+		{ "FrameAllocator scratch outlives the next frame",&FrameAllocatorTest::ScratchOutlivesNextFrame },
+		{ "FrameAllocator steady state reserves nothing",&FrameAllocatorTest::SteadyStateReservesNothing },
+		{ "MeshOptimizer vertex cache on a plane",&MeshOptimizerTest::VertexCacheOnPlane },
+		{ "MeshOptimizer vertex cache on a shuffled plane",&MeshOptimizerTest::VertexCacheOnShuffledPlane },
+		{ "MeshOptimizer overdraw on nested spheres",&MeshOptimizerTest::OverdrawOnNestedSpheres },
+		{ "MeshOptimizer vertex fetch on shuffled vertices",&MeshOptimizerTest::VertexFetchOnShuffledVertices },
+		{ "MeshCleaner weld of a split icosphere",&MeshCleanerTest::WeldSplitIcosphere },
+		{ "MeshCleaner epsilon weld matches brute force",&MeshCleanerTest::EpsilonWeldMatchesBruteForce },
+		{ "MeshletBuilder build respects limits",&MeshletBuilderTest::BuildRespectsLimits },
+		{ "MeshletBuilder cull keeps visible triangles",&MeshletBuilderTest::CullKeepsVisibleTriangles },
+		{ "MeshletBuilder cull rejects off-screen meshlets",&MeshletBuilderTest::CullRejectsOffScreen },
+	};
+
+	bool Run(const Check& check)
+	{
+		try
+		{
+			return check.run();
+		}
+		catch (const std::exception& e)
+		{
+			std::printf("%s\n", e.what());
+		}
+		catch (...)
+		{
+			std::printf("unknown exception\n");
+		}
+		return false;
+	}
+
+	struct Benchmark
+	{
+		const char* name;
+		float (*run)();
+	};
+
+	constexpr Benchmark benchmarks[] = {
+		{ "Sphere 1000x2000",[]() { return GeometryBenchmark::Sphere(1000,2000); } },
+		{ "Cone 2^20",[]() { return GeometryBenchmark::Cone(1 << 20); } },
+		{ "Prism 2^20",[]() { return GeometryBenchmark::Prism(1 << 20); } },
+	};
+
+	int RunBenchmarks()
+	{
+		size_t nSlow = 0u;
+		for (const auto& benchmark : benchmarks)
+		{
+			const float verticesPerSecond = benchmark.run();
+			const bool fast = verticesPerSecond >= GeometryBenchmark::minVerticesPerSecond;
+			std::printf("%s %-18s %7.1fM vertices/s\n", fast ? "ok    " : "SLOW  ", benchmark.name, verticesPerSecond * 1e-6f);
+			nSlow += fast ? 0u : 1u;
+		}
+		std::printf("%zu of %zu generators below %.0fM vertices/s\n", nSlow, std::size(benchmarks),
+			GeometryBenchmark::minVerticesPerSecond * 1e-6f);
+		return nSlow == 0u ? 0 : 1;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "-benchmark") == 0)
+	{
+		return RunBenchmarks();
+	}
+	size_t nFailed = 0u;
+	for (const auto& check : checks)
+	{
+		const bool passed = Run(check);
+		std::printf("%s %s\n", passed ? "ok    " : "FAILED", check.name);
+		nFailed += passed ? 0u : 1u;
+	}
+	std::printf("%zu of %zu checks failed\n", nFailed, std::size(checks));
+	return nFailed == 0u ? 0 : 1;
+}
\ No newline at end of file
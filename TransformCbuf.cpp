@@ -4,10 +4,11 @@ TransformCbuf::TransformCbuf(Graphics& gfx, const Drawable& parent)
 	:
 	parent(parent)
 {
-	if (!pVcbuf)
+	// drawables may be constructed on several threads at once
+	std::call_once(vcbufInitFlag, [&gfx]
 	{
 		pVcbuf = std::make_unique<VertexConstantBuffer<DirectX::XMMATRIX>>(gfx);
-	}
+	});
 }
 
 void TransformCbuf::Bind(Graphics& gfx) noexcept
@@ -20,4 +21,5 @@ void TransformCbuf::Bind(Graphics& gfx) noexcept
 	pVcbuf->Bind(gfx);
 }
 
-std::unique_ptr<VertexConstantBuffer<DirectX::XMMATRIX>> TransformCbuf::pVcbuf;
\ No newline at end of file
+std::unique_ptr<VertexConstantBuffer<DirectX::XMMATRIX>> TransformCbuf::pVcbuf;
+std::once_flag TransformCbuf::vcbufInitFlag;
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "ConstantBuffers.h"
 #include "Drawable.h"
 #include <DirectXMath.h>
+#include <mutex>
 
 class TransformCbuf : public Bindable
 {
@@ -10,5 +11,6 @@ public:
 	void Bind(Graphics& gfx) noexcept override;
 private:
 	static std::unique_ptr<VertexConstantBuffer<DirectX::XMMATRIX>> pVcbuf;
+	static std::once_flag vcbufInitFlag;
 	const Drawable& parent;
 };
\ No newline at end of file
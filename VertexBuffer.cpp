@@ -1,4 +1,29 @@
 #include "VertexBuffer.h"
+#include "VertexQuantizer.h"
+
+VertexBuffer::VertexBuffer(Graphics& gfx, std::span<const std::byte> vertexData, UINT stride)
+	:
+	stride(stride)
+{
+	INFOMAN(gfx);
+
+	D3D11_BUFFER_DESC bd = {};
+	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bd.Usage = D3D11_USAGE_DEFAULT;
+	bd.CPUAccessFlags = 0u;
+	bd.MiscFlags = 0u;
+	bd.ByteWidth = UINT(vertexData.size());
+	bd.StructureByteStride = stride;
+	D3D11_SUBRESOURCE_DATA sd = {};
+	sd.pSysMem = vertexData.data();
+	GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&bd, &sd, &pVertexBuffer));
+}
+
+VertexBuffer::VertexBuffer(Graphics& gfx, const QuantizedVertices& vertices)
+	:
+	VertexBuffer(gfx, vertices.data, vertices.format.GetStride())
+{
+}
 
 void VertexBuffer::Bind(Graphics& gfx) noexcept
 {
@@ -1,12 +1,15 @@
 #pragma once
 #include "Bindable.h"
 #include "GraphicsThrowMacros.h"
+#include "IndexedTriangleList.h"
+#include <span>
+#include <cstddef>
 
 class VertexBuffer : public Bindable
 {
 public:
-	template<class V>
-	VertexBuffer(Graphics& gfx, const std::vector<V>& vertices)
+	template<class V, class Alloc>
+	VertexBuffer(Graphics& gfx, const std::vector<V, Alloc>& vertices)
 		:
 		stride(sizeof(V))
 	{
@@ -23,6 +26,17 @@ public:
 		sd.pSysMem = vertices.data();
 		GFX_THROW_INFO(GetDevice(gfx)->CreateBuffer(&bd, &sd, &pVertexBuffer));
 	}
+	// uploads the mesh's vertices with any pending transform applied first
+	template<class V, class I>
+	VertexBuffer(Graphics& gfx, IndexedTriangleList<V, I>& mesh)
+		:
+		VertexBuffer(gfx, mesh.GetVertices())
+	{
+	}
+	// raw interleaved vertex data, e.g. straight from a mapped MeshFile
+	VertexBuffer(Graphics& gfx, std::span<const std::byte> vertexData, UINT stride);
+	// interleaved vertices produced by VertexQuantizer, stride comes from their format
+	VertexBuffer(Graphics& gfx, const struct QuantizedVertices& vertices);
 	void Bind(Graphics& gfx) noexcept override;
 protected:
 	UINT stride;
@@ -0,0 +1,245 @@
+#include "VertexQuantizer.h"
+#include "MeshBounds.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+#include <cstring>
+
+namespace dx = DirectX;
+namespace dxpv = DirectX::PackedVector;
+
+namespace
+{
+	UINT PositionSize(PositionFormat f) noexcept
+	{
+		return f == PositionFormat::Float32 ? UINT(sizeof(dx::XMFLOAT3)) : UINT(sizeof(dxpv::XMSHORTN4));
+	}
+	UINT NormalSize(NormalFormat f) noexcept
+	{
+		switch (f)
+		{
+		case NormalFormat::Float32:
+			return UINT(sizeof(dx::XMFLOAT3));
+		case NormalFormat::Oct16:
+			return UINT(sizeof(dxpv::XMSHORTN2));
+		default:
+			return 0u;
+		}
+	}
+	UINT ColorSize(ColorFormat f) noexcept
+	{
+		switch (f)
+		{
+		case ColorFormat::Float32:
+			return UINT(sizeof(dx::XMFLOAT4));
+		case ColorFormat::Unorm8:
+			return UINT(sizeof(dxpv::XMUBYTEN4));
+		default:
+			return 0u;
+		}
+	}
+	template<class T>
+	const T& Fetch(const T* pBase, size_t stride, size_t i) noexcept
+	{
+		return *reinterpret_cast<const T*>(reinterpret_cast<const char*>(pBase) + i * stride);
+	}
+}
+
+UINT VertexFormat::GetStride() const noexcept
+{
+	return PositionSize(position) + NormalSize(normal) + ColorSize(color);
+}
+
+std::vector<D3D11_INPUT_ELEMENT_DESC> VertexFormat::GetInputLayout() const
+{
+	std::vector<D3D11_INPUT_ELEMENT_DESC> ied;
+	ied.reserve(3u);
+	UINT offset = 0u;
+	const auto add = [&ied, &offset](const char* semantic, DXGI_FORMAT format, UINT size)
+	{
+		ied.push_back({ semantic,0,format,0,offset,D3D11_INPUT_PER_VERTEX_DATA,0 });
+		offset += size;
+	};
+	switch (position)
+	{
+	case PositionFormat::Float32:
+		add("Position", DXGI_FORMAT_R32G32B32_FLOAT, PositionSize(position));
+		break;
+	case PositionFormat::Snorm16:
+		add("Position", DXGI_FORMAT_R16G16B16A16_SNORM, PositionSize(position));
+		break;
+	case PositionFormat::Half:
+		add("Position", DXGI_FORMAT_R16G16B16A16_FLOAT, PositionSize(position));
+		break;
+	}
+	switch (normal)
+	{
+	case NormalFormat::Float32:
+		add("Normal", DXGI_FORMAT_R32G32B32_FLOAT, NormalSize(normal));
+		break;
+	case NormalFormat::Oct16:
+		add("Normal", DXGI_FORMAT_R16G16_SNORM, NormalSize(normal));
+		break;
+	default:
+		break;
+	}
+	switch (color)
+	{
+	case ColorFormat::Float32:
+		add("Color", DXGI_FORMAT_R32G32B32A32_FLOAT, ColorSize(color));
+		break;
+	case ColorFormat::Unorm8:
+		add("Color", DXGI_FORMAT_R8G8B8A8_UNORM, ColorSize(color));
+		break;
+	default:
+		break;
+	}
+	return ied;
+}
+
+DirectX::XMMATRIX PositionDequantization::GetMatrix() const noexcept
+{
+	return dx::XMMatrixScaling(scale.x, scale.y, scale.z) *
+		dx::XMMatrixTranslation(offset.x, offset.y, offset.z);
+}
+
+DirectX::XMVECTOR VertexQuantizer::EncodeOctahedral(DirectX::FXMVECTOR n) noexcept
+{
+	// project onto the octahedron |x|+|y|+|z| = 1, then fold the lower half over the diagonals
+	const auto zero = dx::XMVectorZero();
+	const auto one = dx::XMVectorReplicate(1.0f);
+	const auto p = dx::XMVectorDivide(n, dx::XMVector3Dot(dx::XMVectorAbs(n), one));
+	const auto signs = dx::XMVectorSelect(dx::XMVectorNegate(one), one, dx::XMVectorGreaterOrEqual(p, zero));
+	const auto folded = dx::XMVectorMultiply(
+		dx::XMVectorSubtract(one, dx::XMVectorAbs(dx::XMVectorSwizzle<1, 0, 2, 3>(p))),
+		signs
+	);
+	return dx::XMVectorSelect(p, folded, dx::XMVectorLess(dx::XMVectorSplatZ(p), zero));
+}
+
+DirectX::XMVECTOR VertexQuantizer::DecodeOctahedral(DirectX::FXMVECTOR e) noexcept
+{
+	// unfold the lower hemisphere, then renormalize
+	const auto zero = dx::XMVectorZero();
+	const auto absE = dx::XMVectorAbs(e);
+	const float z = 1.0f - dx::XMVectorGetX(absE) - dx::XMVectorGetY(absE);
+	const auto t = dx::XMVectorReplicate(std::max(-z, 0.0f));
+	const auto xy = dx::XMVectorAdd(e,
+		dx::XMVectorSelect(t, dx::XMVectorNegate(t), dx::XMVectorGreaterOrEqual(e, zero))
+	);
+	return dx::XMVector3Normalize(dx::XMVectorSetZ(xy, z));
+}
+
+QuantizedVertices VertexQuantizer::Quantize(const VertexFormat& format, const VertexStreams& streams, size_t nVertices,
+	std::pmr::memory_resource* pMem)
+{
+	assert("Quantize needs positions" && (nVertices == 0u || streams.pPositions != nullptr));
+	assert("format has normals but no normal stream" && (nVertices == 0u || format.normal == NormalFormat::None || streams.pNormals));
+	assert("format has colors but no color stream" && (nVertices == 0u || format.color == ColorFormat::None || streams.pColors));
+
+	QuantizedVertices out(pMem);
+	out.format = format;
+	out.nVertices = nVertices;
+	const size_t stride = format.GetStride();
+	out.data.resize(stride * nVertices);
+	if (nVertices == 0u)
+	{
+		return out;
+	}
+
+	out.bounds = MeshBounds::ComputeBox(streams.pPositions, streams.positionStride, nVertices);
+	// uniform scale keeps the dequantization matrix free of shear when normals go through it too
+	if (format.position != PositionFormat::Float32)
+	{
+		const auto lo = dx::XMLoadFloat3(&out.bounds.min);
+		const auto hi = dx::XMLoadFloat3(&out.bounds.max);
+		const auto halfExtent = dx::XMVectorScale(dx::XMVectorSubtract(hi, lo), 0.5f);
+		const float scale = std::max({ dx::XMVectorGetX(halfExtent),dx::XMVectorGetY(halfExtent),dx::XMVectorGetZ(halfExtent) });
+		out.dequantization.scale = { scale,scale,scale };
+		dx::XMStoreFloat3(&out.dequantization.offset, dx::XMVectorScale(dx::XMVectorAdd(lo, hi), 0.5f));
+	}
+	const auto offset = dx::XMLoadFloat3(&out.dequantization.offset);
+	const auto scale = dx::XMLoadFloat3(&out.dequantization.scale);
+	const auto invScale = dx::XMVectorReciprocal(dx::XMVectorSelect(
+		dx::XMVectorReplicate(1.0f), scale, dx::XMVectorGreater(scale, dx::XMVectorZero())
+	));
+
+	// encode one vertex at a time straight into the interleaved buffer, decoding it again
+	// right away to track the worst case error of every attribute
+	auto maxPosition = dx::XMVectorZero();
+	auto minNormalDot = dx::XMVectorReplicate(1.0f);
+	auto maxColor = dx::XMVectorZero();
+	std::byte* pOut = out.data.data();
+	for (size_t i = 0; i < nVertices; i++, pOut += stride)
+	{
+		std::byte* pAttr = pOut;
+		const auto p = dx::XMLoadFloat3(&Fetch(streams.pPositions, streams.positionStride, i));
+		dx::XMVECTOR decoded;
+		switch (format.position)
+		{
+		case PositionFormat::Float32:
+			std::memcpy(pAttr, &Fetch(streams.pPositions, streams.positionStride, i), sizeof(dx::XMFLOAT3));
+			decoded = p;
+			break;
+		case PositionFormat::Snorm16:
+		{
+			dxpv::XMSHORTN4 e;
+			dxpv::XMStoreShortN4(&e, dx::XMVectorMultiply(dx::XMVectorSubtract(p, offset), invScale));
+			std::memcpy(pAttr, &e, sizeof(e));
+			decoded = dx::XMVectorMultiplyAdd(dxpv::XMLoadShortN4(&e), scale, offset);
+			break;
+		}
+		case PositionFormat::Half:
+		{
+			dxpv::XMHALF4 e;
+			dxpv::XMStoreHalf4(&e, dx::XMVectorMultiply(dx::XMVectorSubtract(p, offset), invScale));
+			std::memcpy(pAttr, &e, sizeof(e));
+			decoded = dx::XMVectorMultiplyAdd(dxpv::XMLoadHalf4(&e), scale, offset);
+			break;
+		}
+		}
+		maxPosition = dx::XMVectorMax(maxPosition, dx::XMVector3Length(dx::XMVectorSubtract(decoded, p)));
+		pAttr += PositionSize(format.position);
+
+		if (format.normal != NormalFormat::None)
+		{
+			const auto n = dx::XMVector3Normalize(dx::XMLoadFloat3(&Fetch(streams.pNormals, streams.normalStride, i)));
+			if (format.normal == NormalFormat::Float32)
+			{
+				std::memcpy(pAttr, &Fetch(streams.pNormals, streams.normalStride, i), sizeof(dx::XMFLOAT3));
+			}
+			else
+			{
+				dxpv::XMSHORTN2 e;
+				dxpv::XMStoreShortN2(&e, EncodeOctahedral(n));
+				std::memcpy(pAttr, &e, sizeof(e));
+				minNormalDot = dx::XMVectorMin(minNormalDot,
+					dx::XMVector3Dot(n, DecodeOctahedral(dxpv::XMLoadShortN2(&e))));
+			}
+			pAttr += NormalSize(format.normal);
+		}
+
+		if (format.color != ColorFormat::None)
+		{
+			const auto& c = Fetch(streams.pColors, streams.colorStride, i);
+			if (format.color == ColorFormat::Float32)
+			{
+				std::memcpy(pAttr, &c, sizeof(c));
+			}
+			else
+			{
+				const auto color = dx::XMLoadFloat4(&c);
+				dxpv::XMUBYTEN4 e;
+				dxpv::XMStoreUByteN4(&e, color);
+				std::memcpy(pAttr, &e, sizeof(e));
+				maxColor = dx::XMVectorMax(maxColor,
+					dx::XMVectorAbs(dx::XMVectorSubtract(dxpv::XMLoadUByteN4(&e), dx::XMVectorSaturate(color))));
+			}
+		}
+	}
+	out.error.position = dx::XMVectorGetX(maxPosition);
+	out.error.normal = std::acos(std::clamp(dx::XMVectorGetX(minNormalDot), -1.0f, 1.0f));
+	out.error.color = std::max({ dx::XMVectorGetX(maxColor),dx::XMVectorGetY(maxColor),
+		dx::XMVectorGetZ(maxColor),dx::XMVectorGetW(maxColor) });
+	return out;
+}
\ No newline at end of file
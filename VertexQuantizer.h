@@ -0,0 +1,127 @@
+#pragma once
+#include "ChiliWin.h"
+#include "IndexedTriangleList.h"
+#include "MeshBounds.h"
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <DirectXPackedVector.h>
+#include <vector>
+#include <memory_resource>
+#include <cstddef>
+#include <concepts>
+
+// 16-bit positions are stored relative to the mesh bounds, so they only cost 8 bytes
+// (R16G16B16A16, the w lane is padding) and the dequantization folds into the world matrix
+enum class PositionFormat
+{
+	Float32,
+	Snorm16,
+	Half,
+};
+
+// octahedral normals map the unit sphere onto a square and store 2 components
+// (R16G16 keeps 4-byte element alignment; an 8-bit pair would be padded to the same size)
+enum class NormalFormat
+{
+	None,
+	Float32,
+	Oct16,
+};
+
+enum class ColorFormat
+{
+	None,
+	Float32,
+	Unorm8,
+};
+
+// interleaved vertex layout made of the attributes above, in that order
+struct VertexFormat
+{
+	PositionFormat position = PositionFormat::Float32;
+	NormalFormat normal = NormalFormat::None;
+	ColorFormat color = ColorFormat::None;
+	UINT GetStride() const noexcept;
+	// semantics Position / Normal / Color, matching the offsets written by VertexQuantizer
+	std::vector<D3D11_INPUT_ELEMENT_DESC> GetInputLayout() const;
+};
+
+// decoded position = encoded * scale + offset
+struct PositionDequantization
+{
+	DirectX::XMFLOAT3 scale = { 1.0f,1.0f,1.0f };
+	DirectX::XMFLOAT3 offset = { 0.0f,0.0f,0.0f };
+	// object-space transform for the vertex shader, premultiply onto the world matrix
+	DirectX::XMMATRIX GetMatrix() const noexcept;
+};
+
+// largest error found by decoding every encoded vertex again
+// position: distance in object units, normal: angle in radians, color: per channel
+struct QuantizationError
+{
+	float position;
+	float normal;
+	float color;
+};
+
+struct QuantizedVertices
+{
+	QuantizedVertices(std::pmr::memory_resource* pMem)
+		:
+		data(pMem)
+	{
+	}
+	VertexFormat format;
+	std::pmr::vector<std::byte> data;
+	size_t nVertices = 0u;
+	PositionDequantization dequantization;
+	// aabb of the source positions, the dequantization box is a cube around it
+	AxisAlignedBox bounds = {};
+	QuantizationError error = { 0.0f,0.0f,0.0f };
+};
+
+// strided source attribute streams; pNormals / pColors may be null when the format omits them
+struct VertexStreams
+{
+	const DirectX::XMFLOAT3* pPositions = nullptr;
+	size_t positionStride = sizeof(DirectX::XMFLOAT3);
+	const DirectX::XMFLOAT3* pNormals = nullptr;
+	size_t normalStride = sizeof(DirectX::XMFLOAT3);
+	const DirectX::XMFLOAT4* pColors = nullptr;
+	size_t colorStride = sizeof(DirectX::XMFLOAT4);
+};
+
+class VertexQuantizer
+{
+public:
+	static QuantizedVertices Quantize(const VertexFormat& format, const VertexStreams& streams, size_t nVertices,
+		std::pmr::memory_resource* pMem = std::pmr::get_default_resource());
+	// picks up V::n (XMFLOAT3 normal) and V::color (XMFLOAT4) when the format asks for them
+	template<class V, class I>
+	static QuantizedVertices Quantize(const VertexFormat& format, const IndexedTriangleList<V, I>& mesh)
+	{
+		assert("apply or take the pending transform first" && !mesh.HasPendingTransform());
+		const auto& vertices = mesh.GetVertices();
+		VertexStreams streams;
+		if (vertices.empty())
+		{
+			// no vertices means no streams either
+			return Quantize(format, streams, 0u, mesh.GetResource());
+		}
+		streams.pPositions = &vertices.front().pos;
+		streams.positionStride = sizeof(V);
+		if constexpr (requires(const V& v) { { v.n } -> std::convertible_to<const DirectX::XMFLOAT3&>; })
+		{
+			streams.pNormals = &vertices.front().n;
+			streams.normalStride = sizeof(V);
+		}
+		if constexpr (requires(const V& v) { { v.color } -> std::convertible_to<const DirectX::XMFLOAT4&>; })
+		{
+			streams.pColors = &vertices.front().color;
+			streams.colorStride = sizeof(V);
+		}
+		return Quantize(format, streams, vertices.size(), mesh.GetResource());
+	}
+	static DirectX::XMVECTOR EncodeOctahedral(DirectX::FXMVECTOR n) noexcept;
+	static DirectX::XMVECTOR DecodeOctahedral(DirectX::FXMVECTOR e) noexcept;
+};
\ No newline at end of file